@@ -150,6 +150,7 @@ testScripts = [
     'getchaintips.py',
     'rest.py',
     'httpbasics.py',
+    'rpc_batch.py',
     'reindex.py',
     'p2p-addr.py',
     'multi_rpc.py',
@@ -207,6 +208,7 @@ testScripts = [
     'llmq-is-cl-conflicts.py',
     'llmq-is-retroactive.py',
     'llmq-is-lelantus.py',
+    'llmq-quorums-cache.py',
 
     # Unstable tests
     #, 'dip4-coinbasemerkleroots.py'
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 The Firo Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+from test_framework.mininode import *
+from test_framework.test_framework import EvoZnodeTestFramework
+from test_framework.util import *
+from time import *
+
+'''
+llmq-quorums-cache.py
+
+Checks that old quorums are dropped from the quorums cache together with their public key shares
+
+'''
+
+class LLMQQuorumsCacheTest(EvoZnodeTestFramework):
+    def __init__(self):
+        super().__init__(6, 5)
+
+    def get_quorum_info(self, quorumHash):
+        # the masternodes are the members of the quorums, only they have the shares
+        return self.mninfo[0].node.quorum("info", 100, quorumHash)
+
+    def run_test(self):
+
+        quorumHash = self.mine_quorum()
+
+        # the shares of the quorum are taken from the cache once built
+        info = self.get_quorum_info(quorumHash)
+        validMembers = len([m for m in info["members"] if m["valid"]])
+        assert(validMembers > 0)
+        info = self.get_quorum_info(quorumHash)
+        assert_equal(info["pubKeyShareCache"]["size"], validMembers)
+        assert(info["pubKeyShareCache"]["hits"] >= validMembers)
+
+        # the quorum is dropped from the cache once enough new quorums are used after it
+        for i in range(8):
+            self.mine_quorum()
+
+        # and is built again from scratch, with its public key shares
+        info = self.get_quorum_info(quorumHash)
+        assert_equal(info["quorumHash"], quorumHash)
+        assert_equal(info["pubKeyShareCache"]["hits"], 0)
+        assert_equal(info["pubKeyShareCache"]["misses"], validMembers)
+        assert_equal(info["pubKeyShareCache"]["size"], validMembers)
+
+if __name__ == '__main__':
+    LLMQQuorumsCacheTest().main()
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 The Firo Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#
+# Test the JSON-RPC batches, their replies are streamed in chunks
+#
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+
+import http.client
+import json
+import urllib.parse
+
+class RPCBatchTest (BitcoinTestFramework):
+    def __init__(self):
+        super().__init__()
+        self.num_nodes = 1
+        self.setup_clean_chain = False
+
+    def setup_network(self):
+        self.nodes = self.setup_nodes()
+
+    def post(self, conn, body):
+        conn.request('POST', '/', body, self.headers)
+        response = conn.getresponse()
+        assert_equal(response.status, http.client.OK)
+        assert_equal(response.getheader('Transfer-Encoding'), 'chunked')
+        assert_equal(response.getheader('Content-Type'), 'application/json')
+        return json.loads(response.read().decode('utf-8'))
+
+    def run_test(self):
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        authpair = url.username + ':' + url.password
+        self.headers = {"Authorization": "Basic " + str_to_b64str(authpair)}
+
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.connect()
+
+        # the replies come in the order of the requests, the failed ones as error objects
+        bestblockhash = self.nodes[0].getbestblockhash()
+        batch = [
+            {"method": "getbestblockhash", "id": 1},
+            {"method": "getblock", "params": [bestblockhash], "id": 2},
+            {"method": "nosuchmethod", "id": 3},
+            {"method": "getblockhash", "params": [-1], "id": 4},
+            {"method": "getblockcount", "id": 5},
+        ]
+        replies = self.post(conn, json.dumps(batch))
+        assert_equal(len(replies), len(batch))
+        assert_equal([reply['id'] for reply in replies], [1, 2, 3, 4, 5])
+        assert_equal(replies[0]['result'], bestblockhash)
+        assert_equal(replies[0]['error'], None)
+        assert_equal(replies[1]['result']['hash'], bestblockhash)
+        assert_equal(replies[2]['result'], None)
+        assert_equal(replies[2]['error']['code'], -32601)
+        assert_equal(replies[3]['result'], None)
+        assert_equal(replies[3]['error']['code'], -8)
+        assert_equal(replies[4]['result'], self.nodes[0].getblockcount())
+
+        # a batch of many large replies is put together correctly from the chunks
+        batch = [{"method": "getblock", "params": [self.nodes[0].getblockhash(height)], "id": height}
+                 for height in range(self.nodes[0].getblockcount() + 1)]
+        replies = self.post(conn, json.dumps(batch))
+        assert_equal(len(replies), len(batch))
+        for reply in replies:
+            assert_equal(reply['error'], None)
+            assert_equal(reply['result']['height'], reply['id'])
+
+        # an empty batch, the connection is still usable after the chunked replies
+        assert_equal(self.post(conn, '[]'), [])
+        assert(conn.sock != None)
+
+        # single requests are not chunked
+        conn.request('POST', '/', '{"method": "getbestblockhash", "id": 1}', self.headers)
+        response = conn.getresponse()
+        assert_equal(response.status, http.client.OK)
+        assert_equal(response.getheader('Transfer-Encoding'), None)
+        assert_equal(json.loads(response.read().decode('utf-8'))['result'], bestblockhash)
+        conn.close()
+
+
+if __name__ == '__main__':
+    RPCBatchTest ().main ()
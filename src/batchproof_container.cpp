@@ -7,6 +7,63 @@
 #include "lelantus.h"
 #include "ui_interface.h"
 
+#include <deque>
+#include <future>
+
+namespace {
+
+// Verification tasks of the groups posted to the thread pool. Every task keeps its anonymity set in memory, so only a
+// couple of tasks per thread are queued at once
+class BatchVerifyTasks {
+public:
+    BatchVerifyTasks()
+        : threadPool(ParallelOpThreadPool::GetInstance()), group(threadPool.NewTaskGroup()),
+          maxQueued(2 * threadPool.GetNumberOfThreads()), fValid(true) {}
+
+    void Post(const char* name, std::function<bool()> task) {
+        while (tasks.size() >= maxQueued)
+            TakeResult();
+        tasks.emplace_back(threadPool.PostTask<bool>(name, std::move(task), group));
+    }
+
+    // Waits for all the tasks, returns whether all of them succeeded
+    bool Finish() {
+        while (!tasks.empty())
+            TakeResult();
+        return fValid;
+    }
+
+private:
+    void TakeResult() {
+        threadPool.Wait(tasks.front(), group);
+        if (!tasks.front().get())
+            fValid = false;
+        tasks.pop_front();
+    }
+
+private:
+    ParallelOpThreadPool& threadPool;
+    // the validating thread only helps with its own tasks
+    ParallelOpThreadPool::TaskGroup group;
+    std::size_t maxQueued;
+    std::deque<std::future<bool>> tasks;
+    bool fValid;
+};
+
+void LogThreadPoolStats() {
+    if (!LogAcceptCategory("bench"))
+        return;
+
+    for (const auto& taskStats : ParallelOpThreadPool::GetInstance().GetStats()) {
+        const ParallelOpThreadPool::TaskStats& stats = taskStats.second;
+        LogPrint("bench", "        - %s: %u tasks, queued %.2fms [max %.2fms], run %.2fms [max %.2fms]\n",
+            taskStats.first, stats.nTasks, stats.nQueueMicros * 0.001, stats.nMaxQueueMicros * 0.001,
+            stats.nRunMicros * 0.001, stats.nMaxRunMicros * 0.001);
+    }
+}
+
+}
+
 std::unique_ptr<BatchProofContainer> BatchProofContainer::instance;
 
 BatchProofContainer* BatchProofContainer::get_instance() {
@@ -158,6 +215,26 @@ void BatchProofContainer::erase(std::vector<LelantusSigmaProofData>* vProofs, co
 
 }
 
+bool BatchProofContainer::verifyBlock() {
+    // range proofs go to a task of their own, the sigma and lelantus groups are spread over the thread pool
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+    ParallelOpThreadPool::TaskGroup group = threadPool.NewTaskGroup();
+    std::future<bool> rangeProofsTask;
+    if (!tempRangeProofs.empty())
+        rangeProofsTask = threadPool.PostTask<bool>("range_batch_verify", [this]() { return verify_rangeProofs(tempRangeProofs); }, group);
+
+    bool fValid = verify_sigma(tempSigmaProofs) && verify_lelantus(tempLelantusSigmaProofs);
+    if (rangeProofsTask.valid()) {
+        threadPool.Wait(rangeProofsTask, group);
+        if (!rangeProofsTask.get())
+            fValid = false;
+    }
+    LogThreadPoolStats();
+
+    init();
+    return fValid;
+}
+
 void BatchProofContainer::batch_sigma() {
     if (!sigmaProofs.empty()){
         LogPrintf("Sigma batch verification started.\n");
@@ -166,73 +243,64 @@ void BatchProofContainer::batch_sigma() {
     else
         return;
 
-    DoNotDisturb dnd;
-    std::size_t threadsMaxCount = std::min((unsigned int)sigmaProofs.size(), boost::thread::hardware_concurrency());
-    std::vector<boost::future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
+    if (!verify_sigma(sigmaProofs)) {
+        LogPrintf("Sigma batch verification failed.");
+        throw std::invalid_argument(
+                "Sigma batch verification failed, please run Firo with -reindex -batching=0");
+    }
 
-    auto params = sigma::Params::get_default();
-    sigma::SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m());
-
-    auto itr = sigmaProofs.begin();
-    for (std::size_t j = 0; j < sigmaProofs.size(); j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < sigmaProofs.size()) {
-                std::vector<GroupElement> anonymity_set;
-                sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-                sigmaState->GetAnonymitySet(
-                        itr->first.first,
-                        itr->first.second.first,
-                        itr->first.second.second,
-                        anonymity_set);
-
-                size_t m = itr->second.size();
-                std::vector<Scalar> serials;
-                serials.reserve(m);
-                std::vector<bool> fPadding;
-                fPadding.reserve(m);
-                std::vector<size_t> setSizes;
-                setSizes.reserve(m);
-                std::vector<sigma::SigmaPlusProof<Scalar, GroupElement>> proofs;
-                proofs.reserve(m);
-
-                for (auto& proofData : itr->second) {
-                    serials.emplace_back(proofData.coinSerialNumber);
-                    fPadding.emplace_back(proofData.fPadding);
-                    setSizes.emplace_back(proofData.anonymitySetSize);
-                    proofs.emplace_back(proofData.sigmaProof);
-                }
+    LogPrintf("Sigma batch verification finished successfully.\n");
+    sigmaProofs.clear();
+}
 
-                parallelTasks.emplace_back(threadPool.PostTask([=]() {
-                    try {
-                        if (!sigmaVerifier.batch_verify(anonymity_set, serials, fPadding, setSizes, proofs))
-                            return false;
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
+bool BatchProofContainer::verify_sigma(const SigmaProofContainer& sigmaProofs) {
+    if (sigmaProofs.empty())
+        return true;
 
-                ++itr;
-            }
-        }
+    DoNotDisturb dnd;
+    BatchVerifyTasks parallelTasks;
 
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
-        if (isFail) {
-            LogPrintf("Sigma batch verification failed.");
-            throw std::invalid_argument(
-                    "Sigma batch verification failed, please run Firo with -reindex -batching=0");
+    auto params = sigma::Params::get_default();
+    sigma::SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m(), params->get_generators_table());
+
+    for (auto itr = sigmaProofs.begin(); itr != sigmaProofs.end(); ++itr) {
+        std::vector<GroupElement> anonymity_set;
+        sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+        sigmaState->GetAnonymitySet(
+                itr->first.first,
+                itr->first.second.first,
+                itr->first.second.second,
+                anonymity_set);
+
+        size_t m = itr->second.size();
+        std::vector<Scalar> serials;
+        serials.reserve(m);
+        std::vector<bool> fPadding;
+        fPadding.reserve(m);
+        std::vector<size_t> setSizes;
+        setSizes.reserve(m);
+        std::vector<sigma::SigmaPlusProof<Scalar, GroupElement>> proofs;
+        proofs.reserve(m);
+
+        for (auto& proofData : itr->second) {
+            serials.emplace_back(proofData.coinSerialNumber);
+            fPadding.emplace_back(proofData.fPadding);
+            setSizes.emplace_back(proofData.anonymitySetSize);
+            proofs.emplace_back(proofData.sigmaProof);
         }
-        parallelTasks.clear();
+
+        parallelTasks.Post("sigma_batch_verify", [=]() {
+            try {
+                if (!sigmaVerifier.batch_verify(anonymity_set, serials, fPadding, setSizes, proofs))
+                    return false;
+            } catch (...) {
+                return false;
+            }
+            return true;
+        });
     }
-    if (!sigmaProofs.empty())
-        LogPrintf("Sigma batch verification finished successfully.\n");
-    sigmaProofs.clear();
+
+    return parallelTasks.Finish();
 }
 
 void BatchProofContainer::batch_lelantus() {
@@ -243,99 +311,88 @@ void BatchProofContainer::batch_lelantus() {
     else
         return;
 
-    auto params = lelantus::Params::get_default();
-
-    DoNotDisturb dnd;
-    std::size_t threadsMaxCount = std::min((unsigned int)lelantusSigmaProofs.size(), boost::thread::hardware_concurrency());
-    std::vector<boost::future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
-    auto itr = lelantusSigmaProofs.begin();
+    if (!verify_lelantus(lelantusSigmaProofs)) {
+        LogPrintf("Lelantus batch verification failed.");
+        throw std::invalid_argument("Lelantus batch verification failed, please run Firo with -reindex -batching=0");
+    }
 
-    lelantus::SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
-                                                  params->get_sigma_m());
-    for (std::size_t j = 0; j < lelantusSigmaProofs.size(); j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < lelantusSigmaProofs.size()) {
-                std::vector<GroupElement> anonymity_set;
-                if (!itr->first.second) {
-                    lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
-                    std::vector<lelantus::PublicCoin> coins;
-                    state->GetAnonymitySet(
-                            itr->first.first.first,
-                            itr->first.first.second,
-                            coins);
-                    anonymity_set.reserve(coins.size());
-                    for (auto& coin : coins)
-                        anonymity_set.emplace_back(coin.getValue());
-                } else {
-                    int coinGroupId = itr->first.first.first % (CENT / 1000);
-                    int64_t intDenom = (itr->first.first.first - coinGroupId);
-                    intDenom *= 1000;
-                    sigma::CoinDenomination denomination;
-                    sigma::IntegerToDenomination(intDenom, denomination);
-
-                    std::vector<GroupElement> coins;
-                    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-                    sigmaState->GetAnonymitySet(
-                            denomination,
-                            coinGroupId,
-                            true,
-                            coins);
-
-                    anonymity_set.reserve(coins.size());
-                    for (auto& coin : coins)
-                        anonymity_set.emplace_back(coin + params->get_h1() * intDenom);
-                }
+    LogPrintf("Lelantus batch verification finished successfully.\n");
+    lelantusSigmaProofs.clear();
+}
 
-                size_t m = itr->second.size();
-                std::vector<Scalar> serials;
-                serials.reserve(m);
-                std::vector<size_t> setSizes;
-                setSizes.reserve(m);
-                std::vector<lelantus::SigmaExtendedProof> proofs;
-                proofs.reserve(m);
-                std::vector<Scalar> challenges;
-                challenges.reserve(m);
-
-                for (auto& proofData : itr->second) {
-                    serials.emplace_back(proofData.serialNumber);
-                    setSizes.emplace_back(proofData.anonymitySetSize);
-                    proofs.emplace_back(proofData.lelantusSigmaProof);
-                    challenges.emplace_back(proofData.challenge);
-                }
+bool BatchProofContainer::verify_lelantus(const LelantusSigmaProofContainer& lelantusSigmaProofs) {
+    if (lelantusSigmaProofs.empty())
+        return true;
 
+    auto params = lelantus::Params::get_default();
 
+    DoNotDisturb dnd;
+    BatchVerifyTasks parallelTasks;
 
-                parallelTasks.emplace_back(threadPool.PostTask([=]() {
-                    try {
-                        if (!sigmaVerifier.batchverify(anonymity_set, challenges, serials, setSizes, proofs))
-                            return false;
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
-                
-                ++itr;
-            }
-        }
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
+    lelantus::SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
+                                                  params->get_sigma_m(), params->get_sigma_table());
+    // When there are fewer groups than threads the spare ones help with each group's multiexponentiation
+    std::size_t nThreads = ParallelOpThreadPool::GetInstance().GetNumberOfThreads();
+    sigmaVerifier.set_multiexp_threads(std::max<std::size_t>(1, nThreads / std::min(lelantusSigmaProofs.size(), nThreads)));
+    for (auto itr = lelantusSigmaProofs.begin(); itr != lelantusSigmaProofs.end(); ++itr) {
+        std::vector<GroupElement> anonymity_set;
+        if (!itr->first.second) {
+            lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
+            lelantus::CLelantusState::AnonymitySetRef coins = state->GetAnonymitySet(
+                    itr->first.first.first,
+                    itr->first.first.second);
+            anonymity_set.reserve(coins->size());
+            for (auto& coin : *coins)
+                anonymity_set.emplace_back(coin.getValue());
+        } else {
+            int coinGroupId = itr->first.first.first % (CENT / 1000);
+            int64_t intDenom = (itr->first.first.first - coinGroupId);
+            intDenom *= 1000;
+            sigma::CoinDenomination denomination;
+            sigma::IntegerToDenomination(intDenom, denomination);
+
+            std::vector<GroupElement> coins;
+            sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+            sigmaState->GetAnonymitySet(
+                    denomination,
+                    coinGroupId,
+                    true,
+                    coins);
+
+            anonymity_set.reserve(coins.size());
+            for (auto& coin : coins)
+                anonymity_set.emplace_back(coin + params->get_h1() * intDenom);
         }
 
-        if (isFail) {
-            LogPrintf("Lelantus batch verification failed.");
-            throw std::invalid_argument("Lelantus batch verification failed, please run Firo with -reindex -batching=0");
+        size_t m = itr->second.size();
+        std::vector<Scalar> serials;
+        serials.reserve(m);
+        std::vector<size_t> setSizes;
+        setSizes.reserve(m);
+        std::vector<lelantus::SigmaExtendedProof> proofs;
+        proofs.reserve(m);
+        std::vector<Scalar> challenges;
+        challenges.reserve(m);
+
+        for (auto& proofData : itr->second) {
+            serials.emplace_back(proofData.serialNumber);
+            setSizes.emplace_back(proofData.anonymitySetSize);
+            proofs.emplace_back(proofData.lelantusSigmaProof);
+            challenges.emplace_back(proofData.challenge);
         }
 
-        parallelTasks.clear();
+        parallelTasks.Post("lelantus_batch_verify", [=]() {
+            try {
+                if (!sigmaVerifier.batchverify(anonymity_set, challenges, serials, setSizes, proofs))
+                    return false;
+            } catch (...) {
+                return false;
+            }
+            return true;
+        });
     }
-    if (!lelantusSigmaProofs.empty())
-        LogPrintf("Lelantus batch verification finished successfully.\n");
-    lelantusSigmaProofs.clear();
+
+    return parallelTasks.Finish();
 }
 
 void BatchProofContainer::batch_rangeProofs() {
@@ -343,10 +400,23 @@ void BatchProofContainer::batch_rangeProofs() {
         LogPrintf("RangeProof batch verification started.\n");
         uiInterface.UpdateProgressBarLabel("Batch verifying Range Proofs...");
     }
+    else
+        return;
 
+    if (!verify_rangeProofs(rangeProofs)) {
+        LogPrintf("RangeProof batch verification failed.\n");
+        throw std::invalid_argument("RangeProof batch verification failed, please run Firo with -reindex -batching=0");
+    }
+
+    LogPrintf("RangeProof batch verification finished successfully.\n");
+    rangeProofs.clear();
+}
+
+bool BatchProofContainer::verify_rangeProofs(const RangeProofContainer& rangeProofs) {
     auto params = lelantus::Params::get_default();
     for (const auto& itr : rangeProofs) {
-        lelantus::RangeVerifier  rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), params->get_bulletproofs_g(), params->get_bulletproofs_h(), params->get_bulletproofs_n(), itr.first);
+        lelantus::RangeVerifier  rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), params->get_bulletproofs_g(), params->get_bulletproofs_h(), params->get_bulletproofs_n(), itr.first, params->get_bulletproofs_table());
+        rangeVerifier.set_multiexp_threads(ParallelOpThreadPool::GetInstance().GetNumberOfThreads());
         std::vector<std::vector<GroupElement>> V;
         std::vector<std::vector<GroupElement>> commitments;
         size_t proofSize = itr.second.size();
@@ -376,14 +446,13 @@ void BatchProofContainer::batch_rangeProofs() {
                 V[i].push_back(GroupElement());
         }
 
-        if (!rangeVerifier.verify(V, commitments, proofs)) {
-            LogPrintf("RangeProof batch verification failed.\n");
-            throw std::invalid_argument("RangeProof batch verification failed, please run Firo with -reindex -batching=0");
+        try {
+            if (!rangeVerifier.verify(V, commitments, proofs))
+                return false;
+        } catch (...) {
+            return false;
         }
     }
 
-    if (!rangeProofs.empty())
-        LogPrintf("RangeProof batch verification finished successfully.\n");
-
-    rangeProofs.clear();
+    return true;
 }
@@ -45,12 +45,23 @@ public:
         size_t anonymitySetSize;
     };
 
+    // map (denom, (id, fStartSigmaBlacklist)) to (sigma proof, serial, set size)
+    typedef std::map<std::pair<sigma::CoinDenomination, std::pair<int, bool>>, std::vector<SigmaProofData>> SigmaProofContainer;
+    // map ((id, afterFixes), fIsSigmaToLelantus) to (sigma proof, serial, set size, challenge)
+    typedef std::map<std::pair<std::pair<uint32_t, bool>, bool>, std::vector<LelantusSigmaProofData>> LelantusSigmaProofContainer;
+    // map (version to (Range proof, Pubcoins))
+    typedef std::map<unsigned int, std::vector<std::pair<lelantus::RangeProof, std::vector<lelantus::PublicCoin>>>> RangeProofContainer;
+
     void init();
 
     void finalize();
 
     void verify();
 
+    // Batch verifies the proofs collected for the block being connected and forgets them, used when the proofs of
+    // the block have to be checked right away. Returns false if some proof is invalid
+    bool verifyBlock();
+
     void add(sigma::CoinSpend* spend,
              bool fPadding,
              int group_id,
@@ -73,23 +84,25 @@ public:
     void batch_lelantus();
     void batch_rangeProofs();
 
+private:
+    static bool verify_sigma(const SigmaProofContainer& sigmaProofs);
+    static bool verify_lelantus(const LelantusSigmaProofContainer& lelantusSigmaProofs);
+    static bool verify_rangeProofs(const RangeProofContainer& rangeProofs);
+
 public:
     bool fCollectProofs = 0;
 
 private:
     static std::unique_ptr<BatchProofContainer> instance;
     // temp containers, to forget in case block connection fails
-    // map (denom, id) to (sigma proof, serial, set size)
-    std::map<std::pair<sigma::CoinDenomination, std::pair<int, bool>>, std::vector<SigmaProofData>> tempSigmaProofs;
-    // map ((id, afterFixes), fIsSigmaToLelantus) to (sigma proof, serial, set size, challenge)
-    std::map<std::pair<std::pair<uint32_t, bool>, bool>, std::vector<LelantusSigmaProofData>> tempLelantusSigmaProofs;
-    // map (version to (Range proof, Pubcoins))
-    std::map<unsigned int, std::vector<std::pair<lelantus::RangeProof, std::vector<lelantus::PublicCoin>>>> tempRangeProofs;
+    SigmaProofContainer tempSigmaProofs;
+    LelantusSigmaProofContainer tempLelantusSigmaProofs;
+    RangeProofContainer tempRangeProofs;
 
     // containers to keep proofs for batching
-    std::map<std::pair<sigma::CoinDenomination, std::pair<int, bool>>, std::vector<SigmaProofData>> sigmaProofs;
-    std::map<std::pair<std::pair<uint32_t, bool>, bool>, std::vector<LelantusSigmaProofData>> lelantusSigmaProofs;
-    std::map<unsigned int, std::vector<std::pair<lelantus::RangeProof, std::vector<lelantus::PublicCoin>>>> rangeProofs;
+    SigmaProofContainer sigmaProofs;
+    LelantusSigmaProofContainer lelantusSigmaProofs;
+    RangeProofContainer rangeProofs;
 
 };
 
@@ -0,0 +1,150 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "lelantus.h"
+#include "sigma.h"
+#include "primitives/mint_spend.h"
+
+#include <memory>
+#include <vector>
+
+// Number of mints and spends the states are filled with
+static const size_t nStateMints = 2000000;
+static const size_t nMintsPerBlock = 1000;
+
+// Hashes looked up by the benchmarks, half of them are missing from the state
+static const size_t nLookups = 1024;
+
+struct CoinStateData {
+    std::vector<uint256> blockHashes;
+    std::vector<CBlockIndex> blocks;
+    std::vector<uint256> pubCoinHashes;
+    std::vector<uint256> serialHashes;
+
+    CoinStateData() : blockHashes(nStateMints / nMintsPerBlock), blocks(nStateMints / nMintsPerBlock) {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            blockHashes[i] = ArithToUint256(arith_uint256(i + 1));
+            blocks[i].phashBlock = &blockHashes[i];
+            blocks[i].nHeight = i + 1;
+            blocks[i].pprev = i > 0 ? &blocks[i - 1] : nullptr;
+        }
+    }
+
+    // Walk mints so that they are cheap to generate, every next coin is G plus the previous one
+    template<typename Func>
+    void GenerateMints(Func addMint) {
+        GroupElement g;
+        g.set_base_g();
+        GroupElement value = g;
+        Scalar serial(uint64_t(1));
+        for (size_t i = 0; i < nStateMints; i++) {
+            addMint(blocks[i / nMintsPerBlock], i, value, serial);
+            if (i % (nStateMints / nLookups) == 0) {
+                pubCoinHashes.push_back(primitives::GetPubCoinValueHash(value));
+                serialHashes.push_back(primitives::GetSerialHash(serial));
+            }
+            value += g;
+            serial += Scalar(uint64_t(1));
+        }
+
+        for (size_t i = 0; i < nLookups; i++) {
+            value += g;
+            serial += Scalar(uint64_t(1));
+            pubCoinHashes.push_back(primitives::GetPubCoinValueHash(value));
+            serialHashes.push_back(primitives::GetSerialHash(serial));
+        }
+    }
+};
+
+static std::unique_ptr<lelantus::CLelantusState> BuildLelantusState(CoinStateData& data)
+{
+    SelectParams(CBaseChainParams::MAIN);
+
+    std::unique_ptr<lelantus::CLelantusState> state(new lelantus::CLelantusState());
+    data.GenerateMints([](CBlockIndex& index, size_t i, const GroupElement& value, const Scalar& serial) {
+        int id = 1 + i / ZC_LELANTUS_MAX_MINT_NUM;
+        index.ModifyCoinData().lelantusMintedPubCoins[id].push_back(std::make_pair(lelantus::PublicCoin(value), uint256()));
+        index.ModifyCoinData().lelantusSpentSerials[serial] = id;
+    });
+
+    for (auto& index : data.blocks)
+        state->AddBlock(&index);
+
+    return state;
+}
+
+static std::unique_ptr<sigma::CSigmaState> BuildSigmaState(CoinStateData& data)
+{
+    SelectParams(CBaseChainParams::MAIN);
+
+    std::unique_ptr<sigma::CSigmaState> state(new sigma::CSigmaState());
+    data.GenerateMints([](CBlockIndex& index, size_t i, const GroupElement& value, const Scalar& serial) {
+        int id = 1 + i / ZC_SPEND_V3_COINSPERID_LIMIT;
+        index.ModifyCoinData().sigmaMintedPubCoins[std::make_pair(sigma::CoinDenomination::SIGMA_DENOM_1, id)].push_back(
+            sigma::PublicCoin(value, sigma::CoinDenomination::SIGMA_DENOM_1));
+        index.ModifyCoinData().sigmaSpentSerials[serial] = sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, id);
+    });
+
+    for (auto& index : data.blocks)
+        state->AddBlock(&index);
+
+    return state;
+}
+
+static void LelantusHasCoinHash(benchmark::State& state)
+{
+    CoinStateData data;
+    auto lelantusState = BuildLelantusState(data);
+
+    GroupElement value;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        lelantusState->HasCoinHash(value, data.pubCoinHashes[i++ % data.pubCoinHashes.size()]);
+    }
+}
+
+static void LelantusIsUsedCoinSerialHash(benchmark::State& state)
+{
+    CoinStateData data;
+    auto lelantusState = BuildLelantusState(data);
+
+    Scalar serial;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        lelantusState->IsUsedCoinSerialHash(serial, data.serialHashes[i++ % data.serialHashes.size()]);
+    }
+}
+
+static void SigmaHasCoinHash(benchmark::State& state)
+{
+    CoinStateData data;
+    auto sigmaState = BuildSigmaState(data);
+
+    GroupElement value;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        sigmaState->HasCoinHash(value, data.pubCoinHashes[i++ % data.pubCoinHashes.size()]);
+    }
+}
+
+static void SigmaIsUsedCoinSerialHash(benchmark::State& state)
+{
+    CoinStateData data;
+    auto sigmaState = BuildSigmaState(data);
+
+    Scalar serial;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        sigmaState->IsUsedCoinSerialHash(serial, data.serialHashes[i++ % data.serialHashes.size()]);
+    }
+}
+
+BENCHMARK(LelantusHasCoinHash);
+BENCHMARK(LelantusIsUsedCoinSerialHash);
+BENCHMARK(SigmaHasCoinHash);
+BENCHMARK(SigmaIsUsedCoinSerialHash);
@@ -0,0 +1,102 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "amount.h"
+#include "arith_uint256.h"
+#include "firo_params.h"
+#include "streams.h"
+#include "version.h"
+#include "liblelantus/joinsplit.h"
+
+#include <map>
+#include <vector>
+
+// Size of the anonymity sets the benchmarks work on
+static const size_t nAnonymitySetSize = 1 << 14;
+
+static std::vector<lelantus::PublicCoin> BuildAnonymitySet(size_t size)
+{
+    GroupElement g;
+    g.set_base_g();
+    GroupElement value = g;
+
+    std::vector<lelantus::PublicCoin> coins;
+    coins.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        coins.emplace_back(value);
+        value += g;
+    }
+    return coins;
+}
+
+// Reading an anonymity set back from its serialized form, as it is done for block index entries
+static void LelantusAnonymitySetLoad(benchmark::State& state)
+{
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << BuildAnonymitySet(nAnonymitySetSize);
+
+    while (state.KeepRunning()) {
+        CDataStream copy(stream);
+        std::vector<lelantus::PublicCoin> coins;
+        copy >> coins;
+    }
+}
+
+// Copying an anonymity set, as it is done when the set is handed out to the verifier
+static void LelantusAnonymitySetCopy(benchmark::State& state)
+{
+    std::vector<lelantus::PublicCoin> coins = BuildAnonymitySet(nAnonymitySetSize);
+
+    while (state.KeepRunning()) {
+        std::vector<lelantus::PublicCoin> copy(coins);
+    }
+}
+
+// Serializing an anonymity set, as it is done for the set hash and the RPC output
+static void LelantusAnonymitySetSerialize(benchmark::State& state)
+{
+    std::vector<GroupElement> values;
+    for (const auto& coin : BuildAnonymitySet(nAnonymitySetSize))
+        values.push_back(coin.getValue());
+
+    std::vector<unsigned char> buffer(values.size() * GroupElement::serialize_size);
+    while (state.KeepRunning()) {
+        GroupElement::serialize_all(values, buffer.data());
+    }
+}
+
+static void LelantusJoinSplitVerify(benchmark::State& state)
+{
+    auto params = lelantus::Params::get_default();
+
+    std::vector<lelantus::PrivateCoin> privs = {
+        lelantus::PrivateCoin(params, 10 * COIN),
+        lelantus::PrivateCoin(params, 5 * COIN)
+    };
+
+    std::map<uint32_t, std::vector<lelantus::PublicCoin>> anonymitySets = {
+        {1, BuildAnonymitySet(nAnonymitySetSize)}
+    };
+    anonymitySets[1][0] = privs[0].getPublicCoin();
+
+    std::vector<std::pair<lelantus::PrivateCoin, uint32_t>> cin = {{privs[0], 1}};
+    std::map<uint32_t, uint256> groupBlockHashes = {{1, ArithToUint256(1)}};
+
+    // inputs = 10, outputs = 5(mint) + 4.99(vout) + 0.01(fee)
+    uint64_t vout = 5 * COIN - CENT;
+    lelantus::JoinSplit joinSplit(
+        params, cin, anonymitySets, {}, vout, {privs[1]}, CENT, groupBlockHashes, ArithToUint256(2), LELANTUS_TX_VERSION_4);
+
+    std::vector<lelantus::PublicCoin> cout = {privs[1].getPublicCoin()};
+    while (state.KeepRunning()) {
+        assert(joinSplit.Verify(anonymitySets, {}, cout, vout, ArithToUint256(2)));
+    }
+}
+
+BENCHMARK(LelantusAnonymitySetLoad);
+BENCHMARK(LelantusAnonymitySetCopy);
+BENCHMARK(LelantusAnonymitySetSerialize);
+BENCHMARK(LelantusJoinSplitVerify);
@@ -0,0 +1,60 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include <liblelantus/threadpool.h>
+#include <secp256k1/include/MultiExponent.h>
+
+#include <thread>
+#include <vector>
+
+// Multiexponentiation over an anonymity set sized number of points, as done by the one-of-many proof verifiers
+static void MultiExponentBench(benchmark::State& state, size_t size, size_t threads = 1)
+{
+    secp_primitives::GroupElement g;
+    g.set_base_g();
+    secp_primitives::GroupElement value = g;
+
+    std::vector<secp_primitives::GroupElement> points;
+    std::vector<secp_primitives::Scalar> scalars(size);
+    points.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        points.emplace_back(value);
+        value += g;
+        scalars[i].randomize();
+    }
+
+    while (state.KeepRunning()) {
+        secp_primitives::MultiExponent(points, scalars).get_multiple(threads);
+    }
+}
+
+static void MultiExponent1024(benchmark::State& state)
+{
+    MultiExponentBench(state, 1 << 10);
+}
+
+static void MultiExponent16384(benchmark::State& state)
+{
+    MultiExponentBench(state, 1 << 14);
+}
+
+static void MultiExponent65536(benchmark::State& state)
+{
+    MultiExponentBench(state, 1 << 16);
+}
+
+// The same on all cores, to compare with the serial one
+static void MultiExponent65536Parallel(benchmark::State& state)
+{
+    // the chunks run on the proof threads, the pool sets itself up as the executor
+    ParallelOpThreadPool::GetInstance();
+    MultiExponentBench(state, 1 << 16, std::thread::hardware_concurrency());
+}
+
+BENCHMARK(MultiExponent1024);
+BENCHMARK(MultiExponent16384);
+BENCHMARK(MultiExponent65536);
+BENCHMARK(MultiExponent65536Parallel);
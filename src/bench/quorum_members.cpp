@@ -0,0 +1,64 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "hash.h"
+#include "random.h"
+
+#include "evo/deterministicmns.h"
+#include "llmq/quorums_utils.h"
+
+static const size_t MN_COUNT = 2500;
+static const size_t QUORUM_SIZE = 400;
+
+static CDeterministicMNList BuildMNList(size_t count)
+{
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (size_t i = 0; i < count; i++) {
+        auto dmn = std::make_shared<CDeterministicMN>();
+        dmn->proTxHash = GetRandHash();
+        dmn->internalId = i;
+        dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        dmnState->keyIDOwner = CKeyID(Hash160(dmn->proTxHash.begin(), dmn->proTxHash.end()));
+        dmnState->UpdateConfirmedHash(dmn->proTxHash, GetRandHash());
+        dmn->pdmnState = dmnState;
+        mnList.AddMN(dmn);
+    }
+    return mnList;
+}
+
+// Scores and sorts all masternodes, which is what every lookup of quorum members did before they were cached
+static void QuorumMembers_Calculate_2500(benchmark::State& state)
+{
+    CDeterministicMNList mnList = BuildMNList(MN_COUNT);
+    uint256 quorumHash = GetRandHash();
+    auto modifier = ::SerializeHash(std::make_pair((uint8_t)Consensus::LLMQ_400_60, quorumHash));
+    while (state.KeepRunning()) {
+        auto members = mnList.CalculateQuorum(QUORUM_SIZE, modifier);
+        assert(members.size() == QUORUM_SIZE);
+    }
+}
+
+// Looks up the members of a rotating set of active quorums, as the DKG and signing code do
+static void QuorumMembers_Cached_2500(benchmark::State& state)
+{
+    CDeterministicMNList mnList = BuildMNList(MN_COUNT);
+    std::vector<uint256> quorumHashes(24);
+    for (auto& quorumHash : quorumHashes) {
+        quorumHash = GetRandHash();
+    }
+    llmq::CQuorumMembersCache cache;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        auto quorumMembers = cache.Get(Consensus::LLMQ_400_60, quorumHashes[i++ % quorumHashes.size()], QUORUM_SIZE, [&]() {
+            return mnList;
+        });
+        assert(quorumMembers->GetMemberIndex(quorumMembers->members.back()->proTxHash) == (int)QUORUM_SIZE - 1);
+    }
+}
+
+BENCHMARK(QuorumMembers_Calculate_2500);
+BENCHMARK(QuorumMembers_Cached_2500);
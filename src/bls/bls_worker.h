@@ -8,6 +8,8 @@
 #include <bls/bls.h>
 
 #include <ctpl.h>
+#include <saltedhasher.h>
+#include <unordered_lru_cache.h>
 
 #include <future>
 #include <mutex>
@@ -147,19 +149,60 @@ private:
 // Cache keys are provided externally as computing hashes on BLS vectors is too expensive
 // If multiple threads try to build the same thing at the same time, only one will actually build it
 // and the other ones will wait for the result of the first caller
+// Every cache is bounded and drops the least recently used entries once it grows past twice its size
 class CBLSWorkerCache
 {
+public:
+    static const size_t DEFAULT_VVEC_CACHE_SIZE = 16;
+    static const size_t DEFAULT_SECRET_KEY_SHARE_CACHE_SIZE = 16;
+    static const size_t DEFAULT_PUBLIC_KEY_SHARE_CACHE_SIZE = 400;
+
+    struct CacheStats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        size_t size{0};
+    };
+    struct Stats {
+        CacheStats vvec;
+        CacheStats secretKeyShare;
+        CacheStats publicKeyShare;
+    };
+
 private:
+    template <typename T>
+    struct Cache {
+        unordered_lru_cache<uint256, std::shared_future<T>, StaticSaltedHasher> entries;
+        uint64_t hits{0};
+        uint64_t misses{0};
+
+        explicit Cache(size_t maxSize) : entries(maxSize) {}
+
+        CacheStats GetStats() const
+        {
+            CacheStats stats;
+            stats.hits = hits;
+            stats.misses = misses;
+            stats.size = entries.size();
+            return stats;
+        }
+    };
+
     CBLSWorker& worker;
 
-    std::mutex cacheCs;
-    std::map<uint256, std::shared_future<BLSVerificationVectorPtr> > vvecCache;
-    std::map<uint256, std::shared_future<CBLSSecretKey> > secretKeyShareCache;
-    std::map<uint256, std::shared_future<CBLSPublicKey> > publicKeyShareCache;
+    mutable std::mutex cacheCs;
+    Cache<BLSVerificationVectorPtr> vvecCache;
+    Cache<CBLSSecretKey> secretKeyShareCache;
+    Cache<CBLSPublicKey> publicKeyShareCache;
 
 public:
-    explicit CBLSWorkerCache(CBLSWorker& _worker) :
-        worker(_worker) {}
+    explicit CBLSWorkerCache(CBLSWorker& _worker,
+                             size_t publicKeyShareCacheSize = DEFAULT_PUBLIC_KEY_SHARE_CACHE_SIZE,
+                             size_t vvecCacheSize = DEFAULT_VVEC_CACHE_SIZE,
+                             size_t secretKeyShareCacheSize = DEFAULT_SECRET_KEY_SHARE_CACHE_SIZE) :
+        worker(_worker),
+        vvecCache(vvecCacheSize),
+        secretKeyShareCache(secretKeyShareCacheSize),
+        publicKeyShareCache(publicKeyShareCacheSize) {}
 
     BLSVerificationVectorPtr BuildQuorumVerificationVector(const uint256& cacheKey, const std::vector<BLSVerificationVectorPtr>& vvecs)
     {
@@ -180,20 +223,32 @@ public:
         });
     }
 
+    Stats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(cacheCs);
+        Stats stats;
+        stats.vvec = vvecCache.GetStats();
+        stats.secretKeyShare = secretKeyShareCache.GetStats();
+        stats.publicKeyShare = publicKeyShareCache.GetStats();
+        return stats;
+    }
+
 private:
     template <typename T, typename Builder>
-    T GetOrBuild(const uint256& cacheKey, std::map<uint256, std::shared_future<T> >& cache, Builder&& builder)
+    T GetOrBuild(const uint256& cacheKey, Cache<T>& cache, Builder&& builder)
     {
         cacheCs.lock();
-        auto it = cache.find(cacheKey);
-        if (it != cache.end()) {
-            auto f = it->second;
+        std::shared_future<T> f;
+        if (cache.entries.get(cacheKey, f)) {
+            cache.hits++;
             cacheCs.unlock();
             return f.get();
         }
 
+        // waiters keep their copy of the future, so an entry evicted while it's being built still gets its value
         std::promise<T> p;
-        cache.emplace(cacheKey, p.get_future());
+        cache.entries.insert(cacheKey, p.get_future().share());
+        cache.misses++;
         cacheCs.unlock();
 
         T v = builder();
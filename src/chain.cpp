@@ -5,6 +5,13 @@
 
 #include "chain.h"
 
+#include "saltedhasher.h"
+#include "txdb.h"
+#include "unordered_lru_cache.h"
+#include "validation.h"
+
+#include <mutex>
+
 /**
  * CChain implementation
  */
@@ -117,6 +124,111 @@ void CBlockIndex::BuildSkip()
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
 }
 
+namespace {
+
+// Number of blocks whose mints and spends read from the block index database are kept in memory
+const size_t BLOCK_COIN_DATA_CACHE_SIZE = 10000;
+
+std::mutex cs_coinDataCache;
+unordered_lru_cache<uint256, std::shared_ptr<const CBlockCoinData>, StaticSaltedHasher, BLOCK_COIN_DATA_CACHE_SIZE> coinDataCache;
+
+const std::shared_ptr<const CBlockCoinData> emptyCoinData = std::make_shared<CBlockCoinData>();
+
+}
+
+CBlockCoinCounts::CBlockCoinCounts(const CBlockCoinData& data)
+{
+    for (const auto& coins : data.sigmaMintedPubCoins) {
+        if (!coins.second.empty())
+            sigmaMints[coins.first] = coins.second.size();
+    }
+    for (const auto& coins : data.lelantusMintedPubCoins) {
+        if (!coins.second.empty())
+            lelantusMints[coins.first] = coins.second.size();
+    }
+    nSpends = data.sigmaSpentSerials.size() + data.lelantusSpentSerials.size();
+}
+
+std::shared_ptr<const CBlockCoinData> CBlockIndex::GetCoinData() const
+{
+    if (coinData)
+        return coinData;
+    if (coinCounts.IsNull())
+        return emptyCoinData;
+
+    uint256 hash = GetBlockHash();
+    std::shared_ptr<const CBlockCoinData> data;
+    {
+        std::lock_guard<std::mutex> lock(cs_coinDataCache);
+        if (coinDataCache.get(hash, data))
+            return data;
+    }
+
+    std::shared_ptr<CBlockCoinData> diskData = std::make_shared<CBlockCoinData>();
+    if (!pblocktree || !pblocktree->ReadBlockCoinData(hash, *diskData))
+        throw std::runtime_error(strprintf("%s: failed to read mints and spends of block %s", __func__, hash.ToString()));
+
+    std::lock_guard<std::mutex> lock(cs_coinDataCache);
+    coinDataCache.insert(hash, diskData);
+    return diskData;
+}
+
+CBlockCoinData& CBlockIndex::ModifyCoinData()
+{
+    // the data handed out before is left as it was
+    if (!coinData || coinData.use_count() > 1)
+        coinData = std::make_shared<CBlockCoinData>(*GetCoinData());
+    return *coinData;
+}
+
+void CBlockIndex::ReleaseCoinData()
+{
+    if (!coinData)
+        return;
+
+    coinCounts = CBlockCoinCounts(*coinData);
+    if (phashBlock && !coinCounts.IsNull()) {
+        std::lock_guard<std::mutex> lock(cs_coinDataCache);
+        coinDataCache.insert(GetBlockHash(), coinData);
+    }
+    coinData.reset();
+}
+
+bool CBlockIndex::HasCoinData() const
+{
+    if (coinData) {
+        return !coinData->sigmaMintedPubCoins.empty() || !coinData->lelantusMintedPubCoins.empty()
+            || !coinData->sigmaSpentSerials.empty() || !coinData->lelantusSpentSerials.empty();
+    }
+    return !coinCounts.IsNull();
+}
+
+size_t CBlockIndex::GetSigmaMintCount(const std::pair<sigma::CoinDenomination, int>& denomAndId) const
+{
+    if (coinData) {
+        auto it = coinData->sigmaMintedPubCoins.find(denomAndId);
+        return it != coinData->sigmaMintedPubCoins.end() ? it->second.size() : 0;
+    }
+    auto it = coinCounts.sigmaMints.find(denomAndId);
+    return it != coinCounts.sigmaMints.end() ? it->second : 0;
+}
+
+size_t CBlockIndex::GetLelantusMintCount(int id) const
+{
+    if (coinData) {
+        auto it = coinData->lelantusMintedPubCoins.find(id);
+        return it != coinData->lelantusMintedPubCoins.end() ? it->second.size() : 0;
+    }
+    auto it = coinCounts.lelantusMints.find(id);
+    return it != coinCounts.lelantusMints.end() ? it->second : 0;
+}
+
+void CBlockIndex::ClearCoinDataCache()
+{
+    std::lock_guard<std::mutex> lock(cs_coinDataCache);
+    coinDataCache.clear();
+}
+
 arith_uint256 GetBlockProof(const CBlockIndex& block)
 {
     arith_uint256 bnTarget;
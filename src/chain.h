@@ -22,6 +22,7 @@
 #include "coin_containers.h"
 #include "streams.h"
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
@@ -159,6 +160,74 @@ enum BlockStatus: uint32_t {
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
 };
 
+/** Sigma and Lelantus mints and spends of a block. They are kept in the block index database and read on demand
+ * through CBlockIndex::GetCoinData, the block index only holds their numbers in memory.
+ */
+struct CBlockCoinData
+{
+    //! Public coin values of mints in this block, ordered by serialized value of public coin
+    //! Maps <denomination,id> to vector of public coins
+    std::map<std::pair<sigma::CoinDenomination, int>, std::vector<sigma::PublicCoin>> sigmaMintedPubCoins;
+    //! Map id to <public coin, tag>
+    std::map<int, std::vector<std::pair<lelantus::PublicCoin, uint256>>>  lelantusMintedPubCoins;
+
+    //! Values of coin serials spent in this block
+    sigma::spend_info_container sigmaSpentSerials;
+    std::unordered_map<Scalar, int> lelantusSpentSerials;
+};
+
+/** Numbers of the mints of a block per coin group and of its spends */
+struct CBlockCoinCounts
+{
+    std::map<std::pair<sigma::CoinDenomination, int>, size_t> sigmaMints;
+    std::map<int, size_t> lelantusMints;
+    size_t nSpends = 0;
+
+    CBlockCoinCounts() {}
+    explicit CBlockCoinCounts(const CBlockCoinData& data);
+
+    bool IsNull() const {
+        return sigmaMints.empty() && lelantusMints.empty() && nSpends == 0;
+    }
+
+    // Readers of the serialized CBlockCoinData containers counting the coins and serials and skipping over them, the
+    // way the block index is loaded without decompressing every public coin
+
+    template <typename Stream>
+    void ReadSigma(Stream& s) {
+        // map <denomination, id> -> vector of 34 byte coin values followed by 4 byte denominations
+        for (uint64_t nGroups = ReadCompactSize(s); nGroups > 0; nGroups--) {
+            std::pair<sigma::CoinDenomination, int> denomAndId;
+            s >> denomAndId;
+            uint64_t nCoins = ReadCompactSize(s);
+            s.ignore(nCoins * (GroupElement::serialize_size + sizeof(int32_t)));
+            if (nCoins > 0)
+                sigmaMints[denomAndId] += nCoins;
+        }
+        // serial -> two 8 byte integers of CSpendCoinInfo
+        uint64_t nSerials = ReadCompactSize(s);
+        s.ignore(nSerials * (Scalar::memoryRequired() + 2 * sizeof(int64_t)));
+        nSpends += nSerials;
+    }
+
+    template <typename Stream>
+    void ReadLelantus(Stream& s, bool fWithTags) {
+        // map id -> vector of 34 byte coin values, each followed by a 32 byte tag unless written before tags were kept
+        for (uint64_t nGroups = ReadCompactSize(s); nGroups > 0; nGroups--) {
+            int id;
+            s >> id;
+            uint64_t nCoins = ReadCompactSize(s);
+            s.ignore(nCoins * (GroupElement::serialize_size + (fWithTags ? sizeof(uint256) : 0)));
+            if (nCoins > 0)
+                lelantusMints[id] += nCoins;
+        }
+        // serial -> 4 byte group id
+        uint64_t nSerials = ReadCompactSize(s);
+        s.ignore(nSerials * (Scalar::memoryRequired() + sizeof(int32_t)));
+        nSpends += nSerials;
+    }
+};
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -239,18 +308,9 @@ public:
 
 /////////////////////// Sigma index entries. ////////////////////////////////////////////
 
-    //! Public coin values of mints in this block, ordered by serialized value of public coin
-    //! Maps <denomination,id> to vector of public coins
-    std::map<std::pair<sigma::CoinDenomination, int>, std::vector<sigma::PublicCoin>> sigmaMintedPubCoins;
-    //! Map id to <public coin, tag>
-    std::map<int, std::vector<std::pair<lelantus::PublicCoin, uint256>>>  lelantusMintedPubCoins;
     //! Map id to <hash of the set>
     std::map<int, std::vector<unsigned char>> anonymitySetHash;
 
-    //! Values of coin serials spent in this block
-    sigma::spend_info_container sigmaSpentSerials;
-    std::unordered_map<Scalar, int> lelantusSpentSerials;
-
     //! list of disabling sporks active at this block height
     //! std::map {feature name} -> {block number when feature is re-enabled again, parameter}
     ActiveSporkMap activeDisablingSporks;
@@ -285,11 +345,9 @@ public:
         nVersionMTP = 0;
         mtpHashValue = reserved[0] = reserved[1] = uint256();
 
-        sigmaMintedPubCoins.clear();
-        lelantusMintedPubCoins.clear();
         anonymitySetHash.clear();
-        sigmaSpentSerials.clear();
-        lelantusSpentSerials.clear();
+        coinData.reset();
+        coinCounts = CBlockCoinCounts();
         activeDisablingSporks.clear();
     }
 
@@ -439,6 +497,33 @@ public:
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
+
+    //! Sigma and Lelantus mints and spends of this block, read from the block index database unless they have been
+    //! changed since the block index was written. Requires cs_main
+    std::shared_ptr<const CBlockCoinData> GetCoinData() const;
+    //! Mints and spends of this block to be changed, kept in memory until the block index is written. The reference is
+    //! valid until the next call
+    CBlockCoinData& ModifyCoinData();
+    bool IsCoinDataModified() const { return coinData != nullptr; }
+    //! Drops the changed mints and spends once the block index has been written, keeping them in the cache of the
+    //! recently used ones
+    void ReleaseCoinData();
+
+    //! Whether the block has any Sigma or Lelantus mints or spends, the blocks without them aren't looked up
+    bool HasCoinData() const;
+    size_t GetSigmaMintCount(const std::pair<sigma::CoinDenomination, int>& denomAndId) const;
+    size_t GetLelantusMintCount(int id) const;
+    //! Numbers of the mints and spends read along with the block index
+    void SetCoinCounts(const CBlockCoinCounts& counts) { coinCounts = counts; }
+
+    //! Empties the cache of the mints and spends read from the block index database
+    static void ClearCoinDataCache();
+
+private:
+    //! Mints and spends changed since the block index was written
+    std::shared_ptr<CBlockCoinData> coinData;
+    //! Numbers of the mints and spends in the block index database
+    CBlockCoinCounts coinCounts;
 };
 
 arith_uint256 GetBlockProof(const CBlockIndex& block);
@@ -452,15 +537,22 @@ public:
     uint256 hashPrev;
     int nDiskBlockVersion;
 
+    CBlockCoinData diskCoinData;
+    //! When set, reading only counts the mints and spends into diskCoinCounts instead of filling diskCoinData
+    bool fCountCoinsOnly;
+    CBlockCoinCounts diskCoinCounts;
+
     CDiskBlockIndex() {
         hashPrev = uint256();
         // value doesn't really matter but we won't leave it uninitialized
         nDiskBlockVersion = 0;
+        fCountCoinsOnly = false;
     }
 
-    explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
+    explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex), diskCoinData(*pindex->GetCoinData()) {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
         nDiskBlockVersion = 0;
+        fCountCoinsOnly = false;
     }
 
     ADD_SERIALIZE_METHODS;
@@ -511,25 +603,33 @@ public:
 	    }
 
         if (!(s.GetType() & SER_GETHASH) && nHeight >= params.nSigmaStartBlock) {
-            READWRITE(sigmaMintedPubCoins);
-            READWRITE(sigmaSpentSerials);
+            if (ser_action.ForRead() && fCountCoinsOnly) {
+                diskCoinCounts.ReadSigma(s);
+            } else {
+                READWRITE(diskCoinData.sigmaMintedPubCoins);
+                READWRITE(diskCoinData.sigmaSpentSerials);
+            }
         }
 
         if (!(s.GetType() & SER_GETHASH)
                 && nHeight >= params.nLelantusStartBlock
                 && nVersion >= LELANTUS_PROTOCOL_ENABLEMENT_VERSION) {
-            if(nVersion == LELANTUS_PROTOCOL_ENABLEMENT_VERSION) {
-                std::map<int, std::vector<lelantus::PublicCoin>>  lelantusPubCoins;
-                READWRITE(lelantusPubCoins);
-                for(auto& itr : lelantusPubCoins) {
-                    if(!itr.second.empty()) {
-                        for(auto& coin : itr.second)
-                        lelantusMintedPubCoins[itr.first].push_back(std::make_pair(coin, uint256()));
+            if (ser_action.ForRead() && fCountCoinsOnly) {
+                diskCoinCounts.ReadLelantus(s, nVersion != LELANTUS_PROTOCOL_ENABLEMENT_VERSION);
+            } else {
+                if(nVersion == LELANTUS_PROTOCOL_ENABLEMENT_VERSION) {
+                    std::map<int, std::vector<lelantus::PublicCoin>>  lelantusPubCoins;
+                    READWRITE(lelantusPubCoins);
+                    for(auto& itr : lelantusPubCoins) {
+                        if(!itr.second.empty()) {
+                            for(auto& coin : itr.second)
+                            diskCoinData.lelantusMintedPubCoins[itr.first].push_back(std::make_pair(coin, uint256()));
+                        }
                     }
-                }
-            } else
-                READWRITE(lelantusMintedPubCoins);
-            READWRITE(lelantusSpentSerials);
+                } else
+                    READWRITE(diskCoinData.lelantusMintedPubCoins);
+                READWRITE(diskCoinData.lelantusSpentSerials);
+            }
 
             if (nHeight >= params.nLelantusFixesStartBlock)
                 READWRITE(anonymitySetHash);
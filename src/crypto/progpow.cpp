@@ -7,11 +7,32 @@
 #include <chainparams.h>
 #include <crypto/progpow/helpers.hpp>
 #include <crypto/progpow/lib/ethash/endianness.hpp>
+#include <crypto/progpow/lib/ethash/ethash-internal.hpp>
 #include <crypto/progpow/include/ethash/ethash.hpp>
 #include <hash.h>
 #include <primitives/block.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <map>
+#include <mutex>
+#include <new>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 static inline ethash::hash256 U256ToH256(const uint256& in) {
 
@@ -38,17 +59,269 @@ static inline uint256 H256ToU256(const ethash::hash256& in) {
     return ret;
 }
 
-uint256 progpow_hash_full(const CProgPowHeader& header, uint256& mix_hash)
-{
-    static ethash::epoch_context_ptr epochContext{nullptr,nullptr};
-    if (!epochContext || epochContext->epoch_number != ethash::get_epoch_number(header.nHeight))
-    {
-        epochContext.reset();
-        epochContext = ethash::create_epoch_context(ethash::get_epoch_number(header.nHeight));
+namespace {
+
+// The context of the next epoch starts being built this many blocks before the epoch boundary
+constexpr int epoch_prefetch_blocks = 100;
+
+// Full dataset of an epoch, mapped from a file shared with the other processes
+struct FullDataset {
+    FullDataset(std::shared_ptr<const ethash::epoch_context> light_, void* data_, size_t size_)
+        : light(std::move(light_)),
+          context(light->epoch_number, light->light_cache_num_items, light->light_cache,
+                  static_cast<const uint32_t*>(data_), light->full_dataset_num_items,
+                  static_cast<ethash_hash1024*>(data_)),
+          data(data_),
+          size(size_) {}
+
+    ~FullDataset() {
+#ifndef WIN32
+        munmap(data, size);
+#endif
+    }
+
+    // keeps the light cache the context points to
+    std::shared_ptr<const ethash::epoch_context> light;
+    ethash_epoch_context_full context;
+    void* data;
+    size_t size;
+};
+
+/**
+ * Epoch contexts shared between the validation and the mining threads. It keeps the contexts around the epoch most
+ * recently asked for, the context of the next epoch is built ahead of the boundary so the threads do not stall on it.
+ */
+class EpochContextCache {
+public:
+    ~EpochContextCache() {
+        fInterrupted = true;
+        if (prefetchTask.valid())
+            prefetchTask.wait();
+        if (datasetTask.valid())
+            datasetTask.wait();
+    }
+
+    std::shared_ptr<const ethash::epoch_context> Get(int epoch_number) {
+        return Load(epoch_number, true);
+    }
+
+    void Prefetch(int epoch_number) {
+        std::lock_guard<std::mutex> lock(cs);
+        if (contexts.count(epoch_number) || building.count(epoch_number))
+            return;
+        // one context is built at a time, there is no use for more
+        if (prefetchTask.valid() && prefetchTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+
+        prefetchTask = std::async(std::launch::async, [this, epoch_number] {
+            try {
+                Load(epoch_number, false);
+            } catch (const std::bad_alloc&) {
+                // left to be built when it is asked for
+            }
+        });
     }
 
+    // Returns the full dataset if it is ready, starts building it otherwise
+    std::shared_ptr<const FullDataset> GetFull(int epoch_number) {
+        std::lock_guard<std::mutex> lock(cs);
+        if (datasetDir.empty())
+            return nullptr;
+        if (dataset && dataset->context.epoch_number == epoch_number)
+            return dataset;
+        if (datasetTask.valid() && datasetTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return nullptr;
+        if (failedDatasets.count(epoch_number))
+            return nullptr;
+
+        std::string dir = datasetDir;
+        datasetTask = std::async(std::launch::async, [this, epoch_number, dir] {
+            std::shared_ptr<const FullDataset> full;
+            try {
+                full = MapDataset(dir, Load(epoch_number, false));
+            } catch (const std::bad_alloc&) {
+            }
+
+            std::lock_guard<std::mutex> lock(cs);
+            if (full)
+                dataset = full;
+            else
+                failedDatasets.insert(epoch_number);
+        });
+        return nullptr;
+    }
+
+    void SetDatasetDir(const std::string& dir) {
+        std::lock_guard<std::mutex> lock(cs);
+        datasetDir = dir;
+        dataset.reset();
+        failedDatasets.clear();
+    }
+
+private:
+    std::shared_ptr<const ethash::epoch_context> Load(int epoch_number, bool fCurrent) {
+        std::unique_lock<std::mutex> lock(cs);
+        if (fCurrent)
+            currentEpoch = epoch_number;
+
+        // wait for the context if some other thread is building it already
+        while (true) {
+            auto it = contexts.find(epoch_number);
+            if (it != contexts.end())
+                return it->second;
+            if (!building.count(epoch_number))
+                break;
+            cond.wait(lock);
+        }
+
+        building.insert(epoch_number);
+        lock.unlock();
+
+        ethash::epoch_context* context = ethash_create_epoch_context(epoch_number);
+
+        lock.lock();
+        building.erase(epoch_number);
+        cond.notify_all();
+        if (!context)
+            throw std::bad_alloc();
+
+        std::shared_ptr<const ethash::epoch_context> result(context, ethash_destroy_epoch_context);
+        contexts[epoch_number] = result;
+
+        // keep the previous, the current and the next epochs only
+        for (auto it = contexts.begin(); it != contexts.end();) {
+            if (it->first != epoch_number && std::abs(it->first - currentEpoch) > 1)
+                it = contexts.erase(it);
+            else
+                ++it;
+        }
+        return result;
+    }
+
+    std::shared_ptr<const FullDataset> MapDataset(const std::string& dir, std::shared_ptr<const ethash::epoch_context> light) {
+#ifdef WIN32
+        return nullptr;
+#else
+        const int epoch_number = light->epoch_number;
+        const size_t size = static_cast<size_t>(ethash::get_full_dataset_size(light->full_dataset_num_items));
+        const std::string path = dir + "/epoch-" + std::to_string(epoch_number) + ".dat";
+
+        // the dataset is written to a temporary file and renamed when complete, so the existing file is always whole
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || static_cast<size_t>(st.st_size) != size) {
+            const std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+            int fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+                return nullptr;
+
+            void* data = MAP_FAILED;
+            if (ftruncate(fd, size) == 0)
+                data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+
+            bool fComplete = false;
+            if (data != MAP_FAILED) {
+                fComplete = BuildDataset(*light, static_cast<ethash::hash2048*>(data), light->full_dataset_num_items / 2)
+                    && msync(data, size, MS_SYNC) == 0;
+                munmap(data, size);
+            }
+
+            if (!fComplete || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+                unlink(tmpPath.c_str());
+                return nullptr;
+            }
+        }
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+        // pages stay shared with the other processes, the rare lazily computed item is written to a private copy
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return nullptr;
+
+        // the datasets of the past epochs are not going to be used anymore
+        if (epoch_number > 1)
+            unlink((dir + "/epoch-" + std::to_string(epoch_number - 2) + ".dat").c_str());
+
+        return std::make_shared<FullDataset>(std::move(light), data, size);
+#endif
+    }
+
+    bool BuildDataset(const ethash::epoch_context& light, ethash::hash2048* items, int num_items) {
+        const int nThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nThreads; t++) {
+            threads.emplace_back([this, &light, items, num_items, nThreads, t] {
+                for (int i = t; i < num_items && !fInterrupted; i += nThreads)
+                    items[i] = ethash::calculate_dataset_item_2048(light, static_cast<uint32_t>(i));
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        return !fInterrupted;
+    }
+
+private:
+    std::mutex cs;
+    std::condition_variable cond;
+    std::atomic<bool> fInterrupted{false};
+
+    std::map<int, std::shared_ptr<const ethash::epoch_context>> contexts;
+    // epochs of the contexts being built
+    std::set<int> building;
+    int currentEpoch{0};
+
+    std::string datasetDir;
+    std::shared_ptr<const FullDataset> dataset;
+    std::set<int> failedDatasets;
+
+    std::future<void> prefetchTask;
+    std::future<void> datasetTask;
+};
+
+EpochContextCache& GetEpochContextCache()
+{
+    static EpochContextCache cache;
+    return cache;
+}
+
+} // namespace
+
+std::shared_ptr<const ethash::epoch_context> progpow_get_epoch_context(int epoch_number)
+{
+    return GetEpochContextCache().Get(epoch_number);
+}
+
+void progpow_prefetch_epoch(int epoch_number)
+{
+    GetEpochContextCache().Prefetch(epoch_number);
+}
+
+void progpow_set_dataset_dir(const std::string& dir)
+{
+    GetEpochContextCache().SetDatasetDir(dir);
+}
+
+uint256 progpow_hash_full(const CProgPowHeader& header, uint256& mix_hash, bool use_full_dataset)
+{
+    const int block_number = static_cast<int>(header.nHeight);
+    const int epoch_number = ethash::get_epoch_number(block_number);
+    if (block_number % progpow::epoch_length >= progpow::epoch_length - epoch_prefetch_blocks)
+        progpow_prefetch_epoch(epoch_number + 1);
+
     const auto header_h256{U256ToH256(SerializeHash(header))};
-    const auto result = progpow::hash(*epochContext, header.nHeight, header_h256, header.nNonce64);
+
+    ethash::result result;
+    std::shared_ptr<const FullDataset> dataset;
+    if (use_full_dataset && (dataset = GetEpochContextCache().GetFull(epoch_number))) {
+        result = progpow::hash(dataset->context, block_number, header_h256, header.nNonce64);
+    } else {
+        const auto epochContext = progpow_get_epoch_context(epoch_number);
+        result = progpow::hash(*epochContext, block_number, header_h256, header.nNonce64);
+    }
+
     mix_hash = H256ToU256(result.mix_hash);
     return H256ToU256(result.final_hash);
 }
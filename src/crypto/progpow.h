@@ -11,6 +11,9 @@
 #include <uint256.h>
 #include <serialize.h>
 
+#include <memory>
+#include <string>
+
 /**
  * Serializer for ProgPow BlockHeader input
 */
@@ -39,10 +42,21 @@ public:
     }
 };
 
-/* Performs a full progpow hash (DAG loops implied) provided header already hash nHeight valued */
-uint256 progpow_hash_full(const CProgPowHeader& header, uint256& mix_hash);
+/* Performs a full progpow hash (DAG loops implied) provided header already hash nHeight valued. The full dataset is
+   used if requested and already built for the epoch, otherwise the dataset items are computed from the light cache */
+uint256 progpow_hash_full(const CProgPowHeader& header, uint256& mix_hash, bool use_full_dataset = false);
 
 /* Performs a light progpow hash (DAG loops excluded) provided header has mix_hash */
 uint256 progpow_hash_light(const CProgPowHeader& header);
 
+/* Returns the light epoch context shared by all the threads, building it if it is not cached yet */
+std::shared_ptr<const ethash::epoch_context> progpow_get_epoch_context(int epoch_number);
+
+/* Starts building the light epoch context on a background thread unless it is cached or being built already */
+void progpow_prefetch_epoch(int epoch_number);
+
+/* Keeps the full datasets in memory-mapped files in the directory so the miners on the machine can share them,
+   an empty directory disables the full datasets. Has no effect on Windows */
+void progpow_set_dataset_dir(const std::string& dir);
+
 #endif // FIRO_PROGPOW_H
@@ -0,0 +1,223 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Based on https://github.com/noloader/SHA-Intrinsics/blob/master/sha256-x86.c,
+// Written and placed in public domain by Jeffrey Walton.
+// Based on code from Intel, and by Sean Gulley for the miTLS project.
+
+#ifdef ENABLE_SHANI
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace {
+
+alignas(__m128i) const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+alignas(__m128i) const uint8_t PADDING64[64] = {
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0
+};
+alignas(__m128i) const uint8_t PADDING32[32] = {
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0
+};
+alignas(__m128i) const uint32_t INIT[8] = {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul};
+
+const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+/** Four rounds, m holding the next four message words. */
+void inline QuadRound(__m128i& state0, __m128i& state1, __m128i m, int i)
+{
+    const __m128i msg = _mm_add_epi32(m, _mm_load_si128((const __m128i*)(K + i)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+}
+
+/** Extend the message schedule in m after the four rounds of group r. */
+void inline Schedule(__m128i* m, int r)
+{
+    if (r >= 3 && r < 15) {
+        m[(r + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(m[(r + 1) & 3], _mm_alignr_epi8(m[r & 3], m[(r - 1) & 3], 4)), m[r & 3]);
+    }
+    if (r >= 1 && r < 13) {
+        m[(r - 1) & 3] = _mm_sha256msg1_epu32(m[(r - 1) & 3], m[r & 3]);
+    }
+}
+
+/** All 64 rounds, extending the message schedule in m four words at a time. */
+void inline Rounds(__m128i& state0, __m128i& state1, __m128i* m)
+{
+    for (int r = 0; r < 16; r++) {
+        QuadRound(state0, state1, m[r & 3], 4 * r);
+        Schedule(m, r);
+    }
+}
+
+/** All 64 rounds on two independent states, interleaved to keep the SHA units busy. */
+void inline Rounds2(__m128i* state0, __m128i* state1, __m128i* ma, __m128i* mb)
+{
+    for (int r = 0; r < 16; r++) {
+        QuadRound(state0[0], state1[0], ma[r & 3], 4 * r);
+        QuadRound(state0[1], state1[1], mb[r & 3], 4 * r);
+        Schedule(ma, r);
+        Schedule(mb, r);
+    }
+}
+
+/** Turn the state words into the (ABEF, CDGH) order the SHA instructions use. */
+void inline Shuffle(__m128i& s0, __m128i& s1)
+{
+    const __m128i t1 = _mm_shuffle_epi32(s0, 0xB1);
+    const __m128i t2 = _mm_shuffle_epi32(s1, 0x1B);
+    s0 = _mm_alignr_epi8(t1, t2, 0x08);
+    s1 = _mm_blend_epi16(t2, t1, 0xF0);
+}
+
+void inline Unshuffle(__m128i& s0, __m128i& s1)
+{
+    const __m128i t1 = _mm_shuffle_epi32(s0, 0x1B);
+    const __m128i t2 = _mm_shuffle_epi32(s1, 0xB1);
+    s0 = _mm_blend_epi16(t1, t2, 0xF0);
+    s1 = _mm_alignr_epi8(t2, t1, 0x08);
+}
+
+__m128i inline Load(const unsigned char* in)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)in), MASK);
+}
+
+void inline Save(unsigned char* out, __m128i s)
+{
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(s, MASK));
+}
+
+/** Process one 64-byte chunk on the shuffled state. */
+void inline TransformBlock(__m128i& s0, __m128i& s1, const unsigned char* chunk)
+{
+    const __m128i so0 = s0, so1 = s1;
+    __m128i m[4] = {Load(chunk), Load(chunk + 16), Load(chunk + 32), Load(chunk + 48)};
+    Rounds(s0, s1, m);
+    s0 = _mm_add_epi32(s0, so0);
+    s1 = _mm_add_epi32(s1, so1);
+}
+
+/** Hash one 64-byte input, padded as a 64-byte message, and once more for a double hash. */
+template<bool fDouble>
+void inline Hash64(unsigned char* out, const unsigned char* in)
+{
+    __m128i s0 = _mm_load_si128((const __m128i*)INIT), s1 = _mm_load_si128((const __m128i*)(INIT + 4));
+    Shuffle(s0, s1);
+    const __m128i init0 = s0, init1 = s1;
+    TransformBlock(s0, s1, in);
+    TransformBlock(s0, s1, PADDING64);
+    if (fDouble) {
+        Unshuffle(s0, s1);
+        alignas(__m128i) unsigned char buffer[64];
+        Save(buffer, s0);
+        Save(buffer + 16, s1);
+        memcpy(buffer + 32, PADDING32, 32);
+        s0 = init0;
+        s1 = init1;
+        TransformBlock(s0, s1, buffer);
+    }
+    Unshuffle(s0, s1);
+    Save(out, s0);
+    Save(out + 16, s1);
+}
+
+
+/** Process one 64-byte chunk of each of two inputs on their shuffled states. */
+void inline TransformBlock2(__m128i* s0, __m128i* s1, const unsigned char* chunka, const unsigned char* chunkb)
+{
+    const __m128i so0[2] = {s0[0], s0[1]}, so1[2] = {s1[0], s1[1]};
+    __m128i ma[4] = {Load(chunka), Load(chunka + 16), Load(chunka + 32), Load(chunka + 48)};
+    __m128i mb[4] = {Load(chunkb), Load(chunkb + 16), Load(chunkb + 32), Load(chunkb + 48)};
+    Rounds2(s0, s1, ma, mb);
+    for (int i = 0; i < 2; i++) {
+        s0[i] = _mm_add_epi32(s0[i], so0[i]);
+        s1[i] = _mm_add_epi32(s1[i], so1[i]);
+    }
+}
+
+/** Hash two consecutive 64-byte inputs, as Hash64 does for one. */
+template<bool fDouble>
+void inline Hash64_2way(unsigned char* out, const unsigned char* in)
+{
+    __m128i s0[2], s1[2];
+    s0[0] = _mm_load_si128((const __m128i*)INIT);
+    s1[0] = _mm_load_si128((const __m128i*)(INIT + 4));
+    Shuffle(s0[0], s1[0]);
+    s0[1] = s0[0];
+    s1[1] = s1[0];
+    const __m128i init0 = s0[0], init1 = s1[0];
+    TransformBlock2(s0, s1, in, in + 64);
+    TransformBlock2(s0, s1, PADDING64, PADDING64);
+    if (fDouble) {
+        alignas(__m128i) unsigned char buffer[2][64];
+        for (int i = 0; i < 2; i++) {
+            Unshuffle(s0[i], s1[i]);
+            Save(buffer[i], s0[i]);
+            Save(buffer[i] + 16, s1[i]);
+            memcpy(buffer[i] + 32, PADDING32, 32);
+            s0[i] = init0;
+            s1[i] = init1;
+        }
+        TransformBlock2(s0, s1, buffer[0], buffer[1]);
+    }
+    for (int i = 0; i < 2; i++) {
+        Unshuffle(s0[i], s1[i]);
+        Save(out + 32 * i, s0[i]);
+        Save(out + 32 * i + 16, s1[i]);
+    }
+}
+
+}
+
+namespace sha256_shani {
+void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks)
+{
+    __m128i s0 = _mm_loadu_si128((const __m128i*)s), s1 = _mm_loadu_si128((const __m128i*)(s + 4));
+    Shuffle(s0, s1);
+    while (blocks--) {
+        TransformBlock(s0, s1, chunk);
+        chunk += 64;
+    }
+    Unshuffle(s0, s1);
+    _mm_storeu_si128((__m128i*)s, s0);
+    _mm_storeu_si128((__m128i*)(s + 4), s1);
+}
+
+void TransformD64(unsigned char* out, const unsigned char* in)
+{
+    Hash64<true>(out, in);
+}
+
+void Transform64(unsigned char* out, const unsigned char* in)
+{
+    Hash64<false>(out, in);
+}
+
+void TransformD64_2way(unsigned char* out, const unsigned char* in)
+{
+    Hash64_2way<true>(out, in);
+}
+
+void Transform64_2way(unsigned char* out, const unsigned char* in)
+{
+    Hash64_2way<false>(out, in);
+}
+}
+
+#endif
@@ -17,7 +17,10 @@
 
 #include <stdint.h>
 #include <algorithm>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <openssl/sha.h>
@@ -98,6 +101,55 @@ std::string GenerateConsensusString(const uint32_t propertyId, const std::string
     return strprintf("%d|%s", propertyId, address);
 }
 
+namespace {
+/**
+ * The consensus strings of all non-empty balances, by address and property in the order they are hashed. Only the
+ * balances of addresses which changed since the last hash are formatted again, instead of copying and sorting the
+ * whole tally map. The strings are hashed one after another just as before, so the hash stays the same.
+ */
+std::map<std::string, std::vector<std::pair<uint32_t, std::string>>> balanceStrings;
+std::set<std::string> changedBalances;
+
+void UpdateBalanceStrings()
+{
+    AssertLockHeld(cs_main);
+
+    for (const std::string& address : changedBalances) {
+        std::vector<std::pair<uint32_t, std::string>> strings;
+        std::unordered_map<std::string, CMPTally>::const_iterator it = mp_tally_map.find(address);
+        if (it != mp_tally_map.end()) {
+            CMPTally tally = it->second;
+            tally.init();
+            uint32_t propertyId = 0;
+            while (0 != (propertyId = (tally.next()))) {
+                std::string dataStr = GenerateConsensusString(tally, address, propertyId);
+                if (dataStr.empty()) continue; // skip empty balances
+                strings.push_back(std::make_pair(propertyId, dataStr));
+            }
+        }
+        if (strings.empty()) {
+            balanceStrings.erase(address);
+        } else {
+            balanceStrings[address] = std::move(strings);
+        }
+    }
+    changedBalances.clear();
+}
+} // anonymous namespace
+
+void NotifyConsensusHashBalanceChanged(const std::string& address)
+{
+    LOCK(cs_main);
+    changedBalances.insert(address);
+}
+
+void ClearConsensusHashBalances()
+{
+    LOCK(cs_main);
+    balanceStrings.clear();
+    changedBalances.clear();
+}
+
 /**
  * Obtains a hash of the active state to use for consensus verification and checkpointing.
  *
@@ -157,21 +209,13 @@ uint256 GetConsensusHash()
 
     if (elysium_debug_consensus_hash) PrintToLog("Beginning generation of current consensus hash...\n");
 
-    // Balances - loop through the tally map, updating the sha context with the data from each balance and tally type
+    // Balances - loop through the balances of each address, updating the sha context with the data from each balance and tally type
     // Placeholders:  "address|propertyid|balance|selloffer_reserve|accept_reserve|metadex_reserve"
-    // Sort alphabetically first
-    std::map<std::string, CMPTally> tallyMapSorted;
-    for (std::unordered_map<string, CMPTally>::iterator uoit = mp_tally_map.begin(); uoit != mp_tally_map.end(); ++uoit) {
-        tallyMapSorted.insert(std::make_pair(uoit->first,uoit->second));
-    }
-    for (std::map<string, CMPTally>::iterator my_it = tallyMapSorted.begin(); my_it != tallyMapSorted.end(); ++my_it) {
-        const std::string& address = my_it->first;
-        CMPTally& tally = my_it->second;
-        tally.init();
-        uint32_t propertyId = 0;
-        while (0 != (propertyId = (tally.next()))) {
-            std::string dataStr = GenerateConsensusString(tally, address, propertyId);
-            if (dataStr.empty()) continue; // skip empty balances
+    // Sorted alphabetically by address, then by property ID
+    UpdateBalanceStrings();
+    for (const auto& addressStrings : balanceStrings) {
+        for (const auto& propertyString : addressStrings.second) {
+            const std::string& dataStr = propertyString.second;
             if (elysium_debug_consensus_hash) PrintToLog("Adding balance data to consensus hash: %s\n", dataStr);
             SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
         }
@@ -252,18 +296,17 @@ uint256 GetConsensusHash()
     }
 
     // Properties - loop through each property and store the issuer (to capture state changes via change issuer transactions)
-    // Note: we are loading every SP from the DB to check the issuer, if using consensus_hash_every_block debug option this
-    //       will slow things down dramatically.  Not an issue to do it once every 10,000 blocks for checkpoint verification.
+    // Note: the issuers are cached by the SP database, every SP is only loaded once after it was created or updated.
     // Placeholders: "propertyid|issueraddress"
     for (uint8_t ecosystem = 1; ecosystem <= 2; ecosystem++) {
         uint32_t startPropertyId = (ecosystem == 1) ? 1 : TEST_ECO_PROPERTY_1;
         for (uint32_t propertyId = startPropertyId; propertyId < _my_sps->peekNextSPID(ecosystem); propertyId++) {
-            CMPSPInfo::Entry sp;
-            if (!_my_sps->getSP(propertyId, sp)) {
+            std::string issuer;
+            if (!_my_sps->getIssuer(propertyId, issuer)) {
                 PrintToLog("Error loading property ID %d for consensus hashing, hash should not be trusted!\n");
                 continue;
             }
-            std::string dataStr = GenerateConsensusString(propertyId, sp.issuer);
+            std::string dataStr = GenerateConsensusString(propertyId, issuer);
             if (elysium_debug_consensus_hash) PrintToLog("Adding property to consensus hash: %s\n", dataStr);
             SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
         }
@@ -318,19 +361,11 @@ uint256 GetBalancesHash(const uint32_t hashPropertyId)
 
     LOCK(cs_main);
 
-    std::map<std::string, CMPTally> tallyMapSorted;
-    for (std::unordered_map<string, CMPTally>::iterator uoit = mp_tally_map.begin(); uoit != mp_tally_map.end(); ++uoit) {
-        tallyMapSorted.insert(std::make_pair(uoit->first,uoit->second));
-    }
-    for (std::map<string, CMPTally>::iterator my_it = tallyMapSorted.begin(); my_it != tallyMapSorted.end(); ++my_it) {
-        const std::string& address = my_it->first;
-        CMPTally& tally = my_it->second;
-        tally.init();
-        uint32_t propertyId = 0;
-        while (0 != (propertyId = (tally.next()))) {
-            if (propertyId != hashPropertyId) continue;
-            std::string dataStr = GenerateConsensusString(tally, address, propertyId);
-            if (dataStr.empty()) continue;
+    UpdateBalanceStrings();
+    for (const auto& addressStrings : balanceStrings) {
+        for (const auto& propertyString : addressStrings.second) {
+            if (propertyString.first != hashPropertyId) continue;
+            const std::string& dataStr = propertyString.second;
             if (elysium_debug_consensus_hash) PrintToLog("Adding data to balances hash: %s\n", dataStr);
             SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
         }
@@ -3,11 +3,19 @@
 
 #include "uint256.h"
 
+#include <string>
+
 namespace elysium
 {
 /** Checks if a given block should be consensus hashed. */
 bool ShouldConsensusHashBlock(int block);
 
+/** Marks the balances of an address as changed, so they are formatted again for the next consensus hash. */
+void NotifyConsensusHashBalanceChanged(const std::string& address);
+
+/** Drops the balances kept for consensus hashing, when the tally map is cleared. */
+void ClearConsensusHashBalances();
+
 /** Obtains a hash of all balances to use for consensus verification and checkpointing. */
 uint256 GetConsensusHash();
 
@@ -42,6 +42,8 @@
 #include "../script/standard.h"
 #include "../sync.h"
 #include "../tinyformat.h"
+#include "../txdb.h"
+#include "../txmempool.h"
 #include "../uint256.h"
 #include "../ui_interface.h"
 #include "../util.h"
@@ -69,10 +71,13 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <map>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -488,6 +493,9 @@ bool elysium::update_tally_map(const std::string& who, uint32_t propertyId, int6
 
     CMPTally& tally = my_it->second;
     bRet = tally.updateMoney(propertyId, amount, ttype);
+    if (bRet && ttype != PENDING) {
+        NotifyConsensusHashBalanceChanged(who);
+    }
 
     after = getMPbalance(who, propertyId, ttype);
     if (!bRet) {
@@ -632,6 +640,9 @@ CCriticalSection elysium::cs_tx_cache;
 static unsigned int nCacheHits = 0;
 static unsigned int nCacheMiss = 0;
 
+//! Outputs spent by transactions of the blocks the initial scan read ahead, guarded by cs_tx_cache
+static std::map<COutPoint, CTxOut> prefetchedInputs;
+
 /**
  * Fetches transaction inputs and adds them to the coins view cache.
  *
@@ -667,6 +678,13 @@ static bool FillTxInputCache(const CTransaction& tx)
             ++nCacheMiss;
         }
 
+        auto prefetched = prefetchedInputs.find(txIn.prevout);
+        if (prefetched != prefetchedInputs.end()) {
+            coin.out = prefetched->second;
+            view.AddCoin(txIn.prevout, std::move(coin), true);
+            continue;
+        }
+
         CTransactionRef txPrev;
         uint256 hashBlock;
         if (!GetTransaction(txIn.prevout.hash, txPrev, Params().GetConsensus(), hashBlock, true)) {
@@ -1125,6 +1143,154 @@ public:
     }
 };
 
+namespace {
+
+//! Number of blocks the initial scan reads ahead at once
+const int SCAN_BATCH_SIZE = 64;
+
+/** A block read by the initial scan, with the transactions carrying an Elysium marker flagged. */
+struct ScanBlock
+{
+    CBlockIndex* pindex = nullptr;
+    CBlock block;
+    bool fRead = false;
+    std::vector<bool> candidates;
+};
+
+/** Blocks read ahead by the initial scan and the outputs spent by their Elysium transactions. */
+struct ScanBatch
+{
+    std::vector<ScanBlock> blocks;
+    std::map<COutPoint, CTxOut> inputs;
+};
+
+/** Runs job(i) for i in [0, count) on up to nThreads threads. */
+template<typename Job>
+void RunParallel(size_t count, int nThreads, const Job& job)
+{
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            job(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nThreads && (size_t)i < count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/** Reads a transaction through the transaction index, without taking cs_main like GetTransaction() does. */
+bool ReadIndexedTransaction(const uint256& txid, CTransactionRef& tx)
+{
+    CDiskTxPos postx;
+    if (!pblocktree->ReadTxIndex(txid, postx)) {
+        return false;
+    }
+
+    CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        return false;
+    }
+
+    try {
+        CBlockHeader header;
+        file >> header;
+        fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
+        file >> tx;
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    return tx->GetHash() == txid;
+}
+
+/**
+ * Reads the given blocks in parallel and flags the transactions with an Elysium class B or C marker. The outputs the
+ * flagged transactions spend are then looked up in the batch itself or read through the transaction index, so that
+ * parsing them doesn't have to go to the disk one input at a time. Inputs which can't be found here are left to
+ * FillTxInputCache().
+ */
+ScanBatch ReadScanBatch(std::vector<CBlockIndex*> indexes, int nThreads)
+{
+    ScanBatch batch;
+    batch.blocks.resize(indexes.size());
+
+    RunParallel(indexes.size(), nThreads, [&](size_t i) {
+        ScanBlock& scanBlock = batch.blocks[i];
+        scanBlock.pindex = indexes[i];
+        if (ShutdownRequested() || !ReadBlockFromDisk(scanBlock.block, scanBlock.pindex, Params().GetConsensus())) {
+            return;
+        }
+        scanBlock.fRead = true;
+        scanBlock.candidates.reserve(scanBlock.block.vtx.size());
+        for (const auto& tx : scanBlock.block.vtx) {
+            scanBlock.candidates.push_back(bool(DeterminePacketClass(*tx, scanBlock.pindex->nHeight)));
+        }
+    });
+
+    std::unordered_map<uint256, CTransactionRef, SaltedTxidHasher> batchTxs;
+    std::set<COutPoint> prevouts;
+    for (const ScanBlock& scanBlock : batch.blocks) {
+        if (!scanBlock.fRead) {
+            break;
+        }
+        for (size_t i = 0; i < scanBlock.block.vtx.size(); ++i) {
+            const CTransaction& tx = *scanBlock.block.vtx[i];
+            batchTxs.emplace(tx.GetHash(), scanBlock.block.vtx[i]);
+            if (!scanBlock.candidates[i] || tx.IsCoinBase()) {
+                continue;
+            }
+            for (const CTxIn& txIn : tx.vin) {
+                if (!txIn.scriptSig.IsSigmaSpend()) {
+                    prevouts.insert(txIn.prevout);
+                }
+            }
+        }
+    }
+
+    std::vector<uint256> txids;
+    for (const COutPoint& prevout : prevouts) {
+        auto it = batchTxs.find(prevout.hash);
+        if (it != batchTxs.end()) {
+            if (prevout.n < it->second->vout.size()) {
+                batch.inputs.emplace(prevout, it->second->vout[prevout.n]);
+            }
+        } else if (txids.empty() || txids.back() != prevout.hash) {
+            txids.push_back(prevout.hash);
+        }
+    }
+
+    if (fTxIndex && !txids.empty()) {
+        std::vector<CTransactionRef> txs(txids.size());
+        RunParallel(txids.size(), nThreads, [&](size_t i) {
+            if (!ReadIndexedTransaction(txids[i], txs[i])) {
+                txs[i] = nullptr;
+            }
+        });
+
+        for (const COutPoint& prevout : prevouts) {
+            auto it = std::lower_bound(txids.begin(), txids.end(), prevout.hash);
+            if (it == txids.end() || *it != prevout.hash) {
+                continue;
+            }
+            const CTransactionRef& tx = txs[it - txids.begin()];
+            if (tx && prevout.n < tx->vout.size()) {
+                batch.inputs.emplace(prevout, tx->vout[prevout.n]);
+            }
+        }
+    }
+
+    return batch;
+}
+
+} // namespace
+
 /**
  * Scans the blockchain for meta transactions.
  *
@@ -1133,6 +1299,10 @@ public:
  *
  * Every 30 seconds the progress of the scan is reported.
  *
+ * Blocks are read ahead in batches on -elysiumscanthreads threads, which also
+ * skip the transactions without an Elysium marker and fetch the inputs of the
+ * others. The blocks are still handled one after the other in chain order.
+ *
  * In case the current block being processed is not part of the active chain, or
  * if a block could not be retrieved from the disk, then the scan stops early.
  * Likewise, global shutdown requests are honored, and stop the scan progress.
@@ -1159,48 +1329,94 @@ static int elysium_initial_scan(int nFirstBlock)
     // used to print the progress to the console and notifies the UI
     ProgressReporter progressReporter(chainActive[nFirstBlock], chainActive[nLastBlock]);
 
-    for (nBlock = nFirstBlock; nBlock <= nLastBlock; ++nBlock)
-    {
-        if (ShutdownRequested()) {
-            PrintToLog("Shutdown requested, stop scan at block %d of %d\n", nBlock, nLastBlock);
-            break;
+    int nThreads = GetArg("-elysiumscanthreads", 0);
+    if (nThreads <= 0) {
+        nThreads = GetNumCores();
+    }
+
+    // the next blocks are read and prefiltered in the background while the current ones are parsed
+    auto readBatch = [&](int nFrom) {
+        std::vector<CBlockIndex*> indexes;
+        {
+            LOCK(cs_main);
+            for (int n = nFrom; n <= nLastBlock && n < nFrom + SCAN_BATCH_SIZE && chainActive[n]; ++n) {
+                indexes.push_back(chainActive[n]);
+            }
         }
+        return std::async(std::launch::async, ReadScanBatch, std::move(indexes), nThreads);
+    };
 
-        CBlockIndex* pblockindex = chainActive[nBlock];
-        if (NULL == pblockindex) break;
-        std::string strBlockHash = pblockindex->GetBlockHash().GetHex();
+    std::future<ScanBatch> nextBatch = readBatch(nFirstBlock);
+    bool fStop = false;
 
-        if (elysium_debug_ely) PrintToLog("%s(%d; max=%d):%s, line %d, file: %s\n",
-            __FUNCTION__, nBlock, nLastBlock, strBlockHash, __LINE__, __FILE__);
+    for (nBlock = nFirstBlock; !fStop && nBlock <= nLastBlock; )
+    {
+        ScanBatch batch = nextBatch.get();
+        if (batch.blocks.empty()) break;
 
-        if (GetTime() >= nNow + nTimeBetweenProgressReports) {
-            progressReporter.update(pblockindex);
-            nNow = GetTime();
+        int nNextBatch = nBlock + batch.blocks.size();
+        if (nNextBatch <= nLastBlock) {
+            nextBatch = readBatch(nNextBatch);
         }
 
-        // Get block to parse.
-        CBlock block;
-
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
-            break;
+        {
+            LOCK(cs_tx_cache);
+            prefetchedInputs = std::move(batch.inputs);
         }
 
-        // Parse block.
-        unsigned parsed = 0;
+        for (const ScanBlock& scanBlock : batch.blocks)
+        {
+            if (ShutdownRequested()) {
+                PrintToLog("Shutdown requested, stop scan at block %d of %d\n", nBlock, nLastBlock);
+                fStop = true;
+                break;
+            }
+
+            CBlockIndex* pblockindex = scanBlock.pindex;
+            std::string strBlockHash = pblockindex->GetBlockHash().GetHex();
 
-        elysium_handler_block_begin(nBlock, pblockindex);
+            if (elysium_debug_ely) PrintToLog("%s(%d; max=%d):%s, line %d, file: %s\n",
+                __FUNCTION__, nBlock, nLastBlock, strBlockHash, __LINE__, __FILE__);
 
-        for (unsigned i = 0; i < block.vtx.size(); i++) {
-            if (elysium_handler_tx(*block.vtx[i], nBlock, i, pblockindex)) {
-                parsed++;
+            if (GetTime() >= nNow + nTimeBetweenProgressReports) {
+                progressReporter.update(pblockindex);
+                nNow = GetTime();
             }
-        }
 
-        elysium_handler_block_end(nBlock, pblockindex, parsed);
+            // Block to parse, failed to be read.
+            if (!scanBlock.fRead) {
+                fStop = true;
+                break;
+            }
 
-        // Sum total parsed.
-        nTxsFoundTotal += parsed;
-        nTxsTotal += block.vtx.size();
+            const CBlock& block = scanBlock.block;
+
+            // Parse block.
+            unsigned parsed = 0;
+
+            elysium_handler_block_begin(nBlock, pblockindex);
+
+            for (unsigned i = 0; i < block.vtx.size(); i++) {
+                if (!scanBlock.candidates[i]) {
+                    // without a marker the transaction isn't parsed, only a pending entry of it is cleared
+                    PendingDelete(block.vtx[i]->GetHash());
+                } else if (elysium_handler_tx(*block.vtx[i], nBlock, i, pblockindex)) {
+                    parsed++;
+                }
+            }
+
+            elysium_handler_block_end(nBlock, pblockindex, parsed);
+
+            // Sum total parsed.
+            nTxsFoundTotal += parsed;
+            nTxsTotal += block.vtx.size();
+            ++nBlock;
+        }
+    }
+
+    {
+        LOCK(cs_tx_cache);
+        prefetchedInputs.clear();
     }
 
     if (nBlock < nLastBlock) {
@@ -1432,6 +1648,7 @@ static int elysium_file_load(const string &filename, int what, bool verifyHash =
   {
     case FILETYPE_BALANCES:
       mp_tally_map.clear();
+      ClearConsensusHashBalances();
       inputLineFunc = input_elysium_balances_string;
       break;
 
@@ -1918,6 +2135,7 @@ void clear_all_state()
 
     // Memory based storage
     mp_tally_map.clear();
+    ClearConsensusHashBalances();
     my_offers.clear();
     my_accepts.clear();
     my_crowds.clear();
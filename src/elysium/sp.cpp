@@ -103,6 +103,17 @@ void CMPSPInfo::init(uint32_t nextSPID, uint32_t nextTestSPID)
 {
     next_spid = nextSPID;
     next_test_spid = nextTestSPID;
+    clearIssuers();
+}
+
+void CMPSPInfo::clearIssuers(uint32_t propertyId)
+{
+    LOCK(cs_issuers);
+    if (propertyId == 0) {
+        issuers.clear();
+    } else {
+        issuers.erase(propertyId);
+    }
 }
 
 uint32_t CMPSPInfo::peekNextSPID(uint8_t ecosystem) const
@@ -156,6 +167,7 @@ bool CMPSPInfo::updateSP(uint32_t propertyId, const Entry& info)
     }
     batch.Put(slSpKey, slSpValue);
     leveldb::Status status = pdb->Write(syncoptions, &batch);
+    clearIssuers(propertyId);
 
     if (!status.ok()) {
         PrintToLog("%s(): ERROR for SP %d: %s\n", __func__, propertyId, status.ToString());
@@ -216,6 +228,7 @@ uint32_t CMPSPInfo::putSP(uint8_t ecosystem, const Entry& info)
     batch.Put(slTxIndexKey, slTxValue);
 
     leveldb::Status status = pdb->Write(syncoptions, &batch);
+    clearIssuers(propertyId);
 
     if (!status.ok()) {
         PrintToLog("%s(): ERROR for SP %d: %s\n", __func__, propertyId, status.ToString());
@@ -261,6 +274,21 @@ bool CMPSPInfo::getSP(uint32_t propertyId, Entry& info) const
     return true;
 }
 
+bool CMPSPInfo::getIssuer(uint32_t propertyId, std::string& issuer) const
+{
+    LOCK(cs_issuers);
+    std::map<uint32_t, std::string>::const_iterator it = issuers.find(propertyId);
+    if (it == issuers.end()) {
+        Entry info;
+        if (!getSP(propertyId, info)) {
+            return false;
+        }
+        it = issuers.insert(std::make_pair(propertyId, info.issuer)).first;
+    }
+    issuer = it->second;
+    return true;
+}
+
 bool CMPSPInfo::hasSP(uint32_t propertyId) const
 {
     // Special cases for constant SPs MSC and TMSC
@@ -378,6 +406,7 @@ int64_t CMPSPInfo::popBlock(const uint256& block_hash)
     delete iter;
 
     leveldb::Status status = pdb->Write(syncoptions, &commitBatch);
+    clearIssuers();
 
     if (!status.ok()) {
         PrintToLog("%s(): ERROR: %s\n", __func__, status.ToString());
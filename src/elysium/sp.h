@@ -169,6 +169,12 @@ private:
     uint32_t next_spid;
     uint32_t next_test_spid;
 
+    // issuers of the properties, as every consensus hash asks for all of them, dropped when a property is written
+    mutable CCriticalSection cs_issuers;
+    mutable std::map<uint32_t, std::string> issuers;
+
+    void clearIssuers(uint32_t propertyId = 0); // all of them for 0
+
 public:
     CMPSPInfo(const boost::filesystem::path& path, bool fWipe);
     virtual ~CMPSPInfo();
@@ -182,6 +188,7 @@ public:
     bool updateSP(uint32_t propertyId, const Entry& info);
     uint32_t putSP(uint8_t ecosystem, const Entry& info);
     bool getSP(uint32_t propertyId, Entry& info) const;
+    bool getIssuer(uint32_t propertyId, std::string& issuer) const;
     bool hasSP(uint32_t propertyId) const;
     uint32_t findSPByTX(const uint256& txid) const;
 
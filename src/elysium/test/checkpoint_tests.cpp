@@ -13,7 +13,10 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <openssl/sha.h>
+
 #include <stdint.h>
+#include <map>
 #include <string>
 
 namespace elysium
@@ -98,4 +101,52 @@ BOOST_AUTO_TEST_CASE(consensus_string_property_issuer)
             GenerateConsensusString(5, "3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b"));
 }
 
+// Hashes the balances of a property the way it was done before the balance strings were kept between hashes
+static uint256 CalculateBalancesHash(uint32_t hashPropertyId)
+{
+    SHA256_CTX shaCtx;
+    SHA256_Init(&shaCtx);
+
+    LOCK(cs_main);
+    std::map<std::string, CMPTally> tallyMapSorted(mp_tally_map.begin(), mp_tally_map.end());
+    for (auto& p : tallyMapSorted) {
+        CMPTally& tally = p.second;
+        tally.init();
+        uint32_t propertyId = 0;
+        while (0 != (propertyId = tally.next())) {
+            if (propertyId != hashPropertyId) continue;
+            std::string dataStr = GenerateConsensusString(tally, p.first, propertyId);
+            SHA256_Update(&shaCtx, dataStr.c_str(), dataStr.length());
+        }
+    }
+
+    uint256 balancesHash;
+    SHA256_Final((unsigned char*)&balancesHash, &shaCtx);
+    return balancesHash;
+}
+
+BOOST_AUTO_TEST_CASE(consensus_hash_balances_updated)
+{
+    const uint32_t propertyId = 77;
+    const std::string addressA = "3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b";
+    const std::string addressB = "1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj";
+
+    BOOST_CHECK(update_tally_map(addressB, propertyId, 500, BALANCE));
+    BOOST_CHECK(update_tally_map(addressA, propertyId, 100, BALANCE));
+    BOOST_CHECK(update_tally_map(addressA, propertyId + 1, 100, BALANCE));
+    BOOST_CHECK(GetBalancesHash(propertyId) == CalculateBalancesHash(propertyId));
+    BOOST_CHECK(GetBalancesHash(propertyId + 1) == CalculateBalancesHash(propertyId + 1));
+
+    // reserves and balances which become empty change the hash as well
+    BOOST_CHECK(update_tally_map(addressA, propertyId, -40, BALANCE));
+    BOOST_CHECK(update_tally_map(addressA, propertyId, 40, METADEX_RESERVE));
+    BOOST_CHECK(update_tally_map(addressB, propertyId, -500, BALANCE));
+    BOOST_CHECK(GetBalancesHash(propertyId) == CalculateBalancesHash(propertyId));
+
+    // pending amounts are not part of the hash
+    uint256 balancesHash = GetBalancesHash(propertyId);
+    BOOST_CHECK(update_tally_map(addressB, propertyId, 10, PENDING));
+    BOOST_CHECK(GetBalancesHash(propertyId) == balancesHash);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
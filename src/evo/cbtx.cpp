@@ -104,7 +104,6 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
 
     static int64_t nTimeDMN = 0;
     static int64_t nTimeSMNL = 0;
-    static int64_t nTimeMerkle = 0;
 
     int64_t nTime1 = GetTimeMicros();
 
@@ -116,31 +115,25 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
     int64_t nTime2 = GetTimeMicros(); nTimeDMN += nTime2 - nTime1;
     LogPrint("bench", "            - BuildNewListFromBlock: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimeDMN * 0.000001);
 
-    CSimplifiedMNList sml(tmpMNList);
-
-    int64_t nTime3 = GetTimeMicros(); nTimeSMNL += nTime3 - nTime2;
-    LogPrint("bench", "            - CSimplifiedMNList: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeSMNL * 0.000001);
-
-    static CSimplifiedMNList smlCached;
-    static uint256 merkleRootCached;
-    static bool mutatedCached{false};
-
-    if (sml.mnList == smlCached.mnList) {
-        merkleRootRet = merkleRootCached;
-        return !mutatedCached;
+    // Connected blocks had their simplified list cached by CDeterministicMNManager::ProcessBlock. For others, like
+    // block templates, it's built from the cached list of the previous block, only hashing the entries of the MNs
+    // changed by this block. It is not cached, as the hash of such a block isn't final.
+    auto sml = simplifiedMNListCache.GetSnapshot(block.GetHash());
+    if (!sml) {
+        auto prevMNList = deterministicMNManager->GetListForBlock(pindexPrev);
+        auto smlPrev = simplifiedMNListCache.GetSnapshot(pindexPrev->GetBlockHash());
+        if (!smlPrev) {
+            smlPrev = std::make_shared<CSimplifiedMNListSnapshot>(prevMNList);
+            simplifiedMNListCache.AddSnapshot(pindexPrev->GetBlockHash(), smlPrev);
+        }
+        sml = std::make_shared<CSimplifiedMNListSnapshot>(*smlPrev, prevMNList, tmpMNList, prevMNList.BuildDiff(tmpMNList));
     }
 
-    bool mutated = false;
-    merkleRootRet = sml.CalcMerkleRoot(&mutated);
-
-    int64_t nTime4 = GetTimeMicros(); nTimeMerkle += nTime4 - nTime3;
-    LogPrint("bench", "            - CalcMerkleRoot: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeMerkle * 0.000001);
-
-    smlCached = std::move(sml);
-    merkleRootCached = merkleRootRet;
-    mutatedCached = mutated;
+    int64_t nTime3 = GetTimeMicros(); nTimeSMNL += nTime3 - nTime2;
+    LogPrint("bench", "            - CSimplifiedMNListSnapshot: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeSMNL * 0.000001);
 
-    return !mutated;
+    merkleRootRet = sml->merkleRoot;
+    return !sml->mutated;
 }
 
 bool CalcCbTxMerkleRootQuorums(const CBlock& block, const CBlockIndex* pindexPrev, uint256& merkleRootRet, CValidationState& state)
@@ -223,7 +216,7 @@ bool CalcCbTxMerkleRootQuorums(const CBlock& block, const CBlockIndex* pindexPre
     LogPrint("bench", "            - Loop: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeLoop * 0.000001);
 
     bool mutated = false;
-    merkleRootRet = ComputeMerkleRoot(qcHashesVec, &mutated);
+    merkleRootRet = ComputeMerkleRoot(std::move(qcHashesVec), &mutated);
 
     int64_t nTime5 = GetTimeMicros(); nTimeMerkle += nTime5 - nTime4;
     LogPrint("bench", "            - ComputeMerkleRoot: %.2fms [%.2fs]\n", 0.001 * (nTime5 - nTime4), nTimeMerkle * 0.000001);
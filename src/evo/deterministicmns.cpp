@@ -8,6 +8,7 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "core_io.h"
+#include "crypto/sha256.h"
 #include "script/standard.h"
 #include "ui_interface.h"
 #include "validation.h"
@@ -278,27 +279,38 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t m
 
 std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CDeterministicMNList::CalculateScores(const uint256& modifier) const
 {
-    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
-    scores.reserve(GetAllMNsCount());
+    std::vector<CDeterministicMNCPtr> mns;
+    mns.reserve(GetAllMNsCount());
     ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
         if (dmn->pdmnState->confirmedHash.IsNull()) {
             // we only take confirmed MNs into account to avoid hash grinding on the ProRegTxHash to sneak MNs into a
             // future quorums
             return;
         }
-        // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
-        // Please note that this is not a double-sha256 but a single-sha256
-        // The first part is already precalculated (confirmedHashWithProRegTxHash)
-        // TODO When https://github.com/bitcoin/bitcoin/pull/13191 gets backported, implement something that is similar but for single-sha256
-        uint256 h;
-        CSHA256 sha256;
-        sha256.Write(dmn->pdmnState->confirmedHashWithProRegTxHash.begin(), dmn->pdmnState->confirmedHashWithProRegTxHash.size());
-        sha256.Write(modifier.begin(), modifier.size());
-        sha256.Finalize(h.begin());
-
-        scores.emplace_back(UintToArith256(h), dmn);
+        mns.emplace_back(dmn);
     });
 
+    // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
+    // Please note that this is not a double-sha256 but a single-sha256
+    // The first part is already precalculated (confirmedHashWithProRegTxHash), so every MN hashes one 64-byte
+    // blob and all of them are hashed in one batch
+    std::vector<unsigned char> blobs(mns.size() * 64);
+    for (size_t i = 0; i < mns.size(); i++) {
+        const uint256& h = mns[i]->pdmnState->confirmedHashWithProRegTxHash;
+        memcpy(&blobs[i * 64], h.begin(), h.size());
+        memcpy(&blobs[i * 64 + 32], modifier.begin(), modifier.size());
+    }
+    std::vector<uint256> hashes(mns.size());
+    if (!mns.empty()) {
+        SHA256_64(hashes[0].begin(), blobs.data(), mns.size());
+    }
+
+    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
+    scores.reserve(mns.size());
+    for (size_t i = 0; i < mns.size(); i++) {
+        scores.emplace_back(UintToArith256(hashes[i]), std::move(mns[i]));
+    }
+
     return scores;
 }
 
@@ -414,6 +426,33 @@ CSimplifiedMNListDiff CDeterministicMNList::BuildSimplifiedDiff(const CDetermini
     return diffRet;
 }
 
+CSimplifiedMNListDiff CDeterministicMNList::BuildSimplifiedDiff(const CDeterministicMNList& to, const std::set<uint64_t>& internalIds) const
+{
+    CSimplifiedMNListDiff diffRet;
+    diffRet.baseBlockHash = blockHash;
+    diffRet.blockHash = to.blockHash;
+
+    for (const auto& internalId : internalIds) {
+        auto fromPtr = GetMNByInternalId(internalId);
+        auto toPtr = to.GetMNByInternalId(internalId);
+        if (toPtr == nullptr) {
+            if (fromPtr != nullptr) {
+                diffRet.deletedMNs.emplace_back(fromPtr->proTxHash);
+            }
+        } else if (fromPtr == nullptr) {
+            diffRet.mnList.emplace_back(*toPtr);
+        } else {
+            CSimplifiedMNListEntry sme1(*toPtr);
+            CSimplifiedMNListEntry sme2(*fromPtr);
+            if (sme1 != sme2) {
+                diffRet.mnList.emplace_back(*toPtr);
+            }
+        }
+    }
+
+    return diffRet;
+}
+
 CDeterministicMNList CDeterministicMNList::ApplyDiff(const CBlockIndex* pindex, const CDeterministicMNListDiff& diff) const
 {
     CDeterministicMNList result = *this;
@@ -539,6 +578,14 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         diff = oldList.BuildDiff(newList);
 
         evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
+
+        // the simplified list of the connected block, for the cbTx merkle root check and the next block
+        auto smlPrev = simplifiedMNListCache.GetSnapshot(pindex->pprev->GetBlockHash());
+        if (smlPrev) {
+            simplifiedMNListCache.AddSnapshot(newList.GetBlockHash(), std::make_shared<CSimplifiedMNListSnapshot>(*smlPrev, oldList, newList, diff));
+        } else {
+            simplifiedMNListCache.AddSnapshot(newList.GetBlockHash(), std::make_shared<CSimplifiedMNListSnapshot>(newList));
+        }
         if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0 || oldList.GetHeight() == -1) {
             evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
             LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
@@ -591,6 +638,8 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
         mnListsCache.erase(blockHash);
     }
 
+    simplifiedMNListCache.ClearDiffs();
+
     if (diff.HasChanges()) {
         auto inversedDiff = curList.BuildDiff(prevList);
         GetMainSignals().NotifyMasternodeListChanged(true, curList, inversedDiff);
@@ -959,6 +1008,31 @@ CDeterministicMNList CDeterministicMNManager::GetListAtChainTip()
     return GetListForBlock(tipIndex);
 }
 
+bool CDeterministicMNManager::GetChangedMNs(const CBlockIndex* pindexBase, const CBlockIndex* pindex, int maxBlocks, std::set<uint64_t>& internalIdsRet)
+{
+    if (pindex->nHeight - pindexBase->nHeight > maxBlocks) {
+        return false;
+    }
+
+    LOCK(cs);
+
+    for (; pindex != pindexBase; pindex = pindex->pprev) {
+        CDeterministicMNListDiff diff;
+        if (pindex->nHeight <= pindexBase->nHeight || !evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
+            return false;
+        }
+        for (const auto& dmn : diff.addedMNs) {
+            internalIdsRet.emplace(dmn->internalId);
+        }
+        for (const auto& p : diff.updatedMNs) {
+            internalIdsRet.emplace(p.first);
+        }
+        internalIdsRet.insert(diff.removedMns.begin(), diff.removedMns.end());
+    }
+
+    return true;
+}
+
 bool CDeterministicMNManager::IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n)
 {
     if (tx->nVersion != 3 || tx->nType != TRANSACTION_PROVIDER_REGISTER) {
@@ -466,6 +466,8 @@ public:
 
     CDeterministicMNListDiff BuildDiff(const CDeterministicMNList& to) const;
     CSimplifiedMNListDiff BuildSimplifiedDiff(const CDeterministicMNList& to) const;
+    // same diff, only looking at the given MNs, which must include all MNs that differ between both lists
+    CSimplifiedMNListDiff BuildSimplifiedDiff(const CDeterministicMNList& to, const std::set<uint64_t>& internalIds) const;
     CDeterministicMNList ApplyDiff(const CBlockIndex* pindex, const CDeterministicMNListDiff& diff) const;
 
     void AddMN(const CDeterministicMNCPtr& dmn);
@@ -653,6 +655,10 @@ public:
     CDeterministicMNList GetListForBlock(const CBlockIndex* pindex);
     CDeterministicMNList GetListAtChainTip();
 
+    // Collects the internalIds of all MNs added, updated or removed by the blocks after pindexBase up to pindex, from
+    // the diffs stored for these blocks. Fails if there are more than maxBlocks of them or one has no diff stored.
+    bool GetChangedMNs(const CBlockIndex* pindexBase, const CBlockIndex* pindex, int maxBlocks, std::set<uint64_t>& internalIdsRet);
+
     // Test if given TX is a ProRegTx which also contains the collateral at index n
     bool IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n);
 
@@ -14,6 +14,7 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "consensus/merkle.h"
+#include "hash.h"
 #include "univalue.h"
 #include "validation.h"
 
@@ -85,7 +86,45 @@ uint256 CSimplifiedMNList::CalcMerkleRoot(bool* pmutated) const
     for (const auto& e : mnList) {
         leaves.emplace_back(e->CalcHash());
     }
-    return ComputeMerkleRoot(leaves, pmutated);
+    return ComputeMerkleRoot(std::move(leaves), pmutated);
+}
+
+CSimplifiedMNListSnapshot::CSimplifiedMNListSnapshot(const CDeterministicMNList& dmnList)
+{
+    dmnList.ForEachMN(false, [this](const CDeterministicMNCPtr& dmn) {
+        entryHashes.emplace(dmn->proTxHash, CSimplifiedMNListEntry(*dmn).CalcHash());
+    });
+    CalcMerkleRoot();
+}
+
+CSimplifiedMNListSnapshot::CSimplifiedMNListSnapshot(const CSimplifiedMNListSnapshot& from, const CDeterministicMNList& fromList, const CDeterministicMNList& toList, const CDeterministicMNListDiff& diff) :
+    entryHashes(from.entryHashes)
+{
+    for (const auto& internalId : diff.removedMns) {
+        auto dmn = fromList.GetMNByInternalId(internalId);
+        assert(dmn);
+        entryHashes.erase(dmn->proTxHash);
+    }
+    for (const auto& dmn : diff.addedMNs) {
+        entryHashes[dmn->proTxHash] = CSimplifiedMNListEntry(*dmn).CalcHash();
+    }
+    for (const auto& p : diff.updatedMNs) {
+        auto dmn = toList.GetMNByInternalId(p.first);
+        assert(dmn);
+        entryHashes[dmn->proTxHash] = CSimplifiedMNListEntry(*dmn).CalcHash();
+    }
+    CalcMerkleRoot();
+}
+
+void CSimplifiedMNListSnapshot::CalcMerkleRoot()
+{
+    // the map is ordered by proRegTxHash, just like the entries of CSimplifiedMNList
+    std::vector<uint256> leaves;
+    leaves.reserve(entryHashes.size());
+    for (const auto& p : entryHashes) {
+        leaves.emplace_back(p.second);
+    }
+    merkleRoot = ComputeMerkleRoot(std::move(leaves), &mutated);
 }
 
 CSimplifiedMNListDiff::CSimplifiedMNListDiff()
@@ -185,9 +224,76 @@ void CSimplifiedMNListDiff::ToJson(UniValue& obj) const
     }
 }
 
+// longest range of blocks for which mnlistdiffs are built from the stored diffs of the deterministic MN list
+static const int MAX_CHANGED_MNS_BLOCKS = 576;
+
+CSimplifiedMNListCache simplifiedMNListCache;
+
+CSimplifiedMNListSnapshotCPtr CSimplifiedMNListCache::GetSnapshot(const uint256& blockHash)
+{
+    LOCK(cs);
+    CSimplifiedMNListSnapshotCPtr snapshot;
+    snapshots.get(blockHash, snapshot);
+    return snapshot;
+}
+
+void CSimplifiedMNListCache::AddSnapshot(const uint256& blockHash, const CSimplifiedMNListSnapshotCPtr& snapshot)
+{
+    LOCK(cs);
+    snapshots.insert(blockHash, snapshot);
+}
+
+bool CSimplifiedMNListCache::GetCbTx(const uint256& blockHash, CTransactionRef& cbTxRet, CPartialMerkleTree& cbTxMerkleTreeRet)
+{
+    LOCK(cs);
+    std::pair<CTransactionRef, CPartialMerkleTree> p;
+    if (!cbTxs.get(blockHash, p)) {
+        return false;
+    }
+    cbTxRet = std::move(p.first);
+    cbTxMerkleTreeRet = std::move(p.second);
+    return true;
+}
+
+void CSimplifiedMNListCache::AddCbTx(const uint256& blockHash, const CTransactionRef& cbTx, const CPartialMerkleTree& cbTxMerkleTree)
+{
+    LOCK(cs);
+    cbTxs.insert(blockHash, std::make_pair(cbTx, cbTxMerkleTree));
+}
+
+CSimplifiedMNListCache::CDiffCPtr CSimplifiedMNListCache::GetDiff(const uint256& baseBlockHash, const uint256& blockHash)
+{
+    auto key = ::SerializeHash(std::make_pair(baseBlockHash, blockHash));
+    LOCK(cs);
+    CDiffCPtr diff;
+    diffs.get(key, diff);
+    return diff;
+}
+
+void CSimplifiedMNListCache::AddDiff(const CDiffCPtr& diff)
+{
+    auto key = ::SerializeHash(std::make_pair(diff->baseBlockHash, diff->blockHash));
+    LOCK(cs);
+    diffs.insert(key, diff);
+}
+
+void CSimplifiedMNListCache::ClearDiffs()
+{
+    LOCK(cs);
+    diffs.clear();
+}
+
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet, std::string& errorRet)
 {
-    AssertLockHeld(cs_main);
+    // a diff between two blocks of the active chain stays the same until one of them is disconnected, so the ones
+    // asked for recently are served from the cache without taking cs_main
+    auto cachedDiff = simplifiedMNListCache.GetDiff(baseBlockHash, blockHash);
+    if (cachedDiff) {
+        mnListDiffRet = *cachedDiff;
+        return true;
+    }
+
+    LOCK(cs_main);
     mnListDiffRet = CSimplifiedMNListDiff();
 
     const CBlockIndex* baseBlockIndex = chainActive.Genesis();
@@ -219,7 +325,14 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
 
     auto baseDmnList = deterministicMNManager->GetListForBlock(baseBlockIndex);
     auto dmnList = deterministicMNManager->GetListForBlock(blockIndex);
-    mnListDiffRet = baseDmnList.BuildSimplifiedDiff(dmnList);
+    // Only the MNs which the blocks in between changed can differ, and the diffs stored for these blocks tell which
+    // ones these are. For long ranges, reading all of them is more expensive than comparing all MNs.
+    std::set<uint64_t> changedMNs;
+    if (deterministicMNManager->GetChangedMNs(baseBlockIndex, blockIndex, MAX_CHANGED_MNS_BLOCKS, changedMNs)) {
+        mnListDiffRet = baseDmnList.BuildSimplifiedDiff(dmnList, changedMNs);
+    } else {
+        mnListDiffRet = baseDmnList.BuildSimplifiedDiff(dmnList);
+    }
 
     // We need to return the value that was provided by the other peer as it otherwise won't be able to recognize the
     // response. This will usually be identical to the block found in baseBlockIndex. The only difference is when a
@@ -231,22 +344,28 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
         return false;
     }
 
-    // TODO store coinbase TX in CBlockIndex
-    CBlock block;
-    if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
-        errorRet = strprintf("failed to read block %s from disk", blockHash.ToString());
-        return false;
-    }
+    if (!simplifiedMNListCache.GetCbTx(blockHash, mnListDiffRet.cbTx, mnListDiffRet.cbTxMerkleTree)) {
+        // TODO store coinbase TX in CBlockIndex
+        CBlock block;
+        if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
+            errorRet = strprintf("failed to read block %s from disk", blockHash.ToString());
+            return false;
+        }
 
-    mnListDiffRet.cbTx = block.vtx[0];
+        mnListDiffRet.cbTx = block.vtx[0];
 
-    std::vector<uint256> vHashes;
-    std::vector<bool> vMatch(block.vtx.size(), false);
-    for (const auto& tx : block.vtx) {
-        vHashes.emplace_back(tx->GetHash());
+        std::vector<uint256> vHashes;
+        std::vector<bool> vMatch(block.vtx.size(), false);
+        for (const auto& tx : block.vtx) {
+            vHashes.emplace_back(tx->GetHash());
+        }
+        vMatch[0] = true; // only coinbase matches
+        mnListDiffRet.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
+
+        simplifiedMNListCache.AddCbTx(blockHash, mnListDiffRet.cbTx, mnListDiffRet.cbTxMerkleTree);
     }
-    vMatch[0] = true; // only coinbase matches
-    mnListDiffRet.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
+
+    simplifiedMNListCache.AddDiff(std::make_shared<const CSimplifiedMNListDiff>(mnListDiffRet));
 
     return true;
 }
@@ -9,11 +9,18 @@
 #include "merkleblock.h"
 #include "netaddress.h"
 #include "pubkey.h"
+#include "saltedhasher.h"
 #include "serialize.h"
+#include "sync.h"
+#include "unordered_lru_cache.h"
 #include "version.h"
 
+#include <map>
+#include <memory>
+
 class UniValue;
 class CDeterministicMNList;
+class CDeterministicMNListDiff;
 class CDeterministicMN;
 
 namespace llmq
@@ -84,6 +91,28 @@ public:
     uint256 CalcMerkleRoot(bool* pmutated = NULL) const;
 };
 
+/**
+ * The simplified MN list of a block, kept as the hashes of its entries by proRegTxHash. These are the leaves of the
+ * tree merkleRootMNList commits to, so the list of the next block only has to hash the entries of the MNs which that
+ * block changed.
+ */
+class CSimplifiedMNListSnapshot
+{
+public:
+    std::map<uint256, uint256> entryHashes;
+    uint256 merkleRoot;
+    bool mutated{false};
+
+public:
+    explicit CSimplifiedMNListSnapshot(const CDeterministicMNList& dmnList);
+    // snapshot of toList, from the snapshot of fromList and the diff between both lists
+    CSimplifiedMNListSnapshot(const CSimplifiedMNListSnapshot& from, const CDeterministicMNList& fromList, const CDeterministicMNList& toList, const CDeterministicMNListDiff& diff);
+
+private:
+    void CalcMerkleRoot();
+};
+typedef std::shared_ptr<const CSimplifiedMNListSnapshot> CSimplifiedMNListSnapshotCPtr;
+
 /// P2P messages
 
 class CGetSimplifiedMNListDiff
@@ -145,6 +174,48 @@ public:
     void ToJson(UniValue& obj) const;
 };
 
+/**
+ * The cbTx merkle root of every block is calculated at least twice, when mining and when connecting it, and SPV clients
+ * ask for mnlistdiffs against the same few base blocks over and over again. This keeps the simplified lists and the
+ * coinbase proofs of recent blocks, which only depend on their block, and the most recently built mnlistdiffs. A diff
+ * is only valid as long as both of its blocks are in the active chain, so all diffs are dropped when a block is
+ * disconnected. Diffs are added and dropped while holding cs_main, but can be looked up without it.
+ */
+class CSimplifiedMNListCache
+{
+public:
+    static const size_t MAX_SNAPSHOTS = 16;
+    static const size_t MAX_BLOCKS = 128;
+    static const size_t MAX_DIFFS = 128;
+
+    typedef std::shared_ptr<const CSimplifiedMNListDiff> CDiffCPtr;
+
+private:
+    mutable CCriticalSection cs;
+    unordered_lru_cache<uint256, CSimplifiedMNListSnapshotCPtr, StaticSaltedHasher> snapshots;
+    // coinbase of a block and the partial merkle tree proving it
+    unordered_lru_cache<uint256, std::pair<CTransactionRef, CPartialMerkleTree>, StaticSaltedHasher> cbTxs;
+    // keyed by the hash of the requested baseBlockHash and blockHash
+    unordered_lru_cache<uint256, CDiffCPtr, StaticSaltedHasher> diffs;
+
+public:
+    CSimplifiedMNListCache() : snapshots(MAX_SNAPSHOTS), cbTxs(MAX_BLOCKS), diffs(MAX_DIFFS) {}
+
+    CSimplifiedMNListSnapshotCPtr GetSnapshot(const uint256& blockHash);
+    void AddSnapshot(const uint256& blockHash, const CSimplifiedMNListSnapshotCPtr& snapshot);
+
+    bool GetCbTx(const uint256& blockHash, CTransactionRef& cbTxRet, CPartialMerkleTree& cbTxMerkleTreeRet);
+    void AddCbTx(const uint256& blockHash, const CTransactionRef& cbTx, const CPartialMerkleTree& cbTxMerkleTree);
+
+    CDiffCPtr GetDiff(const uint256& baseBlockHash, const uint256& blockHash);
+    void AddDiff(const CDiffCPtr& diff);
+
+    // called for every disconnected block
+    void ClearDiffs();
+};
+
+extern CSimplifiedMNListCache simplifiedMNListCache;
+
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet, std::string& errorRet);
 
 #endif //DASH_SIMPLIFIEDMNS_H
@@ -270,6 +270,31 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             listMints = std::list<std::pair<uint256, MintPoolEntry>>();
             mintPool.List(listMints.get());
         }
+
+        // look up the Lelantus mints of this pass all at once, every block holding some of them is read only once
+        std::map<uint256, lelantus::CMintOutPoint> lelantusOutPoints;
+        std::map<uint256, uint256> mintTags;
+        if (!pwalletMain->IsLocked()) {
+            for (const std::pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
+                if (setChecked.count(pMint.first) || tracker.HasPubcoinHash(pMint.first, walletdb))
+                    continue;
+
+                CDataStream ss(SER_GETHASH, 0);
+                ss << pMint.first;
+                ss << std::get<1>(pMint.second);
+                mintTags[pMint.first] = Hash(ss.begin(), ss.end());
+            }
+
+            std::vector<uint256> tags;
+            tags.reserve(mintTags.size());
+            for (const auto& mintTag : mintTags)
+                tags.push_back(mintTag.second);
+            lelantusOutPoints = lelantus::GetOutPointsFromMintTags(tags);
+        }
+
+        // block of the last Lelantus mint found, the mints of the same block are usually next to each other
+        CBlock block;
+        CBlockIndex* pindexBlock = nullptr;
         for (std::pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
             if (setChecked.count(pMint.first))
                 continue;
@@ -285,22 +310,35 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             if (tracker.HasPubcoinHash(pMint.first, walletdb))
                 continue;
 
-            uint160 seedId = std::get<1>(pMint.second);
-            CDataStream ss(SER_GETHASH, 0);
-            ss << pMint.first;
-            ss << seedId;
-            uint256 mintTag = Hash(ss.begin(), ss.end());
+            auto mintTag = mintTags.find(pMint.first);
+            auto lelantusOutPoint = mintTag != mintTags.end() ? lelantusOutPoints.find(mintTag->second) : lelantusOutPoints.end();
 
             COutPoint outPoint;
-            if (!pwalletMain->IsLocked() && lelantus::GetOutPointFromMintTag(outPoint, mintTag)) {
+            if (lelantusOutPoint != lelantusOutPoints.end()) {
+                outPoint = lelantusOutPoint->second.outPoint;
                 const uint256& txHash = outPoint.hash;
                 //this mint has already occurred on the chain, increment counter's state to reflect this
                 LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
                 found = true;
 
-                uint256 hashBlock;
+                CBlockIndex* pindex = chainActive[lelantusOutPoint->second.nHeight];
+                if (pindex && pindex != pindexBlock) {
+                    pindexBlock = nullptr;
+                    if (ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
+                        pindexBlock = pindex;
+                }
+
                 CTransactionRef tx;
-                if (!GetTransaction(txHash, tx, Params().GetConsensus(), hashBlock, true)) {
+                if (pindexBlock && pindexBlock == pindex) {
+                    for (const CTransactionRef& blockTx : block.vtx) {
+                        if (blockTx->GetHash() == txHash) {
+                            tx = blockTx;
+                            break;
+                        }
+                    }
+                }
+
+                if (!tx) {
                     LogPrintf("%s : failed to get transaction for mint %s!\n", __func__, pMint.first.GetHex());
                     found = false;
                     continue;
@@ -341,15 +379,9 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
                     break;
                 }
 
-                CBlockIndex* pindex = nullptr;
-                if (mapBlockIndex.count(hashBlock))
-                    pindex = mapBlockIndex.at(hashBlock);
-
                 if (!setAddedTx.count(txHash)) {
-                    CBlock block;
                     CWalletTx wtx(pwalletMain, tx);
-                    if (pindex && ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-                        SetWalletTransactionBlock(wtx, pindex, block);
+                    SetWalletTransactionBlock(wtx, pindex, block);
 
                     //Fill out wtx so that a transaction record can be created
                     wtx.nTimeReceived = pindex->GetBlockTime();
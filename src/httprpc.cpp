@@ -87,6 +87,15 @@ static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const Uni
     req->WriteReply(nStatus, strReply);
 }
 
+static void JSONBatchErrorReply(HTTPRequest* req, const UniValue& objError, size_t nPartsSent)
+{
+    // The status and the replies streamed so far can't be taken back, the error is sent as the last one of the batch
+    std::string strReply = (nPartsSent > 1 ? "," : "") + JSONRPCReplyObj(NullUniValue, objError, NullUniValue).write() + "]\n";
+
+    req->WriteReplyChunk(HTTP_OK, strReply);
+    req->EndReply();
+}
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool multiUserAuthorized(std::string strUserPass)
@@ -180,6 +189,8 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         return false;
     }
 
+    // number of the parts of a batch reply sent, once there are some an error can't get a reply of its own
+    size_t nBatchParts = 0;
     try {
         // Parse request
         UniValue valRequest;
@@ -202,19 +213,32 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
                 strReply = SanitizeInvalidUTF8(strReply);
             }
 
-        // array of requests
-        } else if (valRequest.isArray())
-            strReply = JSONRPCExecBatch(valRequest.get_array());
-        else
+        // array of requests, the replies are sent as they are ready so that a batch of large results doesn't have
+        // to be kept in memory as a whole
+        } else if (valRequest.isArray()) {
+            req->WriteHeader("Content-Type", "application/json");
+            JSONRPCExecBatch(valRequest.get_array(), [req, &nBatchParts](const std::string& strPart) {
+                req->WriteReplyChunk(HTTP_OK, strPart);
+                nBatchParts++;
+            });
+            req->EndReply();
+            return true;
+        } else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strReply);
     } catch (const UniValue& objError) {
-        JSONErrorReply(req, objError, jreq.id);
+        if (nBatchParts > 0)
+            JSONBatchErrorReply(req, objError, nBatchParts);
+        else
+            JSONErrorReply(req, objError, jreq.id);
         return false;
     } catch (const std::exception& e) {
-        JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id);
+        if (nBatchParts > 0)
+            JSONBatchErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), nBatchParts);
+        else
+            JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id);
         return false;
     }
     return true;
@@ -55,6 +55,7 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    bool replyStarted;
 
 public:
     HTTPRequest(struct evhttp_request* req);
@@ -110,6 +111,22 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Write a part of a chunked HTTP reply, the first call sends the headers with nStatus.
+     * This lets large replies go out while the rest of them is being built.
+     *
+     * @note Finish the reply with EndReply, WriteReply can't be used once the first chunk is written.
+     */
+    void WriteReplyChunk(int nStatus, const std::string& strChunk);
+
+    /**
+     * Finish a chunked HTTP reply.
+     *
+     * @note As this will give the request back to the main thread, do not call any other HTTPRequest methods after
+     * calling this.
+     */
+    void EndReply();
 };
 
 /** Event handler closure.
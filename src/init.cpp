@@ -17,6 +17,7 @@
 #include "compat/sanity.h"
 #include "consensus/validation.h"
 #include "crypto/progpow.h"
+#include "crypto/sha256.h"
 #include "httpserver.h"
 #include "httprpc.h"
 #include "key.h"
@@ -30,6 +31,7 @@
 #include "rpc/register.h"
 #include "script/standard.h"
 #include "script/sigcache.h"
+#include "proof_cache.h"
 #include "scheduler.h"
 #include "timedata.h"
 #include "txdb.h"
@@ -42,6 +44,8 @@
 #include "validation.h"
 #include "mtpstate.h"
 #include "batchproof_container.h"
+#include "lelantus_mempool_verifier.h"
+#include "liblelantus/threadpool.h"
 
 #ifdef ENABLE_WALLET
 #include "wallet/wallet.h"
@@ -229,6 +233,8 @@ void Interrupt(boost::thread_group& threadGroup)
     InterruptREST();
     InterruptTorControl();
     llmq::InterruptLLMQSystem();
+    if (lelantus::mempoolVerifier)
+        lelantus::mempoolVerifier->Interrupt();
     if (g_connman)
         g_connman->Interrupt();
     threadGroup.interrupt_all();
@@ -264,9 +270,14 @@ void Shutdown()
 #endif
     GenerateBitcoins(false, 0, Params());
     MapPort(false);
+    if (lelantus::mempoolVerifier)
+        lelantus::mempoolVerifier->Stop();
     UnregisterValidationInterface(peerLogic.get());
     peerLogic.reset();
     g_connman.reset();
+    delete lelantus::mempoolVerifier;
+    lelantus::mempoolVerifier = nullptr;
+    ParallelOpThreadPool::GetInstance().Stop();
 
     StopTorControl();
     UnregisterNodeSignals(GetNodeSignals());
@@ -441,6 +452,10 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
+    strUsage += HelpMessageOpt("-mempoolproofthreads=<n>", strprintf(_("Set the number of threads batch verifying Lelantus proofs of relayed transactions (0 to %d, 0 = verify them inline, default: %d)"),
+        lelantus::MAX_MEMPOOL_PROOF_THREADS, lelantus::DEFAULT_MEMPOOL_PROOF_THREADS));
+    strUsage += HelpMessageOpt("-proofthreads=<n>", strprintf(_("Set the number of threads creating and verifying Sigma and Lelantus proofs (0 to %u, 0 = one per core, default: %d)"),
+        MAX_POOL_THREADS, DEFAULT_PROOF_THREADS));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file (default: %s)"), BITCOIN_PID_FILENAME));
 #endif
@@ -547,6 +562,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-limitfreerelay=<n>", strprintf("Continuously rate-limit free transactions to <n>*1000 bytes per minute (default: %u)", DEFAULT_LIMITFREERELAY));
         strUsage += HelpMessageOpt("-relaypriority", strprintf("Require high priority for relaying free or low-fee transactions (default: %u)", DEFAULT_RELAYPRIORITY));
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit size of signature cache to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxproofcachesize=<n>", strprintf("Limit size of Sigma and Lelantus proof cache to <n> MiB (default: %u)", DEFAULT_MAX_PROOF_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
     }
     strUsage += HelpMessageOpt("-minrelaytxfee=<amt>", strprintf(_("Fees (in %s/kB) smaller than this are considered zero fee for relaying, mining and transaction creation (default: %s)"),
@@ -577,6 +593,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockmaxweight=<n>", strprintf(_("Set maximum BIP141 block weight (default: %d)"), DEFAULT_BLOCK_MAX_WEIGHT));
     strUsage += HelpMessageOpt("-blockmaxsize=<n>", strprintf(_("Set maximum block size in bytes (default: %d)"), DEFAULT_BLOCK_MAX_SIZE));
     strUsage += HelpMessageOpt("-blockprioritysize=<n>", strprintf(_("Set maximum size of high-priority/low-fee transactions in bytes (default: %d)"), DEFAULT_BLOCK_PRIORITY_SIZE));
+    strUsage += HelpMessageOpt("-progpowdataset", strprintf(_("Mine with the full ProgPow dataset kept in a memory-mapped file in the data directory, shared by the miners on this machine (default: %u)"), DEFAULT_PROGPOW_DATASET));
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
@@ -604,6 +621,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-startclean", "Clear all persistence files on startup; triggers reparsing of Elysium transactions");
     strUsage += HelpMessageOpt("-elysiumtxcache=<num>", "The maximum number of transactions in the input transaction cache (default: 500000)");
     strUsage += HelpMessageOpt("-elysiumprogressfrequency=<seconds>", "Time in seconds after which the initial scanning progress is reported (default: 30)");
+    strUsage += HelpMessageOpt("-elysiumscanthreads=<n>", "Number of threads reading blocks ahead during the initial scan, 0 = number of cores (default: 0)");
     strUsage += HelpMessageOpt("-elysiumdebug=<category>", "Enable or disable log categories, can be \"all\" or \"none\"");
     strUsage += HelpMessageOpt("-autocommit=<flag>", "Enable or disable broadcasting of transactions, when creating transactions (default: 1)");
     strUsage += HelpMessageOpt("-overrideforcedshutdown=<flag>", "Disable force shutdown when error (default: 0)");
@@ -1439,6 +1457,9 @@ bool AppInitSanityChecks()
 {
     // ********************************************************* Step 4: sanity checks
 
+    std::string sha256_algo = SHA256AutoDetect();
+    LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+
     // Initialize elliptic curve code
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1483,6 +1504,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     LogPrintf("Using at most %i automatic connections (%i file descriptors available)\n", nMaxConnections, nFD);
 
     InitSignatureCache();
+    InitProofCache();
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
@@ -1490,6 +1512,11 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    // sets up the pool and the multiexponentiation executor before any thread verifies proofs
+    int nProofThreads = std::max(0, (int)GetArg("-proofthreads", DEFAULT_PROOF_THREADS));
+    ParallelOpThreadPool::GetInstance().SetNumberOfThreads(nProofThreads);
+    LogPrintf("Using %u threads for proof verification\n", ParallelOpThreadPool::GetInstance().GetNumberOfThreads());
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -2156,9 +2183,25 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
 
+    int nMempoolProofThreads = std::max(0, std::min((int)GetArg("-mempoolproofthreads", lelantus::DEFAULT_MEMPOOL_PROOF_THREADS), lelantus::MAX_MEMPOOL_PROOF_THREADS));
+    LogPrintf("Using %d threads for Lelantus proof verification of relayed transactions\n", nMempoolProofThreads);
+    if (nMempoolProofThreads > 0) {
+        lelantus::mempoolVerifier = new lelantus::CMempoolVerifier(nMempoolProofThreads);
+        lelantus::mempoolVerifier->Start([] {
+            if (g_connman)
+                g_connman->WakeMessageHandler();
+        });
+    }
+
     if (!connman.Start(scheduler, strNodeError, connOptions))
         return InitError(strNodeError);
 
+    if (GetBoolArg("-progpowdataset", DEFAULT_PROGPOW_DATASET)) {
+        boost::filesystem::path datasetDir = GetDataDir() / "progpow";
+        TryCreateDirectory(datasetDir);
+        progpow_set_dataset_dir(datasetDir.string());
+    }
+
     // Generate coins in the background
     GenerateBitcoins(GetBoolArg("-gen", DEFAULT_GENERATE), GetArg("-genproclimit", DEFAULT_GENERATE_THREADS),
                      chainparams);
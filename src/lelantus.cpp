@@ -17,6 +17,8 @@
 #include "policy/policy.h"
 #include "coins.h"
 #include "batchproof_container.h"
+#include "lelantus_mempool_verifier.h"
+#include "proof_cache.h"
 
 #include <atomic>
 #include <sstream>
@@ -57,8 +59,7 @@ static bool CheckLelantusSpendSerial(
  * Util funtions
  */
 size_t CountCoinInBlock(CBlockIndex *index, int id) {
-    return index->lelantusMintedPubCoins.count(id) > 0
-        ? index->lelantusMintedPubCoins[id].size() : 0;
+    return index->GetLelantusMintCount(id);
 }
 
 std::vector<unsigned char> GetAnonymitySetHash(CBlockIndex *index, int group_id, bool generation = false) {
@@ -275,6 +276,7 @@ bool CheckLelantusBlock(CValidationState &state, const CBlock& block) {
 
 bool CheckLelantusJMintTransaction(
         const CTxOut &txout,
+        const COutPoint &outPoint,
         CValidationState &state,
         uint256 hashTx,
         bool fStatefulSigmaCheck,
@@ -335,6 +337,7 @@ bool CheckLelantusJMintTransaction(
 
         // Update public coin list in the info
         lelantusTxInfo->mints.push_back(std::make_pair(pubCoin, std::make_pair(amount, mintTag)));
+        lelantusTxInfo->mintOutPoints[pubCoinValue] = outPoint;
         lelantusTxInfo->zcTransactions.insert(hashTx);
     }
 
@@ -353,7 +356,8 @@ bool CheckLelantusJoinSplitTransaction(
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
         sigma::CSigmaTxInfo* sigmaTxInfo,
-        CLelantusTxInfo* lelantusTxInfo) {
+        CLelantusTxInfo* lelantusTxInfo,
+        JoinSplitProofs* deferredProofs) {
     std::unordered_set<Scalar, sigma::CScalarHash> txSerials;
 
     Consensus::Params const & params = ::Params().GetConsensus();
@@ -427,13 +431,15 @@ bool CheckLelantusJoinSplitTransaction(
     }
 
     bool passVerify = false;
-    std::map<uint32_t, std::vector<PublicCoin>> anonymity_sets;
+    // the sets are shared with the state and with the deferred proofs, they are not copied
+    std::map<uint32_t, CLelantusState::AnonymitySetRef> anonymity_sets;
     std::vector<PublicCoin> Cout;
     uint64_t Vout = 0;
 
-    for (const CTxOut &txout : tx.vout) {
+    for (uint32_t i = 0; i < tx.vout.size(); i++) {
+        const CTxOut &txout = tx.vout[i];
         if (!txout.scriptPubKey.empty() && txout.scriptPubKey.IsLelantusJMint()) {
-            if (!CheckLelantusJMintTransaction(txout, state, hashTx, fStatefulSigmaCheck, Cout, lelantusTxInfo))
+            if (!CheckLelantusJMintTransaction(txout, COutPoint(tx.GetHash(), i), state, hashTx, fStatefulSigmaCheck, Cout, lelantusTxInfo))
                 return false;
         } else if(txout.scriptPubKey.IsLelantusMint()) {
             return false; //putting regular mints at JoinSplit transactions is not allowed
@@ -443,9 +449,10 @@ bool CheckLelantusJoinSplitTransaction(
     }
 
     std::vector<std::vector<unsigned char>> anonymity_set_hashes;
+    // hashes of the blocks the anonymity sets end at, they identify the sets the proofs are checked against
+    std::map<uint32_t, uint256> set_block_hashes;
 
     for (auto& idAndHash : joinsplit->getIdAndBlockHashes()) {
-        auto& anonymity_set = anonymity_sets[idAndHash.first];
         int coinGroupId = idAndHash.first % (CENT / 1000);
         int64_t intDenom = (idAndHash.first - coinGroupId);
         intDenom *= 1000;
@@ -464,15 +471,18 @@ bool CheckLelantusJoinSplitTransaction(
             // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
             while (index != coinGroup.firstBlock && index->GetBlockHash() != idAndHash.second)
                 index = index->pprev;
+            set_block_hashes[idAndHash.first] = index->GetBlockHash();
 
             std::pair<sigma::CoinDenomination, int> denominationAndId = std::make_pair(denomination, coinGroupId);
 
             auto lelantusParams = lelantus::Params::get_default();
+            std::vector<PublicCoin> anonymity_set;
             while (true) {
-                if (index->sigmaMintedPubCoins.count(denominationAndId) > 0) {
+                if (index->GetSigmaMintCount(denominationAndId) > 0) {
+                    auto coinData = index->GetCoinData();
                     BOOST_FOREACH(
                     const sigma::PublicCoin &pubCoinValue,
-                    index->sigmaMintedPubCoins[denominationAndId]) {
+                    coinData->sigmaMintedPubCoins.at(denominationAndId)) {
                         if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
                             continue;
                         }
@@ -484,18 +494,24 @@ bool CheckLelantusJoinSplitTransaction(
                     break;
                 index = index->pprev;
             }
+
+            anonymity_sets[idAndHash.first] = std::make_shared<const std::vector<PublicCoin>>(std::move(anonymity_set));
         } else {
             CLelantusState::LelantusCoinGroupInfo coinGroup;
             if (!lelantusState.GetCoinGroupInfo(idAndHash.first, coinGroup))
                 return state.DoS(100, false, NO_MINT_ZEROCOIN,
                                  "CheckLelantusJoinSplitTransaction: Error: no coins were minted with such parameters");
 
-            CBlockIndex *index = coinGroup.lastBlock;
-
+            // skip mints from blacklist if nLelantusFixesStartBlock is passed
+            bool fSkipBlacklisted = chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock;
 
-            // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
-            while (index != coinGroup.firstBlock && index->GetBlockHash() != idAndHash.second)
-                index = index->pprev;
+            // Get the set of all the public coins with given id up to the block with hash of
+            // accumulatorBlockHash or up to the coinGroup.firstBlock if not found.
+            // This list of public coins is required by function "Verify" of JoinSplit.
+            CBlockIndex *index;
+            anonymity_sets[idAndHash.first] = lelantusState.GetAnonymitySetAtBlock(
+                    idAndHash.first, idAndHash.second, fSkipBlacklisted, index);
+            set_block_hashes[idAndHash.first] = index ? index->GetBlockHash() : uint256();
 
             // take the hash from last block of anonymity set, it is used at challenge generation if nLelantusFixesStartBlock is passed
             if (nHeight >= params.nLelantusFixesStartBlock) {
@@ -503,54 +519,44 @@ bool CheckLelantusJoinSplitTransaction(
                 if (!set_hash.empty())
                     anonymity_set_hashes.push_back(set_hash);
             }
-            // Build a vector with all the public coins with given id before
-            // the block on which the spend occured.
-            // This list of public coins is required by function "Verify" of JoinSplit.
-
-            while (true) {
-                int id = 0;
-                if (CountCoinInBlock(index, idAndHash.first)) {
-                    id = idAndHash.first;
-                } else if (CountCoinInBlock(index, idAndHash.first - 1)) {
-                    id = idAndHash.first - 1;
-                }
-                if (id) {
-                    if(index->lelantusMintedPubCoins.count(id) > 0) {
-                        BOOST_FOREACH(
-                        const auto& pubCoinValue,
-                        index->lelantusMintedPubCoins[id]) {
-                            // skip mints from blacklist if nLelantusFixesStartBlock is passed
-                            if (chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock) {
-                                if (::Params().GetConsensus().lelantusBlacklist.count(pubCoinValue.first.getValue()) > 0) {
-                                    continue;
-                                }
-                            }
-                            anonymity_set.push_back(pubCoinValue.first);
-                        }
-                    }
-                }
-                if (index == coinGroup.firstBlock)
-                    break;
-                index = index->pprev;
-            }
         }
-        anonymity_sets[idAndHash.first] = anonymity_set;
     }
 
     BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
     bool useBatching = batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete;
 
+    // proofs verified before, at the mempool admission or by the mempool verifier, are not verified again if they
+    // were checked for the same challenge and anonymity sets, the sets are identified by their sizes and last blocks
+    bool fCheckCache = !deferredProofs;
+
     Scalar challenge;
-    // if we are collecting proofs, skip verification and collect proofs
-    passVerify = joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, challenge, useBatching);
+    // if we are collecting proofs or may find them in the cache, skip verification
+    passVerify = joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, challenge,
+                                   useBatching || deferredProofs || fCheckCache);
 
-    // add proofs into container
-    if(useBatching) {
-        std::map<uint32_t, size_t> idAndSizes;
+    std::map<uint32_t, size_t> idAndSizes;
 
-        for(auto itr : anonymity_sets)
-            idAndSizes[itr.first] = itr.second.size();
+    for(auto& itr : anonymity_sets)
+        idAndSizes[itr.first] = itr.second->size();
 
+    uint256 proofsKey = CMempoolVerifier::GetProofsKey(hashTx, challenge, idAndSizes, set_block_hashes);
+    bool fCachedProofs = passVerify && fCheckCache && IsProofCached(proofsKey);
+
+    // the rest of the joinsplit was verified above, only the skipped sigma and range proofs are left to check
+    if (passVerify && fCheckCache && !fCachedProofs && !useBatching) {
+        JoinSplitProofs proofs;
+        proofs.Set(joinsplit.get(), anonymity_sets, challenge, Cout, proofsKey);
+        passVerify = CMempoolVerifier::Verify({&proofs}).front();
+        if (passVerify)
+            AddProofToCache(proofsKey);
+    }
+
+    // hand the proofs over to be verified later
+    if (passVerify && deferredProofs)
+        deferredProofs->Set(joinsplit.get(), anonymity_sets, challenge, Cout, proofsKey);
+
+    // add proofs into container
+    if(useBatching && !fCachedProofs) {
         batchProofContainer->add(joinsplit.get(), idAndSizes, challenge, nHeight >= params.nLelantusFixesStartBlock);
         batchProofContainer->add(joinsplit.get(), Cout);
     }
@@ -642,6 +648,7 @@ bool CheckLelantusJoinSplitTransaction(
 
 bool CheckLelantusMintTransaction(
         const CTxOut &txout,
+        const COutPoint &outPoint,
         CValidationState &state,
         uint256 hashTx,
         bool fStatefulSigmaCheck,
@@ -700,6 +707,7 @@ bool CheckLelantusMintTransaction(
     if (lelantusTxInfo != NULL && !lelantusTxInfo->fInfoIsComplete) {
         // Update public coin list in the info
         lelantusTxInfo->mints.push_back(std::make_pair(pubCoin, std::make_pair(txout.nValue, mintTag)));
+        lelantusTxInfo->mintOutPoints[pubCoinValue] = outPoint;
         lelantusTxInfo->zcTransactions.insert(hashTx);
     }
 
@@ -715,7 +723,8 @@ bool CheckLelantusTransaction(
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
         sigma::CSigmaTxInfo* sigmaTxInfo,
-        CLelantusTxInfo* lelantusTxInfo)
+        CLelantusTxInfo* lelantusTxInfo,
+        JoinSplitProofs* deferredProofs)
 {
     Consensus::Params const & consensus = ::Params().GetConsensus();
 
@@ -738,9 +747,10 @@ bool CheckLelantusTransaction(
 
     // Check Mint Lelantus Transaction
     if (allowLelantus && !isVerifyDB) {
-        for (const CTxOut &txout : tx.vout) {
+        for (uint32_t i = 0; i < tx.vout.size(); i++) {
+            const CTxOut &txout = tx.vout[i];
             if (!txout.scriptPubKey.empty() && txout.scriptPubKey.IsLelantusMint()) {
-                if (!CheckLelantusMintTransaction(txout, state, hashTx, fStatefulSigmaCheck, lelantusTxInfo))
+                if (!CheckLelantusMintTransaction(txout, COutPoint(tx.GetHash(), i), state, hashTx, fStatefulSigmaCheck, lelantusTxInfo))
                     return false;
             }
         }
@@ -764,7 +774,7 @@ bool CheckLelantusTransaction(
         if (!isVerifyDB) {
             if (!CheckLelantusJoinSplitTransaction(
                 tx, state, hashTx, isVerifyDB, nHeight, realHeight,
-                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo, lelantusTxInfo)) {
+                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo, lelantusTxInfo, deferredProofs)) {
                     return false;
             }
         }
@@ -880,8 +890,11 @@ bool ConnectBlockLelantus(
     // Add lelantus transaction information to index
     if (pblock && pblock->lelantusTxInfo) {
         if (!fJustCheck) {
-            pindexNew->lelantusMintedPubCoins.clear();
-            pindexNew->lelantusSpentSerials.clear();
+            if (pindexNew->HasCoinData()) {
+                CBlockCoinData &coinData = pindexNew->ModifyCoinData();
+                coinData.lelantusMintedPubCoins.clear();
+                coinData.lelantusSpentSerials.clear();
+            }
             pindexNew->anonymitySetHash.clear();
         }
 
@@ -901,7 +914,7 @@ bool ConnectBlockLelantus(
             }
 
             if (!fJustCheck) {
-                pindexNew->lelantusSpentSerials.insert(serial);
+                pindexNew->ModifyCoinData().lelantusSpentSerials.insert(serial);
                 lelantusState.AddSpend(serial.first, serial.second);
             }
         }
@@ -911,18 +924,26 @@ bool ConnectBlockLelantus(
 
         const auto& params = ::Params().GetConsensus();
         CHash256 hash;
-        std::vector<unsigned char> data(GroupElement::serialize_size);
         bool updateHash = false;
 
+        // serializes all the coins into the hasher, sharing one affine conversion between them
+        auto writeCoins = [&hash](const std::vector<GroupElement>& values) {
+            if (values.empty())
+                return;
+            std::vector<unsigned char> data(values.size() * GroupElement::serialize_size);
+            GroupElement::serialize_all(values, data.data());
+            hash.Write(data.data(), data.size());
+        };
+
         // create first anonymity set hash with whole existing set, at HF block
         if (pindexNew->nHeight == params.nLelantusFixesStartBlock) {
             updateHash = true;
-            std::vector<lelantus::PublicCoin> coins;
-            lelantusState.GetAnonymitySet(1, false, coins);
-            for (auto &coin : coins) {
-                coin.getValue().serialize(data.data());
-                hash.Write(data.data(), data.size());
-            }
+            auto coins = lelantusState.GetAnonymitySet(1, false);
+            std::vector<GroupElement> values;
+            values.reserve(coins->size());
+            for (auto &coin : *coins)
+                values.push_back(coin.getValue());
+            writeCoins(values);
         }
 
         if (!pblock->lelantusTxInfo->mints.empty()) {
@@ -947,10 +968,14 @@ bool ConnectBlockLelantus(
                     }
                 }
 
-                for (auto &coin : pindexNew->lelantusMintedPubCoins[latestCoinId]) {
-                    coin.first.getValue().serialize(data.data());
-                    hash.Write(data.data(), data.size());
+                std::vector<GroupElement> values;
+                auto coinData = pindexNew->GetCoinData();
+                auto blockMints = coinData->lelantusMintedPubCoins.find(latestCoinId);
+                if (blockMints != coinData->lelantusMintedPubCoins.end()) {
+                    for (auto &coin : blockMints->second)
+                        values.push_back(coin.first.getValue());
                 }
+                writeCoins(values);
             }
         }
 
@@ -1004,12 +1029,19 @@ bool GetOutPoint(COutPoint& outPoint, const lelantus::PublicCoin &pubCoin) {
     if(mintHeight==-1 && coinId==-1)
         return false;
 
+    if (lelantusState->GetMintOutPoint(pubCoin.getValue(), outPoint))
+        return true;
+
     // get block containing mint
     CBlockIndex *mintBlock = chainActive[mintHeight];
     CBlock block;
-    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus()))
+    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
         LogPrintf("can't read block from disk.\n");
+        return false;
+    }
 
+    // the other mints of the block are likely to be looked up too
+    lelantusState->AddMintOutPoints(block);
     return GetOutPointFromBlock(outPoint, pubCoin.getValue(), block);
 }
 
@@ -1039,6 +1071,46 @@ bool GetOutPointFromMintTag(COutPoint& outPoint, const uint256 &pubCoinTag) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
+std::map<uint256, CMintOutPoint> GetOutPointsFromMintTags(const std::vector<uint256> &pubCoinTags) {
+    std::map<uint256, CMintOutPoint> result;
+
+    // coins without recorded outpoints, grouped by the height of the block they were minted in
+    std::map<int, std::vector<std::pair<uint256, GroupElement>>> unresolved;
+    for (const auto& tag : pubCoinTags) {
+        GroupElement pubCoinValue;
+        if (!lelantusState.HasCoinTag(pubCoinValue, tag))
+            continue;
+
+        int mintHeight = lelantusState.GetMintedCoinHeightAndId(lelantus::PublicCoin(pubCoinValue)).first;
+        if (mintHeight < 0)
+            continue;
+
+        COutPoint outPoint;
+        if (lelantusState.GetMintOutPoint(pubCoinValue, outPoint))
+            result[tag] = {outPoint, mintHeight};
+        else
+            unresolved[mintHeight].emplace_back(tag, pubCoinValue);
+    }
+
+    for (const auto& blockCoins : unresolved) {
+        CBlockIndex *mintBlock = chainActive[blockCoins.first];
+        CBlock block;
+        if (!mintBlock || !ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
+            LogPrintf("can't read block from disk.\n");
+            continue;
+        }
+
+        lelantusState.AddMintOutPoints(block);
+        for (const auto& coin : blockCoins.second) {
+            COutPoint outPoint;
+            if (lelantusState.GetMintOutPoint(coin.second, outPoint))
+                result[coin.first] = {outPoint, blockCoins.first};
+        }
+    }
+
+    return result;
+}
+
 bool BuildLelantusStateFromIndex(CChain *chain) {
     for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
     {
@@ -1075,9 +1147,10 @@ CLelantusState::Containers::Containers(std::atomic<bool> & surgeCondition)
 : surgeCondition(surgeCondition)
 {}
 
-void CLelantusState::Containers::AddMint(lelantus::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& tag) {
+void CLelantusState::Containers::AddMint(lelantus::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& tag, const uint256& valueHash) {
     mintedPubCoins.insert(std::make_pair(pubCoin, coinInfo));
     tagToPublicCoin.insert(std::make_pair(tag, pubCoin));
+    hashToPublicCoin.insert(std::make_pair(valueHash, pubCoin));
     mintMetaInfo[coinInfo.coinGroupId] += 1;
     CheckSurgeCondition();
 }
@@ -1091,6 +1164,7 @@ void CLelantusState::Containers::RemoveMint(lelantus::PublicCoin const & pubCoin
                 break;
             }
 
+        hashToPublicCoin.erase(pubCoin.getValueHash());
         mintMetaInfo[iter->second.coinGroupId] -= 1;
         mintedPubCoins.erase(iter);
         CheckSurgeCondition();
@@ -1103,6 +1177,7 @@ void CLelantusState::Containers::AddSpend(Scalar const & serial, int coinGroupId
     }
 
     usedCoinSerials[serial] = coinGroupId;
+    hashToSerial[primitives::GetSerialHash(serial)] = serial;
     spendMetaInfo[coinGroupId] += 1;
     CheckSurgeCondition();
 }
@@ -1111,6 +1186,7 @@ void CLelantusState::Containers::RemoveSpend(Scalar const & serial) {
     auto iter = usedCoinSerials.find(serial);
     if (iter != usedCoinSerials.end()) {
         spendMetaInfo[iter->second] -= 1;
+        hashToSerial.erase(primitives::GetSerialHash(serial));
         usedCoinSerials.erase(iter);
         CheckSurgeCondition();
     }
@@ -1138,6 +1214,14 @@ std::unordered_map<Scalar, int> const & CLelantusState::Containers::GetSpends()
     return usedCoinSerials;
 }
 
+std::unordered_map<uint256, lelantus::PublicCoin> const & CLelantusState::Containers::GetHashToPublicCoin() const {
+    return hashToPublicCoin;
+}
+
+std::unordered_map<uint256, Scalar> const & CLelantusState::Containers::GetHashToSerial() const {
+    return hashToSerial;
+}
+
 bool CLelantusState::Containers::IsSurgeCondition() const {
     return surgeCondition;
 }
@@ -1148,6 +1232,8 @@ void CLelantusState::Containers::Reset() {
     mintMetaInfo.clear();
     spendMetaInfo.clear();
     tagToPublicCoin.clear();
+    hashToPublicCoin.clear();
+    hashToSerial.clear();
     surgeCondition = false;
 }
 
@@ -1196,10 +1282,12 @@ void CLelantusState::Containers::CheckSurgeCondition() {
 
 CLelantusState::CLelantusState(
     size_t maxCoinInGroup,
-    size_t startGroupSize)
+    size_t startGroupSize,
+    size_t maxMintOutPoints)
     :
     maxCoinInGroup(maxCoinInGroup),
     startGroupSize(startGroupSize),
+    mintOutPoints(maxMintOutPoints),
     containers(surgeCondition)
 {
     Reset();
@@ -1243,14 +1331,37 @@ void CLelantusState::AddMintsToStateAndBlockIndex(
         newCoinGroup.nCoins = coins + blockMints.size();
 
         containers.AddExtendedMints(latestCoinId, coins);
+        ExtendAnonymitySet(latestCoinId, first);
     }
 
+    std::vector<lelantus::PublicCoin> blockCoins;
+    std::vector<GroupElement> blockValues;
+    blockCoins.reserve(blockMints.size());
+    blockValues.reserve(blockMints.size());
     for (const auto& mint : blockMints) {
-        containers.AddMint(mint.first, CMintedCoinInfo::make(latestCoinId, index->nHeight), mint.second);
+        blockCoins.push_back(mint.first);
+        blockValues.push_back(mint.first.getValue());
+    }
+
+    std::vector<uint256> valueHashes = primitives::GetPubCoinValueHashes(blockValues);
+    for (size_t i = 0; i < blockMints.size(); i++) {
+        const auto& mint = blockMints[i];
+        containers.AddMint(mint.first, CMintedCoinInfo::make(latestCoinId, index->nHeight), mint.second, valueHashes[i]);
 
         LogPrintf("AddMintsToStateAndBlockIndex: Lelantus mint added id=%d\n", latestCoinId);
-        index->lelantusMintedPubCoins[latestCoinId].push_back(mint);
     }
+
+    if (!blockMints.empty()) {
+        auto &indexMints = index->ModifyCoinData().lelantusMintedPubCoins[latestCoinId];
+        indexMints.insert(indexMints.end(), blockMints.begin(), blockMints.end());
+    }
+
+    if (!pblock->lelantusTxInfo->mintOutPoints.empty()) {
+        std::lock_guard<std::mutex> lock(cs_mintOutPoints);
+        for (const auto& outPoint : pblock->lelantusTxInfo->mintOutPoints)
+            mintOutPoints.insert(outPoint.first, outPoint.second);
+    }
+    anonymitySets[latestCoinId].AddBlock(index, latestCoinId, blockCoins);
 }
 
 void CLelantusState::AddSpend(const Scalar &serial, int coinGroupId) {
@@ -1258,7 +1369,8 @@ void CLelantusState::AddSpend(const Scalar &serial, int coinGroupId) {
 }
 
 void CLelantusState::AddBlock(CBlockIndex *index) {
-    for (auto const &pubCoins : index->lelantusMintedPubCoins) {
+    auto coinData = index->GetCoinData();
+    for (auto const &pubCoins : coinData->lelantusMintedPubCoins) {
 
         if (pubCoins.second.empty())
             continue;
@@ -1274,25 +1386,40 @@ void CLelantusState::AddBlock(CBlockIndex *index) {
                 coinGroup.firstBlock = first ? first : index;
 
                 containers.AddExtendedMints(pubCoins.first, coinGroup.nCoins);
+                ExtendAnonymitySet(pubCoins.first, first);
             }
         }
         coinGroup.lastBlock = index;
         coinGroup.nCoins += pubCoins.second.size();
 
         latestCoinId = pubCoins.first;
+        std::vector<lelantus::PublicCoin> blockCoins;
+        std::vector<GroupElement> blockValues;
+        blockCoins.reserve(pubCoins.second.size());
+        blockValues.reserve(pubCoins.second.size());
         for (auto const &coin : pubCoins.second) {
-            containers.AddMint(coin.first, CMintedCoinInfo::make(pubCoins.first, index->nHeight), coin.second);
+            blockCoins.push_back(coin.first);
+            blockValues.push_back(coin.first.getValue());
+        }
+
+        std::vector<uint256> valueHashes = primitives::GetPubCoinValueHashes(blockValues);
+        for (size_t i = 0; i < pubCoins.second.size(); i++) {
+            auto const &coin = pubCoins.second[i];
+            containers.AddMint(coin.first, CMintedCoinInfo::make(pubCoins.first, index->nHeight), coin.second, valueHashes[i]);
         }
+        anonymitySets[pubCoins.first].AddBlock(index, pubCoins.first, blockCoins);
     }
 
-    for (auto const &serial : index->lelantusSpentSerials) {
+    for (auto const &serial : coinData->lelantusSpentSerials) {
         AddSpend(serial.first, serial.second);
     }
 }
 
 void CLelantusState::RemoveBlock(CBlockIndex *index) {
+    auto coinData = index->GetCoinData();
+
     // roll back coin group updates
-    for (auto &coins : index->lelantusMintedPubCoins)
+    for (auto &coins : coinData->lelantusMintedPubCoins)
     {
         if (coinGroups.count(coins.first) == 0) {
             throw std::invalid_argument("Group Id does not exist");
@@ -1327,6 +1454,7 @@ void CLelantusState::RemoveBlock(CBlockIndex *index) {
         if ((!isExtended && coinGroup.nCoins == 0) || (isExtended && isEdgedBlock)) {
             // all the coins of this group have been erased, remove the group altogether
             coinGroups.erase(coins.first);
+            anonymitySets.erase(coins.first);
             // decrease pubcoin id
             latestCoinId--;
             // erase from containers
@@ -1334,16 +1462,17 @@ void CLelantusState::RemoveBlock(CBlockIndex *index) {
         } else {
             // roll back lastBlock to previous position
             assert(coinGroup.lastBlock == index);
+            anonymitySets[coins.first].RemoveBlock(index);
 
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->lelantusMintedPubCoins.count(coins.first) == 0);
+            } while (coinGroup.lastBlock->GetLelantusMintCount(coins.first) == 0);
         }
     }
 
     // roll back mints
-    for (auto const &pubCoins : index->lelantusMintedPubCoins) {
+    for (auto const &pubCoins : coinData->lelantusMintedPubCoins) {
         for (auto const &coin : pubCoins.second) {
             auto coins = containers.GetMints().equal_range(coin.first);
             auto coinIt = find_if(
@@ -1357,9 +1486,15 @@ void CLelantusState::RemoveBlock(CBlockIndex *index) {
     }
 
     // roll back spends
-    for (auto const &serial : index->lelantusSpentSerials) {
+    for (auto const &serial : coinData->lelantusSpentSerials) {
         containers.RemoveSpend(serial.first);
     }
+
+    std::lock_guard<std::mutex> lock(cs_mintOutPoints);
+    for (auto const &pubCoins : coinData->lelantusMintedPubCoins) {
+        for (auto const &coin : pubCoins.second)
+            mintOutPoints.erase(coin.first.getValue());
+    }
 }
 
 bool CLelantusState::GetCoinGroupInfo(
@@ -1377,11 +1512,11 @@ bool CLelantusState::IsUsedCoinSerial(const Scalar &coinSerial) {
 }
 
 bool CLelantusState::IsUsedCoinSerialHash(Scalar &coinSerial, const uint256 &coinSerialHash) {
-    for ( auto it = GetSpends().begin(); it != GetSpends().end(); ++it ){
-        if(primitives::GetSerialHash(it->first)==coinSerialHash){
-            coinSerial = it->first;
-            return true;
-        }
+    auto const& serials = containers.GetHashToSerial();
+    auto it = serials.find(coinSerialHash);
+    if (it != serials.end()) {
+        coinSerial = it->second;
+        return true;
     }
     return false;
 }
@@ -1391,12 +1526,11 @@ bool CLelantusState::HasCoin(const lelantus::PublicCoin& pubCoin) {
 }
 
 bool CLelantusState::HasCoinHash(GroupElement &pubCoinValue, const uint256 &pubCoinValueHash) {
-    for ( auto it = GetMints().begin(); it != GetMints().end(); ++it ){
-        const lelantus::PublicCoin & pubCoin = (*it).first;
-        if(pubCoin.getValueHash()==pubCoinValueHash){
-            pubCoinValue = pubCoin.getValue();
-            return true;
-        }
+    auto const& mints = containers.GetHashToPublicCoin();
+    auto it = mints.find(pubCoinValueHash);
+    if (it != mints.end()) {
+        pubCoinValue = it->second.getValue();
+        return true;
     }
     return false;
 }
@@ -1410,118 +1544,122 @@ bool CLelantusState::HasCoinTag(GroupElement& pubCoinValue, const uint256& pubCo
     return false;
 }
 
+void CLelantusState::AddMintOutPoints(const CBlock& block) {
+    std::vector<std::pair<GroupElement, COutPoint>> blockOutPoints;
+    for (const auto& tx : block.vtx) {
+        for (uint32_t i = 0; i < tx->vout.size(); i++) {
+            const CScript& script = tx->vout[i].scriptPubKey;
+            if (!script.IsLelantusMint() && !script.IsLelantusJMint())
+                continue;
+
+            GroupElement pubCoinValue;
+            try {
+                ParseLelantusMintScript(script, pubCoinValue);
+            } catch (...) {
+                continue;
+            }
+            blockOutPoints.emplace_back(pubCoinValue, COutPoint(tx->GetHash(), i));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cs_mintOutPoints);
+    for (const auto& outPoint : blockOutPoints)
+        mintOutPoints.insert(outPoint.first, outPoint.second);
+}
+
+bool CLelantusState::GetMintOutPoint(const GroupElement& pubCoinValue, COutPoint& outPoint) const {
+    std::lock_guard<std::mutex> lock(cs_mintOutPoints);
+    return mintOutPoints.get(pubCoinValue, outPoint);
+}
+
 int CLelantusState::GetCoinSetForSpend(
     CChain *chain,
     int maxHeight,
     int coinGroupID,
     uint256& blockHash_out,
-    std::vector<lelantus::PublicCoin>& coins_out,
+    AnonymitySetRef& coins_out,
     std::vector<unsigned char>& setHash_out) {
 
-    coins_out.clear();
+    coins_out = std::make_shared<const std::vector<lelantus::PublicCoin>>();
 
     if (coinGroups.count(coinGroupID) == 0) {
         return 0;
     }
 
-    LelantusCoinGroupInfo &coinGroup = coinGroups[coinGroupID];
-
-    int numberOfCoins = 0;
-    for (CBlockIndex *block = coinGroup.lastBlock;; block = block->pprev) {
-
-        // ignore block heigher than max height
-        if (block->nHeight > maxHeight) {
-            continue;
-        }
+    LOCK(cs_main);
+    AnonymitySet &anonymitySet = anonymitySets[coinGroupID];
 
-        // check coins in group coinGroupID - 1 in the case that using coins from prev group.
-        int id = 0;
-        if (CountCoinInBlock(block, coinGroupID)) {
-            id = coinGroupID;
-        } else if (CountCoinInBlock(block, coinGroupID - 1)) {
-            id = coinGroupID - 1;
-        }
+    // latest block satisfying given conditions
+    int position = anonymitySet.FindBlock(maxHeight);
+    if (position < 0) {
+        return 0;
+    }
 
-        if (id) {
-            if (numberOfCoins == 0) {
-                // latest block satisfying given conditions
-                // remember block hash and set hash
-                blockHash_out = block->GetBlockHash();
-                setHash_out =  GetAnonymitySetHash(block, id);
-            }
-            numberOfCoins += block->lelantusMintedPubCoins[id].size();
-            if (block->lelantusMintedPubCoins.count(id) > 0) {
-                for (const auto &coin : block->lelantusMintedPubCoins[id]) {
-                    LOCK(cs_main);
-                    // skip mints from blacklist if nLelantusFixesStartBlock is passed
-                    if (chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock) {
-                        if (::Params().GetConsensus().lelantusBlacklist.count(coin.first.getValue()) > 0) {
-                            continue;
-                        }
-                    }
-                    coins_out.push_back(coin.first);
-                }
-            }
-        }
+    const AnonymitySet::BlockEntry &block = anonymitySet.blocks[position];
+    // remember block hash and set hash
+    blockHash_out = block.index->GetBlockHash();
+    setHash_out = GetAnonymitySetHash(block.index, block.coinGroupId);
 
-        if (block == coinGroup.firstBlock) {
-            break ;
-        }
-    }
+    // skip mints from blacklist if nLelantusFixesStartBlock is passed
+    bool fSkipBlacklisted = chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock;
+    coins_out = anonymitySet.GetSnapshot(position, fSkipBlacklisted);
 
-    return numberOfCoins;
+    return block.nCoins;
 }
 
-void CLelantusState::GetAnonymitySet(
+CLelantusState::AnonymitySetRef CLelantusState::GetAnonymitySet(
         int coinGroupID,
-        bool fStartLelantusBlacklist,
-        std::vector<lelantus::PublicCoin>& coins_out) {
-
-    coins_out.clear();
+        bool fStartLelantusBlacklist) {
 
     if (coinGroups.count(coinGroupID) == 0) {
-        return;
+        return std::make_shared<const std::vector<lelantus::PublicCoin>>();
     }
 
-    LelantusCoinGroupInfo &coinGroup = coinGroups[coinGroupID];
     const auto &params = ::Params().GetConsensus();
     LOCK(cs_main);
     int maxHeight = fStartLelantusBlacklist ? (chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1)) : (params.nLelantusFixesStartBlock - 1);
+    bool fSkipBlacklisted = fStartLelantusBlacklist && chainActive.Height() >= params.nLelantusFixesStartBlock;
+
+    AnonymitySet &anonymitySet = anonymitySets[coinGroupID];
+    return anonymitySet.GetSnapshot(anonymitySet.FindBlock(maxHeight), fSkipBlacklisted);
+}
 
-    for (CBlockIndex *block = coinGroup.lastBlock;; block = block->pprev) {
+CLelantusState::AnonymitySetRef CLelantusState::GetAnonymitySetAtBlock(
+        int coinGroupID,
+        const uint256& blockHash,
+        bool fSkipBlacklisted,
+        CBlockIndex*& index_out) {
 
-        // ignore block heigher than max height
-        if (block->nHeight > maxHeight) {
-            continue;
-        }
+    index_out = nullptr;
 
-        // check coins in group coinGroupID - 1 in the case that using coins from prev group.
-        int id = 0;
-        if (CountCoinInBlock(block, coinGroupID)) {
-            id = coinGroupID;
-        } else if (CountCoinInBlock(block, coinGroupID - 1)) {
-            id = coinGroupID - 1;
-        }
+    if (coinGroups.count(coinGroupID) == 0) {
+        return std::make_shared<const std::vector<lelantus::PublicCoin>>();
+    }
 
-        if (id) {
-            if(block->lelantusMintedPubCoins.count(id) > 0) {
-                for (const auto &coin : block->lelantusMintedPubCoins[id]) {
-                    if (fStartLelantusBlacklist &&
-                        chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock) {
-                        std::vector<unsigned char> vch = coin.first.getValue().getvch();
-                        if (::Params().GetConsensus().lelantusBlacklist.count(coin.first.getValue()) > 0) {
-                            continue;
-                        }
-                    }
-                    coins_out.push_back(coin.first);
-                }
-            }
-        }
+    LOCK(cs_main);
+    LelantusCoinGroupInfo &coinGroup = coinGroups[coinGroupID];
+    AnonymitySet &anonymitySet = anonymitySets[coinGroupID];
 
-        if (block == coinGroup.firstBlock) {
-            break ;
+    // first block of the group is used if the block is not found between first and last blocks of the group
+    int position = 0;
+    index_out = coinGroup.firstBlock;
+
+    auto it = anonymitySet.blockPositions.find(blockHash);
+    if (it != anonymitySet.blockPositions.end()) {
+        position = it->second;
+        index_out = anonymitySet.blocks[position].index;
+    } else {
+        // the block may have no mints of this group but still be within the group
+        BlockMap::const_iterator mi = mapBlockIndex.find(blockHash);
+        if (mi != mapBlockIndex.end()
+            && mi->second->nHeight > coinGroup.firstBlock->nHeight
+            && coinGroup.lastBlock->GetAncestor(mi->second->nHeight) == mi->second) {
+            position = anonymitySet.FindBlock(mi->second->nHeight);
+            index_out = mi->second;
         }
     }
+
+    return anonymitySet.GetSnapshot(position, fSkipBlacklisted);
 }
 
 std::pair<int, int> CLelantusState::GetMintedCoinHeightAndId(
@@ -1582,8 +1720,12 @@ bool CLelantusState::CanAddMintToMempool(const GroupElement& pubCoin){
 
 void CLelantusState::Reset() {
     coinGroups.clear();
+    anonymitySets.clear();
     latestCoinId = 0;
     containers.Reset();
+
+    std::lock_guard<std::mutex> lock(cs_mintOutPoints);
+    mintOutPoints.clear();
 }
 
 CLelantusState* CLelantusState::GetState() {
@@ -1627,9 +1769,8 @@ size_t CLelantusState::CountLastNCoins(int groupId, size_t required, CBlockIndex
             ; coins < required && block
             ; block = block->pprev) {
 
-            size_t inBlock;
-            if (block->lelantusMintedPubCoins.count(groupId)
-                && (inBlock = block->lelantusMintedPubCoins[groupId].size())) {
+            size_t inBlock = block->GetLelantusMintCount(groupId);
+            if (inBlock > 0) {
 
                 coins += inBlock;
                 first = block;
@@ -1640,6 +1781,111 @@ size_t CLelantusState::CountLastNCoins(int groupId, size_t required, CBlockIndex
     return coins;
 }
 
+void CLelantusState::ExtendAnonymitySet(int groupId, CBlockIndex *first) {
+    if (!first || anonymitySets.count(groupId - 1) == 0) {
+        return;
+    }
+
+    AnonymitySet &anonymitySet = anonymitySets[groupId];
+    const AnonymitySet &prevSet = anonymitySets.at(groupId - 1);
+    auto it = prevSet.blockPositions.find(first->GetBlockHash());
+    if (it == prevSet.blockPositions.end()) {
+        return;
+    }
+
+    for (size_t i = it->second; i < prevSet.blocks.size(); i++) {
+        const AnonymitySet::BlockEntry &block = prevSet.blocks[i];
+        size_t begin = i > 0 ? prevSet.blocks[i - 1].nCoins : 0;
+        anonymitySet.AddBlock(
+            block.index,
+            block.coinGroupId,
+            std::vector<lelantus::PublicCoin>(prevSet.coins.begin() + begin, prevSet.coins.begin() + block.nCoins));
+    }
+}
+
+// CLelantusState::AnonymitySet
+
+void CLelantusState::AnonymitySet::AddBlock(
+        CBlockIndex *index,
+        int coinGroupId,
+        const std::vector<lelantus::PublicCoin>& blockCoins) {
+    if (blockCoins.empty()) {
+        return;
+    }
+
+    const auto &blacklist = ::Params().GetConsensus().lelantusBlacklist;
+    size_t nBlacklisted = blocks.empty() ? 0 : blocks.back().nBlacklisted;
+
+    for (const auto &coin : blockCoins) {
+        bool isBlacklisted = blacklist.count(coin.getValue()) > 0;
+        coins.push_back(coin);
+        blacklisted.push_back(isBlacklisted);
+        nBlacklisted += isBlacklisted;
+    }
+
+    blockPositions[index->GetBlockHash()] = blocks.size();
+    blocks.push_back({index, coinGroupId, coins.size(), nBlacklisted});
+}
+
+void CLelantusState::AnonymitySet::RemoveBlock(CBlockIndex *index) {
+    if (blocks.empty() || blocks.back().index != index) {
+        return;
+    }
+
+    blocks.pop_back();
+    blockPositions.erase(index->GetBlockHash());
+
+    size_t nCoins = blocks.empty() ? 0 : blocks.back().nCoins;
+    coins.resize(nCoins);
+    blacklisted.resize(nCoins);
+
+    // forget snapshots ending at the removed block
+    snapshots.erase(snapshots.lower_bound(std::make_pair(blocks.size(), false)), snapshots.end());
+}
+
+int CLelantusState::AnonymitySet::FindBlock(int maxHeight) const {
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), maxHeight,
+        [](int height, const BlockEntry &block) {
+            return height < block.index->nHeight;
+        });
+    return int(it - blocks.begin()) - 1;
+}
+
+CLelantusState::AnonymitySetRef CLelantusState::AnonymitySet::GetSnapshot(int position, bool fSkipBlacklisted) {
+    if (position < 0 || size_t(position) >= blocks.size()) {
+        return std::make_shared<const std::vector<lelantus::PublicCoin>>();
+    }
+
+    // without blacklisted coins in the set both kinds of snapshots are the same
+    fSkipBlacklisted = fSkipBlacklisted && blocks[position].nBlacklisted > 0;
+
+    auto key = std::make_pair(size_t(position), fSkipBlacklisted);
+    auto it = snapshots.find(key);
+    if (it != snapshots.end()) {
+        return it->second;
+    }
+
+    // coins of the latest block come first, coins inside the block keep their order
+    auto result = std::make_shared<std::vector<lelantus::PublicCoin>>();
+    result->reserve(blocks[position].nCoins - (fSkipBlacklisted ? blocks[position].nBlacklisted : 0));
+    for (int i = position; i >= 0; i--) {
+        size_t begin = i > 0 ? blocks[i - 1].nCoins : 0;
+        for (size_t j = begin; j < blocks[i].nCoins; j++) {
+            if (fSkipBlacklisted && blacklisted[j]) {
+                continue;
+            }
+            result->push_back(coins[j]);
+        }
+    }
+
+    if (snapshots.size() >= maxSnapshots) {
+        // snapshots of the earliest blocks are the least likely to be asked for again
+        snapshots.erase(snapshots.begin());
+    }
+
+    return snapshots[key] = result;
+}
+
 // CLelantusMempoolState
 
 bool CLelantusMempoolState::HasCoinSerial(const Scalar& coinSerial) {
@@ -12,12 +12,20 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include "coin_containers.h"
+#include "unordered_lru_cache.h"
 
 namespace lelantus_mintspend { class lelantus_mintspend_test; }
 
 namespace lelantus {
 
+struct JoinSplitProofs;
+
+// Number of mint outpoints kept in memory, the outpoints of the older mints are found by reading their blocks
+static const size_t MAX_MINT_OUTPOINTS = 100000;
+
 // Lelantus transaction info, added to the CBlock to ensure zerocoin mint/spend transactions got their info stored into index
 class CLelantusTxInfo {
 public:
@@ -27,6 +35,9 @@ public:
     // Vector of <pubCoin, <amount, hash>> for all the mints.
     std::vector<std::pair<lelantus::PublicCoin, std::pair<uint64_t, uint256>>> mints;
 
+    // Outpoints of the mints
+    std::unordered_map<GroupElement, COutPoint> mintOutPoints;
+
     // serial for every spend (map from serial to coin group id)
     std::unordered_map<Scalar, int> spentSerials;
 
@@ -58,6 +69,7 @@ CAmount GetSpendTransparentAmount(const CTransaction& tx);
 
 bool CheckLelantusBlock(CValidationState &state, const CBlock& block);
 
+// If deferredProofs is given, the sigma and range proofs of a JoinSplit are not verified but returned in it
 bool CheckLelantusTransaction(
     const CTransaction &tx,
 	CValidationState &state,
@@ -67,7 +79,8 @@ bool CheckLelantusTransaction(
 	bool isCheckWallet,
 	bool fStatefulSigmaCheck,
     sigma::CSigmaTxInfo* sigmaTxInfo,
-	CLelantusTxInfo* lelantusTxInfo);
+	CLelantusTxInfo* lelantusTxInfo,
+	JoinSplitProofs* deferredProofs = nullptr);
 
 void DisconnectTipLelantus(CBlock &block, CBlockIndex *pindexDelete);
 
@@ -89,6 +102,18 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 // This one gets outpoint from hash of reduced Lelantus commitment
 bool GetOutPointFromMintTag(COutPoint& outPoint, const uint256 &pubCoinTag);
 
+// Outpoint of a mint together with the height of the block it was minted in
+struct CMintOutPoint {
+    COutPoint outPoint;
+    int nHeight;
+};
+
+/*
+ * Get outpoints of many mints at once using the hashes of their reduced commitments. Every block some of the
+ * outpoints were not recorded for is read once. Tags not found on chain are left out of the result.
+ */
+std::map<uint256, CMintOutPoint> GetOutPointsFromMintTags(const std::vector<uint256> &pubCoinTags);
+
 
 bool BuildLelantusStateFromIndex(CChain *chain);
 
@@ -147,10 +172,14 @@ public:
         int nCoins;
     };
 
+    // Immutable anonymity set shared between all the callers asking for the same set
+    typedef lelantus::AnonymitySetRef AnonymitySetRef;
+
 public:
     CLelantusState(
         size_t maxCoinInGroup = ZC_LELANTUS_MAX_MINT_NUM,
-        size_t startGroupSize = ZC_LELANTUS_SET_START_SIZE);
+        size_t startGroupSize = ZC_LELANTUS_SET_START_SIZE,
+        size_t maxMintOutPoints = MAX_MINT_OUTPOINTS);
 
     // Add mints in block, automatically assigning id to it
     void AddMintsToStateAndBlockIndex(CBlockIndex *index, const CBlock* pblock);
@@ -179,6 +208,11 @@ public:
     // Query if there is a coin with given tag
     bool HasCoinTag(GroupElement &pubCoinValue, const uint256 &pubCoinTag);
 
+    // Record outpoints of the mints in the block
+    void AddMintOutPoints(const CBlock &block);
+    // Query outpoint of the coin, recorded when its block was connected or read by one of the GetOutPoint functions
+    bool GetMintOutPoint(const GroupElement &pubCoinValue, COutPoint &outPoint) const;
+
 
     // Given id returns latest anonymity set and corresponding block hash
     // Do not take into account coins with height more than maxHeight
@@ -188,13 +222,21 @@ public:
         int maxHeight,
         int id,
         uint256& blockHash_out,
-        std::vector<lelantus::PublicCoin>& coins_out,
+        AnonymitySetRef& coins_out,
         std::vector<unsigned char>& setHash_out);
 
-    void GetAnonymitySet(
+    AnonymitySetRef GetAnonymitySet(
             int coinGroupID,
-            bool fStartLelantusBlacklist,
-            std::vector<lelantus::PublicCoin>& coins_out);
+            bool fStartLelantusBlacklist);
+
+    // Returns anonymity set of the group as it was at the block with given hash, or the set of
+    // the first block of the group if the block is not part of it. Blacklisted coins are
+    // skipped if fSkipBlacklisted is set. Last block of the set is returned in index_out
+    AnonymitySetRef GetAnonymitySetAtBlock(
+            int coinGroupID,
+            const uint256& blockHash,
+            bool fSkipBlacklisted,
+            CBlockIndex*& index_out);
 
     // Return height of mint transaction and id of minted coin
     std::pair<int, int> GetMintedCoinHeightAndId(const lelantus::PublicCoin& pubCoin);
@@ -236,6 +278,44 @@ public:
 private:
     size_t CountLastNCoins(int groupId, size_t required, CBlockIndex* &first);
 
+    // Start anonymity set of a new group with the last coins of the previous group
+    void ExtendAnonymitySet(int groupId, CBlockIndex *first);
+
+private:
+    // Append-only copy of the coins forming anonymity set of a group, in the order blocks were
+    // connected. Anonymity set as of any block of the group is the prefix ending at that block
+    // read in reverse block order, so connecting a block never disturbs earlier snapshots.
+    struct AnonymitySet {
+        struct BlockEntry {
+            CBlockIndex *index;
+            // id of the group coins of this block were minted to, coinGroupId - 1 for the
+            // blocks taken over from the previous group
+            int coinGroupId;
+            // number of coins and blacklisted coins up to and including this block
+            size_t nCoins;
+            size_t nBlacklisted;
+        };
+
+        // maximum number of memoized snapshots per group
+        static const size_t maxSnapshots = 8;
+
+        std::vector<lelantus::PublicCoin> coins;
+        std::vector<bool> blacklisted;
+        std::vector<BlockEntry> blocks;
+        std::unordered_map<uint256, size_t> blockPositions;
+
+        // snapshots keyed by (position of the last block, fSkipBlacklisted)
+        std::map<std::pair<size_t, bool>, AnonymitySetRef> snapshots;
+
+        void AddBlock(CBlockIndex *index, int coinGroupId, const std::vector<lelantus::PublicCoin>& blockCoins);
+        void RemoveBlock(CBlockIndex *index);
+
+        // Position of the latest block with height not exceeding maxHeight, or -1
+        int FindBlock(int maxHeight) const;
+
+        AnonymitySetRef GetSnapshot(int position, bool fSkipBlacklisted);
+    };
+
 private:
     // Group Limit
     size_t maxCoinInGroup;
@@ -247,12 +327,19 @@ private:
     // Latest anonymity set id;
     int latestCoinId;
 
+    // Anonymity sets of all the coin groups
+    std::unordered_map<int, AnonymitySet> anonymitySets;
+
+    // Outpoints of the recently connected or looked up mints, the wallet records them outside of cs_main
+    mutable std::mutex cs_mintOutPoints;
+    mutable unordered_lru_cache<GroupElement, COutPoint, std::hash<GroupElement>> mintOutPoints;
+
     std::atomic<bool> surgeCondition;
 
     struct Containers {
         Containers(std::atomic<bool> & surgeCondition);
 
-        void AddMint(lelantus::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& tag);
+        void AddMint(lelantus::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& tag, const uint256& valueHash);
         void RemoveMint(lelantus::PublicCoin const & pubCoin);
 
         void AddSpend(Scalar const & serial, int coinGroupId);
@@ -266,6 +353,8 @@ private:
         mint_info_container const & GetMints() const;
         std::unordered_map<Scalar, int> const & GetSpends() const;
         std::unordered_map<uint256, lelantus::PublicCoin>& GetTagToPublicCoin();
+        std::unordered_map<uint256, lelantus::PublicCoin> const & GetHashToPublicCoin() const;
+        std::unordered_map<uint256, Scalar> const & GetHashToSerial() const;
         bool IsSurgeCondition() const;
     private:
         // Set of all minted pubCoin values, keyed by the public coin.
@@ -277,6 +366,10 @@ private:
         //this map keeps hash(G^s*H0^r|seedId) to G^s*H0^r*H1^v
         std::unordered_map<uint256, lelantus::PublicCoin> tagToPublicCoin;
 
+        // Hashes of minted pubCoin values and of used serials, used by the wallet to look them up
+        std::unordered_map<uint256, lelantus::PublicCoin> hashToPublicCoin;
+        std::unordered_map<uint256, Scalar> hashToSerial;
+
         std::atomic<bool> & surgeCondition;
 
         typedef std::map<int, size_t> metainfo_container_t;
@@ -0,0 +1,339 @@
+#include "lelantus_mempool_verifier.h"
+#include "liblelantus/sigmaextended_verifier.h"
+#include "liblelantus/range_verifier.h"
+#include "hash.h"
+#include "proof_cache.h"
+#include "util.h"
+#include "validation.h"
+
+namespace lelantus {
+
+CMempoolVerifier* mempoolVerifier = nullptr;
+
+void JoinSplitProofs::Set(JoinSplit* joinsplit,
+                          const std::map<uint32_t, CLelantusState::AnonymitySetRef>& anonymitySets,
+                          const Scalar& challenge_,
+                          const std::vector<PublicCoin>& Cout_,
+                          const uint256& key_) {
+    key = key_;
+    challenge = challenge_;
+    version = joinsplit->getVersion();
+    rangeProof = joinsplit->getLelantusProof().bulletproofs;
+    Cout = Cout_;
+
+    // proofs are matched with the sets the same way LelantusVerifier::verify_sigma does it
+    const std::vector<SigmaExtendedProof>& proofs = joinsplit->getLelantusProof().sigma_proofs;
+    const std::vector<Scalar>& serials = joinsplit->getCoinSerialNumbers();
+    const std::vector<uint32_t>& groupIds = joinsplit->getCoinGroupIds();
+
+    sigmaProofs.clear();
+    sigmaProofs.reserve(anonymitySets.size());
+    size_t i = 0;
+    for (const auto& set : anonymitySets) {
+        SigmaProofs setProofs;
+        setProofs.anonymitySet = set.second;
+        while (i < groupIds.size() && groupIds[i] == set.first) {
+            setProofs.serials.push_back(serials[i]);
+            setProofs.proofs.push_back(proofs[i]);
+            i++;
+        }
+        sigmaProofs.emplace_back(std::move(setProofs));
+    }
+}
+
+CMempoolVerifier::CMempoolVerifier(int nThreads_) : nThreads(nThreads_), fInterrupted(false) {
+}
+
+CMempoolVerifier::~CMempoolVerifier() {
+    Interrupt();
+    Stop();
+}
+
+void CMempoolVerifier::Start(std::function<void()> notify_) {
+    // can't start new threads if we have them running already
+    assert(workThreads.empty());
+
+    notify = notify_;
+    for (int i = 0; i < nThreads; i++) {
+        workThreads.emplace_back(&TraceThread<std::function<void()>>,
+            "joinsplitverify",
+            std::function<void()>(std::bind(&CMempoolVerifier::ThreadVerify, this)));
+    }
+}
+
+void CMempoolVerifier::Interrupt() {
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        fInterrupted = true;
+    }
+    cond.notify_all();
+}
+
+void CMempoolVerifier::Stop() {
+    for (auto& thread : workThreads) {
+        if (thread.joinable())
+            thread.join();
+    }
+    workThreads.clear();
+}
+
+bool CMempoolVerifier::Submit(const CTransactionRef& tx, NodeId peer, CValidationState& state) {
+    AssertLockHeld(cs_main);
+
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (workThreads.empty() || jobs.size() >= MAX_QUEUED_JOINSPLITS || queued.count(tx->GetHash()))
+            return false;
+    }
+
+    Job job;
+    job.tx = tx;
+    job.peer = peer;
+    if (!CheckLelantusTransaction(*tx, state, tx->GetHash(), false, INT_MAX, false, true, nullptr, nullptr, &job.proofs)) {
+        // failed signatures leave the state as it is, it must not go for the full verification
+        if (state.IsValid())
+            state.Invalid(false, REJECT_INVALID, "bad-txns-lelantus-joinsplit");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        queued.insert(tx->GetHash());
+        peerJobs[peer]++;
+        jobs.emplace_back(std::move(job));
+    }
+    cond.notify_one();
+    return true;
+}
+
+std::vector<CMempoolVerifier::Result> CMempoolVerifier::TakeResults(NodeId peer) {
+    std::vector<Result> peerResults;
+
+    std::lock_guard<std::mutex> lock(cs);
+    auto it = results.find(peer);
+    if (it == results.end())
+        return peerResults;
+
+    peerResults.swap(it->second);
+    results.erase(it);
+    for (const auto& result : peerResults)
+        queued.erase(result.tx->GetHash());
+    return peerResults;
+}
+
+void CMempoolVerifier::RemovePeer(NodeId peer) {
+    std::lock_guard<std::mutex> lock(cs);
+    auto it = results.find(peer);
+    if (it != results.end()) {
+        for (const auto& result : it->second) {
+            queued.erase(result.tx->GetHash());
+            verified.erase(result.tx->GetHash());
+        }
+        results.erase(it);
+    }
+
+    if (peerJobs.count(peer))
+        removedPeers.insert(peer);
+}
+
+bool CMempoolVerifier::IsQueued(const uint256& txHash) const {
+    std::lock_guard<std::mutex> lock(cs);
+    return queued.count(txHash) > 0;
+}
+
+bool CMempoolVerifier::IsVerified(const uint256& txHash) const {
+    std::lock_guard<std::mutex> lock(cs);
+    return verified.count(txHash) > 0;
+}
+
+void CMempoolVerifier::Erase(const uint256& txHash) {
+    std::lock_guard<std::mutex> lock(cs);
+    verified.erase(txHash);
+}
+
+uint256 CMempoolVerifier::GetProofsKey(const uint256& txHash,
+                                       const Scalar& challenge,
+                                       const std::map<uint32_t, size_t>& setSizes,
+                                       const std::map<uint32_t, uint256>& setBlockHashes) {
+    CHashWriter h(SER_GETHASH, PROTOCOL_VERSION);
+    h << txHash << challenge;
+    for (const auto& setSize : setSizes)
+        h << setSize.first << uint64_t(setSize.second);
+    for (const auto& setBlockHash : setBlockHashes)
+        h << setBlockHash.first << setBlockHash.second;
+    return h.GetHash();
+}
+
+std::vector<bool> CMempoolVerifier::Verify(const std::vector<const JoinSplitProofs*>& proofs) {
+    std::vector<bool> results(proofs.size(), true);
+    for (std::size_t begin = 0; begin < proofs.size(); begin += MAX_JOINSPLIT_BATCH) {
+        std::size_t end = std::min(begin + MAX_JOINSPLIT_BATCH, proofs.size());
+        if (!BatchVerify(proofs.begin() + begin, proofs.begin() + end))
+            Bisect(proofs, begin, end, results);
+    }
+    return results;
+}
+
+bool CMempoolVerifier::BatchVerify(std::vector<const JoinSplitProofs*>::const_iterator begin,
+                                   std::vector<const JoinSplitProofs*>::const_iterator end) {
+    struct SigmaBatch {
+        std::vector<Scalar> challenges;
+        std::vector<Scalar> serials;
+        std::vector<size_t> setSizes;
+        std::vector<SigmaExtendedProof> proofs;
+    };
+
+    struct RangeBatch {
+        std::vector<std::vector<GroupElement>> V;
+        std::vector<std::vector<GroupElement>> commitments;
+        std::vector<RangeProof> proofs;
+    };
+
+    auto params = Params::get_default();
+
+    // sigma proofs are batched per anonymity set, range proofs per joinsplit version
+    std::map<CLelantusState::AnonymitySetRef, SigmaBatch> sigmaBatches;
+    std::map<unsigned int, RangeBatch> rangeBatches;
+    for (auto it = begin; it != end; ++it) {
+        const JoinSplitProofs& proofs = **it;
+        for (const auto& setProofs : proofs.sigmaProofs) {
+            SigmaBatch& batch = sigmaBatches[setProofs.anonymitySet];
+            for (std::size_t i = 0; i < setProofs.proofs.size(); i++) {
+                batch.challenges.emplace_back(proofs.challenge);
+                batch.serials.emplace_back(setProofs.serials[i]);
+                batch.setSizes.emplace_back(setProofs.anonymitySet->size());
+                batch.proofs.emplace_back(setProofs.proofs[i]);
+            }
+        }
+
+        if (proofs.Cout.empty())
+            continue;
+
+        std::size_t m = proofs.Cout.size() * 2;
+        while (m & (m - 1))
+            m++;
+
+        RangeBatch& batch = rangeBatches[proofs.version];
+        batch.proofs.emplace_back(proofs.rangeProof);
+        batch.V.emplace_back();
+        batch.V.back().reserve(m); // aggregation size
+        batch.commitments.emplace_back();
+        batch.commitments.back().reserve(2 * proofs.Cout.size());
+        batch.commitments.back().resize(proofs.Cout.size()); // prepend zero elements, to match the prover's behavior
+        for (const auto& coin : proofs.Cout) {
+            batch.V.back().push_back(coin.getValue());
+            batch.V.back().push_back(coin.getValue() + params->get_h1_limit_range());
+            batch.commitments.back().emplace_back(coin.getValue());
+        }
+
+        // Pad with zero elements
+        for (std::size_t t = proofs.Cout.size() * 2; t < m; ++t)
+            batch.V.back().push_back(GroupElement());
+    }
+
+    try {
+        SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
+                                            params->get_sigma_m(), params->get_sigma_table());
+        for (const auto& batch : sigmaBatches) {
+            if (batch.second.proofs.empty())
+                continue;
+
+            std::vector<GroupElement> anonymity_set;
+            anonymity_set.reserve(batch.first->size());
+            for (const auto& coin : *batch.first)
+                anonymity_set.emplace_back(coin.getValue());
+
+            if (!sigmaVerifier.batchverify(anonymity_set, batch.second.challenges, batch.second.serials, batch.second.setSizes, batch.second.proofs))
+                return false;
+        }
+
+        for (const auto& batch : rangeBatches) {
+            RangeVerifier rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), params->get_bulletproofs_g(),
+                                        params->get_bulletproofs_h(), params->get_bulletproofs_n(), batch.first, params->get_bulletproofs_table());
+            if (!rangeVerifier.verify(batch.second.V, batch.second.commitments, batch.second.proofs))
+                return false;
+        }
+    } catch (...) {
+        return false;
+    }
+
+    return true;
+}
+
+void CMempoolVerifier::Bisect(const std::vector<const JoinSplitProofs*>& proofs,
+                              std::size_t begin,
+                              std::size_t end,
+                              std::vector<bool>& results) {
+    // [begin, end) is known to fail verification
+    if (end - begin == 1) {
+        results[begin] = false;
+        return;
+    }
+
+    std::size_t middle = begin + (end - begin) / 2;
+    if (BatchVerify(proofs.begin() + begin, proofs.begin() + middle)) {
+        // the failure is in the other half then
+        Bisect(proofs, middle, end, results);
+        return;
+    }
+
+    Bisect(proofs, begin, middle, results);
+    if (!BatchVerify(proofs.begin() + middle, proofs.begin() + end))
+        Bisect(proofs, middle, end, results);
+}
+
+void CMempoolVerifier::ThreadVerify() {
+    while (true) {
+        std::vector<Job> batch;
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            cond.wait(lock, [this] { return fInterrupted || !jobs.empty(); });
+            if (fInterrupted)
+                return;
+
+            // take whatever is queued, so the batches grow with the load
+            while (!jobs.empty() && batch.size() < MAX_JOINSPLIT_BATCH) {
+                batch.emplace_back(std::move(jobs.front()));
+                jobs.pop_front();
+            }
+        }
+
+        std::vector<const JoinSplitProofs*> proofs;
+        proofs.reserve(batch.size());
+        for (const auto& job : batch)
+            proofs.push_back(&job.proofs);
+
+        int64_t nStart = GetTimeMicros();
+        std::vector<bool> valid = Verify(proofs);
+        LogPrint("mempool", "Verified proofs of %u joinsplits in %.2fms\n", batch.size(), (GetTimeMicros() - nStart) * 0.001);
+
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            for (std::size_t i = 0; i < batch.size(); i++) {
+                const Job& job = batch[i];
+                const uint256& txHash = job.tx->GetHash();
+                if (--peerJobs[job.peer] == 0)
+                    peerJobs.erase(job.peer);
+
+                if (removedPeers.count(job.peer)) {
+                    if (!peerJobs.count(job.peer))
+                        removedPeers.erase(job.peer);
+                    queued.erase(txHash);
+                    continue;
+                }
+
+                if (valid[i]) {
+                    verified.insert(txHash);
+                    AddProofToCache(job.proofs.key);
+                } else
+                    LogPrint("mempool", "JoinSplit proofs of %s from peer=%d are invalid\n", txHash.ToString(), job.peer);
+                results[job.peer].push_back({job.tx, valid[i]});
+            }
+        }
+
+        if (notify)
+            notify();
+    }
+}
+
+} // namespace lelantus
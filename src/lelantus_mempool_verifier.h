@@ -0,0 +1,135 @@
+#ifndef FIRO_LELANTUS_MEMPOOL_VERIFIER_H
+#define FIRO_LELANTUS_MEMPOOL_VERIFIER_H
+
+#include "lelantus.h"
+#include "net.h"
+#include "primitives/transaction.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace lelantus {
+
+// Default number of threads verifying JoinSplit proofs of transactions relayed to us, 0 verifies them inline
+static const int DEFAULT_MEMPOOL_PROOF_THREADS = 2;
+static const int MAX_MEMPOOL_PROOF_THREADS = 16;
+// Maximum number of JoinSplits waiting for verification, the ones above it are verified inline
+static const size_t MAX_QUEUED_JOINSPLITS = 1000;
+// Maximum number of JoinSplits verified in one batch
+static const size_t MAX_JOINSPLIT_BATCH = 64;
+
+// Sigma and range proofs of a JoinSplit, taken out of the transaction to be verified later
+struct JoinSplitProofs {
+    // Sigma proofs against the same anonymity set
+    struct SigmaProofs {
+        CLelantusState::AnonymitySetRef anonymitySet;
+        std::vector<Scalar> serials;
+        std::vector<SigmaExtendedProof> proofs;
+    };
+
+    void Set(JoinSplit* joinsplit,
+             const std::map<uint32_t, CLelantusState::AnonymitySetRef>& anonymitySets,
+             const Scalar& challenge,
+             const std::vector<PublicCoin>& Cout,
+             const uint256& key);
+
+    // Identifies the transaction together with the anonymity sets and challenge the proofs are checked against
+    uint256 key;
+    Scalar challenge;
+    std::vector<SigmaProofs> sigmaProofs;
+    unsigned int version = 0;
+    RangeProof rangeProof;
+    std::vector<PublicCoin> Cout;
+};
+
+/*
+ * Verifies the JoinSplit proofs of transactions relayed to us without holding cs_main. The transaction is checked
+ * under the lock with its proofs left out, the proofs of the queued transactions are then batch verified by the
+ * worker threads. The transactions come back to net processing once their proofs are checked, the valid ones enter
+ * the mempool without verifying the proofs again.
+ */
+class CMempoolVerifier {
+public:
+    struct Result {
+        CTransactionRef tx;
+        bool fValid;
+    };
+
+    explicit CMempoolVerifier(int nThreads);
+    ~CMempoolVerifier();
+
+    // notify is called whenever some results are ready to be taken
+    void Start(std::function<void()> notify);
+    void Interrupt();
+    void Stop();
+
+    // Checks the JoinSplit transaction except for its proofs and queues them for verification. Returns false if the
+    // proofs were not queued, either as the transaction is invalid, state is filled in then, or as the queue is full
+    bool Submit(const CTransactionRef& tx, NodeId peer, CValidationState& state);
+
+    // Transactions of the peer with verified proofs
+    std::vector<Result> TakeResults(NodeId peer);
+    void RemovePeer(NodeId peer);
+
+    // Whether the transaction is waiting for its proofs to be verified
+    bool IsQueued(const uint256& txHash) const;
+    // Whether the transaction's proofs are verified, the verified proofs are put into the proof cache
+    bool IsVerified(const uint256& txHash) const;
+    void Erase(const uint256& txHash);
+
+    // Key of the proofs checked against the anonymity sets with the given sizes ending at the given blocks
+    static uint256 GetProofsKey(const uint256& txHash,
+                                const Scalar& challenge,
+                                const std::map<uint32_t, size_t>& setSizes,
+                                const std::map<uint32_t, uint256>& setBlockHashes);
+
+    // Verifies the proofs of all the transactions in batches, bisecting a failed batch to find the invalid ones
+    static std::vector<bool> Verify(const std::vector<const JoinSplitProofs*>& proofs);
+
+private:
+    struct Job {
+        CTransactionRef tx;
+        NodeId peer;
+        JoinSplitProofs proofs;
+    };
+
+    static bool BatchVerify(std::vector<const JoinSplitProofs*>::const_iterator begin,
+                            std::vector<const JoinSplitProofs*>::const_iterator end);
+    static void Bisect(const std::vector<const JoinSplitProofs*>& proofs,
+                       std::size_t begin,
+                       std::size_t end,
+                       std::vector<bool>& results);
+
+    void ThreadVerify();
+
+private:
+    int nThreads;
+    std::vector<std::thread> workThreads;
+    std::function<void()> notify;
+
+    mutable std::mutex cs;
+    std::condition_variable cond;
+    bool fInterrupted;
+
+    std::deque<Job> jobs;
+    // hashes of the transactions from submission until their results are taken
+    std::set<uint256> queued;
+    // hashes of the transactions with verified proofs
+    std::set<uint256> verified;
+    std::map<NodeId, std::vector<Result>> results;
+    // jobs not finished yet per peer, results for the removed peers are dropped
+    std::map<NodeId, int> peerJobs;
+    std::set<NodeId> removedPeers;
+};
+
+extern CMempoolVerifier* mempoolVerifier;
+
+} // namespace lelantus
+
+#endif //FIRO_LELANTUS_MEMPOOL_VERIFIER_H
@@ -177,4 +177,11 @@ Scalar PrivateCoin::serialNumberFromSerializedPublicKey(
     return Scalar(hash);
 }
 
+std::map<uint32_t, AnonymitySetRef> MakeAnonymitySetRefs(const std::map<uint32_t, std::vector<PublicCoin>>& anonymity_sets) {
+    std::map<uint32_t, AnonymitySetRef> refs;
+    for (const auto& set : anonymity_sets)
+        refs.emplace_hint(refs.end(), set.first, AnonymitySetRef(AnonymitySetRef(), &set.second));
+    return refs;
+}
+
 } //namespace lelantus
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "../sigma/openssl_context.h"
 #include "../uint256.h"
 
+#include <map>
+#include <memory>
 
 namespace lelantus {
 
@@ -41,6 +43,12 @@ private:
     GroupElement value;
 };
 
+// Read-only handle on the coins of an anonymity set, the verifiers take these instead of copies of the sets
+typedef std::shared_ptr<const std::vector<PublicCoin>> AnonymitySetRef;
+
+// Wraps the sets without taking ownership, they must outlive the returned handles
+std::map<uint32_t, AnonymitySetRef> MakeAnonymitySetRefs(const std::map<uint32_t, std::vector<PublicCoin>>& anonymity_sets);
+
 class PrivateCoin {
 public:
 
@@ -7,12 +7,14 @@ InnerProductProofVerifier::InnerProductProofVerifier(
         const std::vector<GroupElement>& h,
         const GroupElement& u,
         const GroupElement& P,
-        int version)
+        int version,
+        const FixedBaseMultiExponent* generators_table)
         : g_(g)
         , h_(h)
         , u_(u)
         , P_(P)
         , version_(version)
+        , generators_(generators_table)
 {
 }
 
@@ -108,13 +110,25 @@ bool InnerProductProofVerifier::verify_fast_util(
         s_inv[i] = x_i.inverse();
     }
 
-    secp_primitives::MultiExponent g_mult(g_, s);
-    secp_primitives::MultiExponent h_mult(h_, s_inv);
-    GroupElement g = g_mult.get_multiple();
-    GroupElement h = h_mult.get_multiple();
-
     GroupElement left;
-    left += g * proof.a_ +  h * proof.b_ + u_ * (proof.a_ * proof.b_);
+    if (generators_ && generators_->size() >= 2 * n) {
+        // a and b are folded into the scalars of the interleaved g and h
+        std::vector<Scalar> generator_scalars;
+        generator_scalars.reserve(2 * n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            generator_scalars.emplace_back(s[i] * proof.a_);
+            generator_scalars.emplace_back(s_inv[i] * proof.b_);
+        }
+        left += generators_->get_multiple(generator_scalars) + u_ * (proof.a_ * proof.b_);
+    } else {
+        secp_primitives::MultiExponent g_mult(g_, s);
+        secp_primitives::MultiExponent h_mult(h_, s_inv);
+        GroupElement g = g_mult.get_multiple();
+        GroupElement h = h_mult.get_multiple();
+
+        left += g * proof.a_ +  h * proof.b_ + u_ * (proof.a_ * proof.b_);
+    }
     GroupElement right = P_;
     GroupElement multi;
     for (std::size_t j = 0; j < log_n; ++j)
@@ -10,12 +10,14 @@ class InnerProductProofVerifier {
 
 public:
     //g and h are being kept by reference, be sure it will not be modified from outside
+    //generators_table, if given, holds precomputed multiples of g and h interleaved as g[0], h[0], g[1], ...
     InnerProductProofVerifier(
             const std::vector<GroupElement>& g,
             const std::vector<GroupElement>& h,
             const GroupElement& u,
             const GroupElement& P,
-            int version); // if(version >= 2) we should pass CHash256 in verify
+            int version, // if(version >= 2) we should pass CHash256 in verify
+            const FixedBaseMultiExponent* generators_table = nullptr);
 
     bool verify(const Scalar& x, const InnerProductProof& proof, std::unique_ptr<ChallengeGenerator>& challengeGenerator);
     bool verify_fast(std::size_t n, const Scalar& x, const InnerProductProof& proof, std::unique_ptr<ChallengeGenerator>& challengeGenerator);
@@ -35,6 +37,7 @@ private:
     GroupElement u_;
     GroupElement P_;
     int version_;
+    const FixedBaseMultiExponent* generators_;
 
 };
 
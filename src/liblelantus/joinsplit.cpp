@@ -126,6 +126,17 @@ bool JoinSplit::Verify(
         uint64_t Vout,
         const uint256& txHash,
         Scalar& challenge,
+        bool fSkipVerification) const {
+    return Verify(MakeAnonymitySetRefs(anonymity_sets), anonymity_set_hashes, Cout, Vout, txHash, challenge, fSkipVerification);
+}
+
+bool JoinSplit::Verify(
+        const std::map<uint32_t, AnonymitySetRef>& anonymity_sets,
+        const std::vector<std::vector<unsigned char>>& anonymity_set_hashes,
+        const std::vector<PublicCoin>& Cout,
+        uint64_t Vout,
+        const uint256& txHash,
+        Scalar& challenge,
         bool fSkipVerification ) const {
     std::map<uint32_t, uint256> groupBlockHashes;
 
@@ -40,6 +40,14 @@ public:
                 Scalar& challenge,
                 bool fSkipVerification = false) const;
 
+    bool Verify(const std::map<uint32_t, AnonymitySetRef>& anonymity_sets,
+                const std::vector<std::vector<unsigned char>>& anonymity_set_hashes,
+                const std::vector<PublicCoin>& Cout,
+                uint64_t Vout,
+                const uint256& txHash,
+                Scalar& challenge,
+                bool fSkipVerification = false) const;
+
     void generatePubKeys(const std::vector<std::pair<PrivateCoin, uint32_t>>& Cin);
 
     void signMetaData(const std::vector<std::pair<PrivateCoin, uint32_t>>& Cin, const SpendMetaData& m, size_t coutSize);
@@ -65,6 +65,17 @@ void LelantusPrimitives::commit(const GroupElement& g,
     result_out = g * r + mult.get_multiple();
 }
 
+void LelantusPrimitives::commit(const FixedBaseMultiExponent& generators,
+                                const std::vector<Scalar>& exp,
+                                const Scalar& r,
+                                GroupElement& result_out) {
+    std::vector<Scalar> powers;
+    powers.reserve(1 + exp.size());
+    powers.emplace_back(r);
+    powers.insert(powers.end(), exp.begin(), exp.end());
+    result_out = generators.get_multiple(powers);
+}
+
 GroupElement LelantusPrimitives::commit(
         const GroupElement& g,
         const Scalar& m,
@@ -193,6 +204,24 @@ void LelantusPrimitives::commit(
     result_out += h * h_exp + g_mult.get_multiple() + h_mult.get_multiple();
 }
 
+void LelantusPrimitives::commit(
+        const GroupElement& h,
+        const Scalar& h_exp,
+        const FixedBaseMultiExponent& generators,
+        const std::vector<Scalar>& L,
+        const std::vector<Scalar>& R,
+        GroupElement& result_out) {
+    if (L.size() != R.size())
+        throw std::invalid_argument("Vector sizes do not match while computing a commitment.");
+    std::vector<Scalar> powers;
+    powers.reserve(2 * L.size());
+    for (std::size_t i = 0; i < L.size(); ++i) {
+        powers.emplace_back(L[i]);
+        powers.emplace_back(R[i]);
+    }
+    result_out += h * h_exp + generators.get_multiple(powers);
+}
+
 Scalar LelantusPrimitives::scalar_dot_product(
         typename std::vector<Scalar>::const_iterator a_start,
         typename std::vector<Scalar>::const_iterator a_end,
@@ -66,6 +66,13 @@ public:
             const Scalar& r,
             GroupElement& result_out);
 
+    // generators holds precomputed multiples of g followed by h
+    static void commit(
+            const FixedBaseMultiExponent& generators,
+            const std::vector<Scalar>& exp,
+            const Scalar& r,
+            GroupElement& result_out);
+
     static void convert_to_sigma(std::size_t num, std::size_t n, std::size_t m, std::vector<Scalar>& out);
 
     static std::vector<std::size_t> convert_to_nal(std::size_t num, std::size_t n, std::size_t m);
@@ -91,6 +98,15 @@ public:
             const std::vector<Scalar>& R,
             GroupElement& result_out);
 
+    // generators holds precomputed multiples of g_ and h_ interleaved as g_[0], h_[0], g_[1], ...
+    static void commit(
+            const GroupElement& h,
+            const Scalar& h_exp,
+            const FixedBaseMultiExponent& generators,
+            const std::vector<Scalar>& L,
+            const std::vector<Scalar>& R,
+            GroupElement& result_out);
+
     // computes dot product of two Scalar vectors
     static Scalar scalar_dot_product(
             typename std::vector<Scalar>::const_iterator a_start,
@@ -22,11 +22,11 @@ bool LelantusVerifier::verify(
         const SchnorrProof& qkSchnorrProof) {
     Scalar x;
     bool fSkipVerification = 0;
-    return verify(anonymity_sets, anonymity_set_hashes, serialNumbers, ecdsaPubkeys, groupIds, Vin, Vout, fee, Cout, proof, qkSchnorrProof, x, fSkipVerification);
+    return verify(MakeAnonymitySetRefs(anonymity_sets), anonymity_set_hashes, serialNumbers, ecdsaPubkeys, groupIds, Vin, Vout, fee, Cout, proof, qkSchnorrProof, x, fSkipVerification);
 }
 
 bool LelantusVerifier::verify(
-        const std::map<uint32_t, std::vector<PublicCoin>>& anonymity_sets,
+        const std::map<uint32_t, AnonymitySetRef>& anonymity_sets,
         const std::vector<std::vector<unsigned char>>& anonymity_set_hashes,
         const std::vector<Scalar>& serialNumbers,
         const std::vector<std::vector<unsigned char>>& ecdsaPubkeys,
@@ -57,7 +57,7 @@ bool LelantusVerifier::verify(
         return false;
     }
 
-    std::vector<std::vector<PublicCoin>> vAnonymity_sets;
+    std::vector<AnonymitySetRef> vAnonymity_sets;
     std::vector<std::vector<Scalar>> vSin;
     vAnonymity_sets.reserve(anonymity_sets.size());
     vSin.resize(anonymity_sets.size());
@@ -89,7 +89,7 @@ bool LelantusVerifier::verify(
 }
 
 bool LelantusVerifier::verify_sigma(
-        const std::vector<std::vector<PublicCoin>>& anonymity_sets,
+        const std::vector<AnonymitySetRef>& anonymity_sets,
         const std::vector<std::vector<unsigned char>>& anonymity_set_hashes,
         const std::vector<std::vector<Scalar>>& Sin,
         const std::vector<Scalar>& serialNumbers,
@@ -118,7 +118,7 @@ bool LelantusVerifier::verify_sigma(
             x);
 
     SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
-                                                          params->get_sigma_m());
+                                                          params->get_sigma_m(), params->get_sigma_table());
 
     if (Sin.size() != anonymity_sets.size())
         throw std::invalid_argument("Number of anonymity sets and number of vectors containing serial numbers must be equal");
@@ -137,10 +137,11 @@ bool LelantusVerifier::verify_sigma(
         if (fSkipVerification)
             continue;
 
+        const std::vector<PublicCoin>& anonymity_set = *anonymity_sets[k];
         std::vector<GroupElement> C_;
-        C_.reserve(anonymity_sets[k].size());
-        for (std::size_t j = 0; j < anonymity_sets[k].size(); ++j)
-            C_.emplace_back(anonymity_sets[k][j].getValue());
+        C_.reserve(anonymity_set.size());
+        for (std::size_t j = 0; j < anonymity_set.size(); ++j)
+            C_.emplace_back(anonymity_set[j].getValue());
 
         if (!sigmaVerifier.batchverify(C_, x, Sin[k], sigma_proofs_k)) {
             LogPrintf("Lelantus verification failed due sigma verification failed.");
@@ -222,7 +223,7 @@ bool LelantusVerifier::verify_rangeproof(
     for (std::size_t i = Cout.size() * 2; i < m; ++i)
         V[0].push_back(GroupElement());
 
-    RangeVerifier  rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), g_, h_, n, version);
+    RangeVerifier  rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), g_, h_, n, version, params->get_bulletproofs_table());
     if (!rangeVerifier.verify(V, commitments, proofs)) {
         LogPrintf("Lelantus verification failed due range proof verification failed.");
         return false;
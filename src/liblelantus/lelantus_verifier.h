@@ -26,7 +26,7 @@ public:
             const SchnorrProof& qkSchnorrProof);
 
     bool verify(
-            const std::map<uint32_t, std::vector<PublicCoin>>& anonymity_sets,
+            const std::map<uint32_t, AnonymitySetRef>& anonymity_sets,
             const std::vector<std::vector<unsigned char>>& anonymity_set_hashes,
             const std::vector<Scalar>& serialNumbers,
             const std::vector<std::vector<unsigned char>>& ecdsaPubkeys,
@@ -42,7 +42,7 @@ public:
 
 private:
     bool verify_sigma(
-            const std::vector<std::vector<PublicCoin>>& anonymity_sets,
+            const std::vector<AnonymitySetRef>& anonymity_sets,
             const std::vector<std::vector<unsigned char>>& anonymity_set_hashes,
             const std::vector<std::vector<Scalar>>& Sin,
             const std::vector<Scalar>& serialNumbers,
@@ -79,6 +79,22 @@ Params::Params(const GroupElement& g_, int n_sigma_, int m_sigma_, int n_rangePr
         h_rangeProof[i].generate(buff2);
     }
 
+    //precomputing multiples of the generators
+    std::vector<GroupElement> sigma_generators;
+    sigma_generators.reserve(1 + h_sigma.size());
+    sigma_generators.emplace_back(g);
+    sigma_generators.insert(sigma_generators.end(), h_sigma.begin(), h_sigma.end());
+    sigma_table.reset(new FixedBaseMultiExponent(sigma_generators));
+
+    std::vector<GroupElement> bulletproofs_generators;
+    bulletproofs_generators.reserve(2 * g_rangeProof.size());
+    for (std::size_t i = 0; i < g_rangeProof.size(); ++i)
+    {
+        bulletproofs_generators.emplace_back(g_rangeProof[i]);
+        bulletproofs_generators.emplace_back(h_rangeProof[i]);
+    }
+    bulletproofs_table.reset(new FixedBaseMultiExponent(bulletproofs_generators));
+
     limit_range = Scalar(uint64_t(2)).exponent(get_bulletproofs_n()) - ::Params().GetConsensus().nMaxValueLelantusMint;
     h1_limit_range = get_h1() * limit_range;
 }
@@ -106,6 +122,14 @@ const std::vector<GroupElement>& Params::get_bulletproofs_h() const {
     return h_rangeProof;
 }
 
+const FixedBaseMultiExponent* Params::get_sigma_table() const {
+    return sigma_table.get();
+}
+
+const FixedBaseMultiExponent* Params::get_bulletproofs_table() const {
+    return bulletproofs_table.get();
+}
+
 int Params::get_sigma_n() const {
     return n_sigma;
 }
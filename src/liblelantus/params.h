@@ -3,9 +3,12 @@
 
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
+#include <secp256k1/include/MultiExponent.h>
 #include <serialize.h>
 #include <sync.h>
 
+#include <memory>
+
 using namespace secp_primitives;
 
 namespace lelantus {
@@ -19,6 +22,10 @@ public:
     const std::vector<GroupElement>& get_sigma_h() const;
     const std::vector<GroupElement>& get_bulletproofs_g() const;
     const std::vector<GroupElement>& get_bulletproofs_h() const;
+    // Precomputed multiples of g followed by sigma h
+    const FixedBaseMultiExponent* get_sigma_table() const;
+    // Precomputed multiples of bulletproofs g and h, interleaved as g[0], h[0], g[1], h[1], ...
+    const FixedBaseMultiExponent* get_bulletproofs_table() const;
     int get_sigma_n() const;
     int get_sigma_m() const;
     int get_bulletproofs_n() const;
@@ -44,6 +51,10 @@ private:
     int max_m_rangeProof;
     std::vector<GroupElement> g_rangeProof;
     std::vector<GroupElement> h_rangeProof;
+
+    //fixed base tables
+    std::unique_ptr<FixedBaseMultiExponent> sigma_table;
+    std::unique_ptr<FixedBaseMultiExponent> bulletproofs_table;
     Scalar limit_range;
     GroupElement h1_limit_range;
 };
@@ -10,7 +10,8 @@ RangeProver::RangeProver(
         const std::vector<GroupElement>& g_vector,
         const std::vector<GroupElement>& h_vector,
         std::size_t n,
-        unsigned int v)
+        unsigned int v,
+        const FixedBaseMultiExponent* generators_table)
         : g (g)
         , h1 (h1)
         , h2 (h2)
@@ -18,6 +19,7 @@ RangeProver::RangeProver(
         , h_(h_vector)
         , n (n)
         , version (v)
+        , generators_(generators_table)
 {}
 
 void RangeProver::proof(
@@ -40,6 +42,9 @@ void RangeProver::proof(
     if (g_.size() != n * m || h_.size() != n * m) {
         throw std::invalid_argument("Range proof generator vector has incorrect size");
     }
+    if (generators_ && generators_->size() < 2 * n * m) {
+        throw std::invalid_argument("Range proof generator table has incorrect size");
+    }
 
     std::vector<std::vector<bool>> bits;
     bits.resize(m);
@@ -60,7 +65,10 @@ void RangeProver::proof(
 
     Scalar alpha;
     alpha.randomize();
-    LelantusPrimitives::commit(h1, alpha, g_, aL, h_, aR, proof_out.A);
+    if (generators_)
+        LelantusPrimitives::commit(h1, alpha, *generators_, aL, aR, proof_out.A);
+    else
+        LelantusPrimitives::commit(h1, alpha, g_, aL, h_, aR, proof_out.A);
 
     std::vector<Scalar> sL, sR;
     sL.resize(n * m);
@@ -73,7 +81,10 @@ void RangeProver::proof(
 
     Scalar ro;
     ro.randomize();
-    LelantusPrimitives::commit(h1, ro, g_, sL, h_, sR, proof_out.S);
+    if (generators_)
+        LelantusPrimitives::commit(h1, ro, *generators_, sL, sR, proof_out.S);
+    else
+        LelantusPrimitives::commit(h1, ro, g_, sL, h_, sR, proof_out.S);
 
     Scalar y, z;
     std::unique_ptr<ChallengeGenerator> challengeGenerator;
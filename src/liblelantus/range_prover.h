@@ -7,6 +7,7 @@ namespace lelantus {
     
 class RangeProver {
 public:
+    //generators_table, if given, holds precomputed multiples of g_vector and h_vector interleaved as g_vector[0], h_vector[0], g_vector[1], ...
     RangeProver(
             const GroupElement& g
             , const GroupElement& h1
@@ -14,7 +15,8 @@ public:
             , const std::vector<GroupElement>& g_vector
             , const std::vector<GroupElement>& h_vector
             , std::size_t n
-            , unsigned int v);
+            , unsigned int v
+            , const FixedBaseMultiExponent* generators_table = nullptr);
 
     // commitments are included into transcript if version >= LELANTUS_TX_VERSION_4_5
     void proof(
@@ -32,6 +34,7 @@ private:
     std::vector<GroupElement> h_;
     std::size_t n;
     unsigned int version;
+    const FixedBaseMultiExponent* generators_;
 
 };
 
@@ -13,7 +13,8 @@ RangeVerifier::RangeVerifier(
         const std::vector<GroupElement>& g_vector,
         const std::vector<GroupElement>& h_vector,
         std::size_t n,
-        unsigned int v)
+        unsigned int v,
+        const FixedBaseMultiExponent* generators_table)
         : g (g)
         , h1 (h1)
         , h2 (h2)
@@ -21,8 +22,14 @@ RangeVerifier::RangeVerifier(
         , h_(h_vector)
         , n (n)
         , version (v)
+        , generators_(generators_table)
+        , multiexp_threads(1)
 {}
 
+void RangeVerifier::set_multiexp_threads(std::size_t threads) {
+    multiexp_threads = threads;
+}
+
 // Verify a single proof by building a trivial batch
 bool RangeVerifier::verify(const std::vector<GroupElement>& V, const std::vector<GroupElement>& commitments, const RangeProof& proof) {
     std::vector<std::vector<GroupElement> > V_batch = {V};
@@ -76,6 +83,9 @@ bool RangeVerifier::verify(const std::vector<std::vector<GroupElement> >& V, con
     if (max_m*n > g_.size() || max_m*n > h_.size()) {
         return false;
     }
+    if (generators_ && 2*max_m*n > generators_->size()) {
+        return false;
+    }
 
     // Set up final multiscalar multiplication and common scalars
     std::vector<GroupElement> points;
@@ -84,13 +94,9 @@ bool RangeVerifier::verify(const std::vector<std::vector<GroupElement> >& V, con
     Scalar h1_scalar(uint64_t(0));
     Scalar h2_scalar(uint64_t(0));
 
-    // Elements from g- and h-vectors are interleaved in order at the start of the final vectors
-    for (std::size_t i = 0; i < max_m*n; i++) {
-        points.emplace_back(g_[i]);
-        scalars.emplace_back(uint64_t(0));
-        points.emplace_back(h_[i]);
-        scalars.emplace_back(uint64_t(0));
-    }
+    // Elements from g- and h-vectors are interleaved in order, their scalars are kept apart
+    // so that the precomputed table can be used for them
+    std::vector<Scalar> generator_scalars(2*max_m*n, Scalar(uint64_t(0)));
 
     // Process each proof and add to the batch
     for (std::size_t k_proofs = 0; k_proofs < N_proofs; k_proofs++) {
@@ -209,10 +215,10 @@ bool RangeVerifier::verify(const std::vector<std::vector<GroupElement> >& V, con
                 }
 
                 // g-vector
-                scalars[2*i] += (x_il * innerProductProof.a_ + z) * w2;
+                generator_scalars[2*i] += (x_il * innerProductProof.a_ + z) * w2;
 
                 // h-vector
-                scalars[2*i + 1] += (y_n_.pow * (x_ir * innerProductProof.b_ - (z_j.pow * two_n[k])) - z) * w2;
+                generator_scalars[2*i + 1] += (y_n_.pow * (x_ir * innerProductProof.b_ - (z_j.pow * two_n[k])) - z) * w2;
 
                 y_n_.go_next();
             }
@@ -253,9 +259,21 @@ bool RangeVerifier::verify(const std::vector<std::vector<GroupElement> >& V, con
     points.emplace_back(h2);
     scalars.emplace_back(h2_scalar);
 
+    GroupElement generators_multiple;
+    if (generators_) {
+        generators_multiple = generators_->get_multiple(generator_scalars);
+    } else {
+        for (std::size_t i = 0; i < max_m*n; i++) {
+            points.emplace_back(g_[i]);
+            scalars.emplace_back(generator_scalars[2*i]);
+            points.emplace_back(h_[i]);
+            scalars.emplace_back(generator_scalars[2*i + 1]);
+        }
+    }
+
     // Perform the batch check
     secp_primitives::MultiExponent mult(points, scalars);
-    if(!mult.get_multiple().isInfinity()) {
+    if(!(mult.get_multiple(multiexp_threads) + generators_multiple).isInfinity()) {
         return false;
     }
     return true;
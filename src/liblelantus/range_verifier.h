@@ -8,6 +8,7 @@ namespace lelantus {
 class RangeVerifier {
 public:
     //g_vector and h_vector are being kept by reference, be sure it will not be modified from outside
+    //generators_table, if given, holds precomputed multiples of g_vector and h_vector interleaved as g_vector[0], h_vector[0], g_vector[1], ...
     RangeVerifier(
             const GroupElement& g
             , const GroupElement& h1
@@ -15,7 +16,11 @@ public:
             , const std::vector<GroupElement>& g_vector
             , const std::vector<GroupElement>& h_vector
             , std::size_t n
-            , unsigned int v);
+            , unsigned int v
+            , const FixedBaseMultiExponent* generators_table = nullptr);
+
+    // Number of threads the final multiexponentiation of a batch may use, 1 by default
+    void set_multiexp_threads(std::size_t threads);
 
     // commitments are included into transcript if version >= LELANTUS_TX_VERSION_4_5
     bool verify(const std::vector<GroupElement>& V, const std::vector<GroupElement>& commitments, const RangeProof& proof); // single proof
@@ -32,6 +37,8 @@ private:
     const std::vector<GroupElement>& h_;
     std::size_t n;
     unsigned int version;
+    const FixedBaseMultiExponent* generators_;
+    std::size_t multiexp_threads;
 };
 
 }//namespace lelantus
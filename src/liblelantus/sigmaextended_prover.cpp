@@ -6,11 +6,22 @@ SigmaExtendedProver::SigmaExtendedProver(
         const GroupElement& g,
         const std::vector<GroupElement>& h_gens,
         std::size_t n,
-        std::size_t m)
+        std::size_t m,
+        const FixedBaseMultiExponent* generators_table)
         : g_(g)
         , h_(h_gens)
         , n_(n)
-        , m_(m) {
+        , m_(m)
+        , generators_(generators_table) {
+    if (generators_ && generators_->size() != 1 + h_.size())
+        generators_ = nullptr;
+}
+
+void SigmaExtendedProver::commit(const std::vector<Scalar>& exp, const Scalar& r, GroupElement& result_out) const {
+    if (generators_)
+        LelantusPrimitives::commit(*generators_, exp, r, result_out);
+    else
+        LelantusPrimitives::commit(g_, h_, exp, r, result_out);
 }
 
 // Generate the initial portion of a one-of-many proof
@@ -56,7 +67,7 @@ void SigmaExtendedProver::sigma_commit(
     }
 
     //compute B
-    LelantusPrimitives::commit(g_, h_, sigma, rB, proof_out.B_);
+    commit(sigma, rB, proof_out.B_);
 
     //compute A
     for (std::size_t j = 0; j < m_; ++j)
@@ -67,7 +78,7 @@ void SigmaExtendedProver::sigma_commit(
             a[j * n_] -= a[j * n_ + i];
         }
     }
-    LelantusPrimitives::commit(g_, h_, a, rA, proof_out.A_);
+    commit(a, rA, proof_out.A_);
 
     //compute C
     std::vector<Scalar> c;
@@ -78,7 +89,7 @@ void SigmaExtendedProver::sigma_commit(
     {
         c[i] = a[i] * (one - two * sigma[i]);
     }
-    LelantusPrimitives::commit(g_,h_, c, rC, proof_out.C_);
+    commit(c, rC, proof_out.C_);
 
     //compute D
     std::vector<Scalar> d;
@@ -87,7 +98,7 @@ void SigmaExtendedProver::sigma_commit(
     {
         d[i] = a[i].square().negate();
     }
-    LelantusPrimitives::commit(g_,h_, d, rD, proof_out.D_);
+    commit(d, rD, proof_out.D_);
 
     std::vector<std::vector<Scalar>> P_i_k;
     P_i_k.resize(setSize);
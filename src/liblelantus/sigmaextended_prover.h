@@ -8,8 +8,10 @@ namespace lelantus {
 class SigmaExtendedProver{
 
 public:
+    // generators_table, if given, holds precomputed multiples of g followed by h_gens and must outlive the prover
     SigmaExtendedProver(const GroupElement& g,
-                    const std::vector<GroupElement>& h_gens, std::size_t n, std::size_t m);
+                    const std::vector<GroupElement>& h_gens, std::size_t n, std::size_t m,
+                    const FixedBaseMultiExponent* generators_table = nullptr);
 
     void sigma_commit(
             const std::vector<GroupElement>& commits,
@@ -39,12 +41,15 @@ public:
             const Scalar& x,
             SigmaExtendedProof& proof_out);
 
+private:
+    void commit(const std::vector<Scalar>& exp, const Scalar& r, GroupElement& result_out) const;
 
 private:
     GroupElement g_;
     std::vector<GroupElement> h_;
     std::size_t n_;
     std::size_t m_;
+    const FixedBaseMultiExponent* generators_;
 };
 
 }//namespace lelantus
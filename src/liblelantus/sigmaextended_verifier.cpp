@@ -7,11 +7,18 @@ SigmaExtendedVerifier::SigmaExtendedVerifier(
         const GroupElement& g,
         const std::vector<GroupElement>& h_gens,
         std::size_t n,
-        std::size_t m)
+        std::size_t m,
+        const FixedBaseMultiExponent* generators_table)
         : g_(g)
         , h_(h_gens)
         , n(n)
-        , m(m){
+        , m(m)
+        , generators_(generators_table)
+        , multiexp_threads(1){
+}
+
+void SigmaExtendedVerifier::set_multiexp_threads(std::size_t threads) {
+    multiexp_threads = threads;
 }
 
 // Verify a single one-of-many proof
@@ -131,6 +138,10 @@ bool SigmaExtendedVerifier::verify(
         LogPrintf("Generator vector size is invalid");
         return false;
     }
+    if (generators_ && generators_->size() != 1 + n * m) {
+        LogPrintf("Generator table size is invalid");
+        return false;
+    }
     if (serials.size() != M) {
         LogPrintf("Invalid number of serials provided");
         return false;
@@ -176,7 +187,10 @@ bool SigmaExtendedVerifier::verify(
     // Set up the final batch elements
     std::vector<GroupElement> points;
     std::vector<Scalar> scalars;
-    std::size_t final_size = 3 + m * n + commits.size(); // g, h1, h2, (h_), (commits)
+    std::size_t final_size = commits.size(); // (commits)
+    if (!generators_) {
+        final_size += 3 + m * n; // g, h1, h2, (h_)
+    }
     for (std::size_t t = 0; t < M; t++) {
         final_size += 4 + proofs[t].Gk_.size() + proofs[t].Qk.size(); // A, B, C, D, (G), (Q)
     }
@@ -289,16 +303,25 @@ bool SigmaExtendedVerifier::verify(
         }
     }
 
-    // Add common generators
-    points.emplace_back(g_);
-    scalars.emplace_back(g_scalar);
-    points.emplace_back(h_[1]);
-    scalars.emplace_back(h1_scalar);
-    points.emplace_back(h_[0]);
-    scalars.emplace_back(h2_scalar);
-    for (std::size_t i = 0; i < m * n; i++) {
-        points.emplace_back(h_[i]);
-        scalars.emplace_back(h_scalars[i]);
+    // Add common generators, these go to the precomputed table if we have one
+    std::vector<Scalar> generator_scalars;
+    if (generators_) {
+        h_scalars[0] += h2_scalar;
+        h_scalars[1] += h1_scalar;
+        generator_scalars.reserve(1 + m * n);
+        generator_scalars.emplace_back(g_scalar);
+        generator_scalars.insert(generator_scalars.end(), h_scalars.begin(), h_scalars.end());
+    } else {
+        points.emplace_back(g_);
+        scalars.emplace_back(g_scalar);
+        points.emplace_back(h_[1]);
+        scalars.emplace_back(h1_scalar);
+        points.emplace_back(h_[0]);
+        scalars.emplace_back(h2_scalar);
+        for (std::size_t i = 0; i < m * n; i++) {
+            points.emplace_back(h_[i]);
+            scalars.emplace_back(h_scalars[i]);
+        }
     }
     for (std::size_t i = 0; i < commits.size(); i++) {
         points.emplace_back(commits[i]);
@@ -306,8 +329,12 @@ bool SigmaExtendedVerifier::verify(
     }
 
     // Verify the batch
-    secp_primitives::MultiExponent result(points, scalars);
-    if (result.get_multiple().isInfinity()) {
+    secp_primitives::MultiExponent mult(points, scalars);
+    GroupElement result = mult.get_multiple(multiexp_threads);
+    if (generators_) {
+        result += generators_->get_multiple(generator_scalars);
+    }
+    if (result.isInfinity()) {
         return true;
     }
     return false;
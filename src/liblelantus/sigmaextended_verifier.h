@@ -8,9 +8,14 @@ namespace lelantus {
 class SigmaExtendedVerifier{
 
 public:
+    // generators_table, if given, holds precomputed multiples of g followed by h_gens and must outlive the verifier
     SigmaExtendedVerifier(const GroupElement& g,
                       const std::vector<GroupElement>& h_gens,
-                      std::size_t n_, std::size_t m_);
+                      std::size_t n_, std::size_t m_,
+                      const FixedBaseMultiExponent* generators_table = nullptr);
+
+    // Number of threads the final multiexponentiation of a batch may use, 1 by default
+    void set_multiexp_threads(std::size_t threads);
 
     // Verify a single one-of-many proof
     // In this case, there is an implied input set size
@@ -79,6 +84,8 @@ private:
     std::vector<GroupElement> h_;
     std::size_t n;
     std::size_t m;
+    const FixedBaseMultiExponent* generators_;
+    std::size_t multiexp_threads;
 };
 
 } // namespace lelantus
@@ -117,6 +117,67 @@ BOOST_AUTO_TEST_CASE(prove_verify_batch)
     }
 }
 
+// A batch of valid aggregated range proofs using precomputed generator tables
+BOOST_AUTO_TEST_CASE(prove_verify_batch_fixed_base)
+{
+    // Parameters
+    const std::size_t n = 64;
+    const std::vector<std::size_t> m = {1,2,4};
+
+    // Generators
+    secp_primitives::GroupElement g_gen, h_gen1, h_gen2;
+    g_gen.randomize();
+    h_gen1.randomize();
+    h_gen2.randomize();
+    std::size_t max_m = *std::max_element(m.begin(), m.end());
+    auto g_ = RandomizeGroupElements(n * max_m);
+    auto h_ = RandomizeGroupElements(n * max_m);
+
+    std::vector<GroupElement> generators;
+    for (std::size_t i = 0; i < n * max_m; i++) {
+        generators.emplace_back(g_[i]);
+        generators.emplace_back(h_[i]);
+    }
+    FixedBaseMultiExponent table(generators);
+
+    for (auto version : test_versions)
+    {
+        // Proofs
+        std::vector<std::vector<GroupElement> > V_batch;
+        std::vector<RangeProof> proof_batch;
+        for (std::size_t i = 0; i < m.size(); i++) {
+            RangeProver rangeProver(g_gen, h_gen1, h_gen2, std::vector<GroupElement>(g_.begin(), g_.begin() + n * m[i]), std::vector<GroupElement>(h_.begin(), h_.begin() + n * m[i]), n, version, &table);
+
+            // Input data
+            auto serials = RandomizeScalars(m[i]);
+            auto randoms = RandomizeScalars(m[i]);
+
+            std::vector<secp_primitives::Scalar> v_s;
+            std::vector<secp_primitives::GroupElement> V;
+            for (std::size_t j = 0; j < m[i]; ++j){
+                v_s.emplace_back(j);
+                V.push_back(g_gen * v_s.back() +  h_gen1 * randoms[j] + h_gen2 * serials[j]);
+            }
+
+            // Prove
+            RangeProof proof;
+            rangeProver.proof(v_s, serials, randoms, V, proof);
+            V_batch.emplace_back(V);
+            proof_batch.emplace_back(proof);
+        }
+
+        // Verify with and without the table
+        RangeVerifier rangeVerifier(g_gen, h_gen1, h_gen2, g_, h_, n, version);
+        BOOST_CHECK(rangeVerifier.verify(V_batch, V_batch, proof_batch));
+        RangeVerifier tableVerifier(g_gen, h_gen1, h_gen2, g_, h_, n, version, &table);
+        BOOST_CHECK(tableVerifier.verify(V_batch, V_batch, proof_batch));
+
+        // Invalidate one of the proofs
+        proof_batch[0].A.randomize();
+        BOOST_CHECK(!tableVerifier.verify(V_batch, V_batch, proof_batch));
+    }
+}
+
 // A single out-of-range aggregated range proof
 BOOST_AUTO_TEST_CASE(out_of_range_single_proof)
 {
@@ -233,6 +233,55 @@ BOOST_AUTO_TEST_CASE(one_out_of_N_batch_with_some_invalid_proof)
     BOOST_CHECK(!verifier.batchverify(commits, x, serials, proofs));
 }
 
+BOOST_AUTO_TEST_CASE(one_out_of_N_batch_fixed_base)
+{
+    GenerateParams(16, 4);
+
+    std::vector<GroupElement> generators = {g};
+    generators.insert(generators.end(), h_gens.begin(), h_gens.end());
+    FixedBaseMultiExponent table(generators);
+
+    auto commits = RandomizeGroupElements(N);
+
+    // Generate
+    std::vector<Secret> secrets;
+
+    for (auto index : {1, 3, 5}) {
+        secrets.emplace_back(index);
+
+        auto &s = secrets.back();
+
+        commits[index] = Primitives::double_commit(
+            g, s.s, h_gens[1], s.v, h_gens[0], s.r);
+    }
+
+    // Proofs generated with and without the table
+    Prover prover(g, h_gens, n, m);
+    Prover tableProver(g, h_gens, n, m, &table);
+    std::vector<Proof> proofs;
+    std::vector<Scalar> serials;
+
+    Scalar x;
+    x.randomize();
+
+    for (std::size_t i = 0; i < secrets.size(); i++) {
+        auto const &s = secrets[i];
+        proofs.emplace_back();
+        serials.push_back(s.s);
+        GenerateBatchProof(
+            i % 2 ? tableProver : prover, commits, s.l, s.s, s.v, s.r, x, proofs.back());
+    }
+
+    Verifier verifier(g, h_gens, n, m);
+    Verifier tableVerifier(g, h_gens, n, m, &table);
+    BOOST_CHECK(verifier.batchverify(commits, x, serials, proofs));
+    BOOST_CHECK(tableVerifier.batchverify(commits, x, serials, proofs));
+
+    // Invalid serial must fail with the table too
+    serials.back().randomize();
+    BOOST_CHECK(!tableVerifier.batchverify(commits, x, serials, proofs));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace lelantus
\ No newline at end of file
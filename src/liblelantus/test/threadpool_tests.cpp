@@ -0,0 +1,106 @@
+#include "../threadpool.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+
+BOOST_AUTO_TEST_SUITE(lelantus_threadpool_tests)
+
+BOOST_AUTO_TEST_CASE(post_and_wait)
+{
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+    threadPool.ResetStats();
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; i++)
+        futures.emplace_back(threadPool.PostTask<int>("test_square", [i]() { return i * i; }));
+
+    for (int i = 0; i < 100; i++) {
+        threadPool.Wait(futures[i]);
+        BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+    }
+
+    // the workers record the stats after the futures are ready, the stopped pool has recorded all of them
+    threadPool.Stop();
+    auto stats = threadPool.GetStats();
+    BOOST_CHECK_EQUAL(stats["test_square"].nTasks, 100);
+}
+
+BOOST_AUTO_TEST_CASE(nested_tasks)
+{
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+    threadPool.SetNumberOfThreads(2);
+
+    // every task waits for subtasks of its own, more of them than there are threads
+    std::atomic<int> count(0);
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 8; i++) {
+        futures.emplace_back(threadPool.PostTask<void>("test_outer", [&threadPool, &count]() {
+            std::vector<std::function<void()>> tasks(8, [&count]() { count++; });
+            threadPool.RunAll("test_inner", tasks);
+        }));
+    }
+
+    for (auto& future : futures)
+        threadPool.Wait(future);
+    BOOST_CHECK_EQUAL(count, 64);
+
+    threadPool.SetNumberOfThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(wait_helps_own_group_only)
+{
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+    threadPool.SetNumberOfThreads(1);
+
+    // the only worker is kept busy so that the tasks posted next stay queued
+    std::promise<void> started, release;
+    std::shared_future<void> released = release.get_future().share();
+    auto blocker = threadPool.PostTask<void>("test_blocker", [&started, released]() {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    std::thread::id waiter = std::this_thread::get_id();
+    ParallelOpThreadPool::TaskGroup group = threadPool.NewTaskGroup();
+    auto foreign = threadPool.PostTask<std::thread::id>("test_foreign", []() { return std::this_thread::get_id(); });
+    auto own = threadPool.PostTask<std::thread::id>("test_own", []() { return std::this_thread::get_id(); }, group);
+
+    threadPool.Wait(own, group);
+    BOOST_CHECK(own.get() == waiter);
+    BOOST_CHECK(foreign.wait_for(std::chrono::seconds(0)) != std::future_status::ready);
+
+    release.set_value();
+    threadPool.Wait(foreign);
+    BOOST_CHECK(foreign.get() != waiter);
+    threadPool.Wait(blocker);
+
+    threadPool.SetNumberOfThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(exceptions)
+{
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+
+    std::vector<std::function<void()>> tasks(4, []() {});
+    tasks[2] = []() { throw std::runtime_error("task failed"); };
+    BOOST_CHECK_THROW(threadPool.RunAll("test_throw", tasks), std::runtime_error);
+
+    auto future = threadPool.PostTask<bool>("test_throw", []() -> bool { throw std::runtime_error("task failed"); });
+    threadPool.Wait(future);
+    BOOST_CHECK_THROW(future.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(stop)
+{
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+    threadPool.Stop();
+
+    // the threads are started again by the next task
+    auto future = threadPool.PostTask<int>("test_restart", []() { return 1; });
+    threadPool.Wait(future);
+    BOOST_CHECK_EQUAL(future.get(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,249 @@
+#include "threadpool.h"
+
+#include "../secp256k1/include/MultiExponent.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Index of the pool worker the thread runs, none for the threads outside of the pool
+thread_local std::size_t current_worker = std::numeric_limits<std::size_t>::max();
+
+std::size_t DefaultNumberOfThreads() {
+    return std::max<std::size_t>(1, std::min<std::size_t>(boost::thread::hardware_concurrency(), MAX_POOL_THREADS));
+}
+
+int64_t MicrosSince(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+}
+
+ParallelOpThreadPool& ParallelOpThreadPool::GetInstance() {
+    // never destroyed, the multiexponentiation executor and the threads still verifying at exit use it
+    static ParallelOpThreadPool* instance = new ParallelOpThreadPool();
+    return *instance;
+}
+
+ParallelOpThreadPool::ParallelOpThreadPool()
+        : number_of_threads(0), shutdown(false), active_workers(0), pending(0), next_worker(0), next_group(NO_TASK_GROUP + 1) {
+    workers.reserve(MAX_POOL_THREADS);
+    for (std::size_t i = 0; i < MAX_POOL_THREADS; ++i)
+        workers.emplace_back(new Worker());
+
+    // parallel multiexponentiations run on the pool too instead of starting threads of their own
+    secp_primitives::MultiExponent::set_executor([](std::vector<std::function<void()>>& tasks) {
+        ParallelOpThreadPool::GetInstance().RunAll("multiexponent", tasks);
+    });
+}
+
+void ParallelOpThreadPool::SetNumberOfThreads(std::size_t thread_number) {
+    Stop();
+
+    std::lock_guard<std::mutex> lock(cs);
+    number_of_threads = std::min(thread_number, MAX_POOL_THREADS);
+}
+
+std::size_t ParallelOpThreadPool::GetNumberOfThreads() const {
+    std::lock_guard<std::mutex> lock(cs);
+    return number_of_threads == 0 ? DefaultNumberOfThreads() : number_of_threads;
+}
+
+ParallelOpThreadPool::TaskGroup ParallelOpThreadPool::NewTaskGroup() {
+    return next_group++;
+}
+
+void ParallelOpThreadPool::RunAll(const char* name, std::vector<std::function<void()>>& tasks) {
+    if (tasks.empty())
+        return;
+
+    TaskGroup group = NewTaskGroup();
+    std::vector<std::future<void>> futures;
+    futures.reserve(tasks.size() - 1);
+    for (std::size_t i = 1; i < tasks.size(); ++i)
+        futures.emplace_back(PostTask<void>(name, std::move(tasks[i]), group));
+
+    // the calling thread does the first task and helps with the rest while waiting for them
+    std::exception_ptr error;
+    try {
+        tasks[0]();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    for (auto& future : futures) {
+        Wait(future, group);
+        try {
+            future.get();
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+std::map<std::string, ParallelOpThreadPool::TaskStats> ParallelOpThreadPool::GetStats() const {
+    std::lock_guard<std::mutex> lock(cs_stats);
+    return stats;
+}
+
+void ParallelOpThreadPool::ResetStats() {
+    std::lock_guard<std::mutex> lock(cs_stats);
+    stats.clear();
+}
+
+void ParallelOpThreadPool::Stop() {
+    std::vector<std::thread> threadsToJoin;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        shutdown = true;
+        threadsToJoin.swap(threads);
+    }
+    cond.notify_all();
+
+    // the threads finish the queued tasks before they exit, the ones posted meanwhile are left to this thread
+    for (auto& thread : threadsToJoin)
+        thread.join();
+    while (RunQueuedTask()) {}
+
+    std::lock_guard<std::mutex> lock(cs);
+    shutdown = false;
+    active_workers = 0;
+}
+
+void ParallelOpThreadPool::Post(const char* name, TaskGroup group, std::function<void()> function) {
+    std::size_t index = current_worker;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        // lazy start threads on first request or after shutdown
+        if (active_workers == 0)
+            StartThreads();
+
+        // the workers put their subtasks into their own queues, the rest is spread over all of them
+        if (index >= active_workers)
+            index = next_worker++ % active_workers;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->cs);
+        workers[index]->tasks.push_back(Task{name, group, std::move(function), std::chrono::steady_clock::now()});
+        pending++;
+    }
+
+    // the sleeping workers check the number of the queued tasks under the lock
+    {
+        std::lock_guard<std::mutex> lock(cs);
+    }
+    cond.notify_one();
+}
+
+bool ParallelOpThreadPool::PopTask(std::size_t first, bool fOwn, Task& task) {
+    std::size_t count = active_workers;
+    for (std::size_t i = 0; i < count; ++i) {
+        Worker& worker = *workers[(first + i) % count];
+        std::lock_guard<std::mutex> lock(worker.cs);
+        if (worker.tasks.empty())
+            continue;
+
+        // the own latest task is likely to share data with the previous one, stealing takes the oldest
+        if (i == 0 && fOwn) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        pending--;
+        return true;
+    }
+    return false;
+}
+
+bool ParallelOpThreadPool::PopGroupTask(TaskGroup group, Task& task) {
+    std::size_t count = active_workers;
+    for (std::size_t i = 0; i < count; ++i) {
+        Worker& worker = *workers[i];
+        std::lock_guard<std::mutex> lock(worker.cs);
+        auto it = std::find_if(worker.tasks.begin(), worker.tasks.end(), [group](const Task& t) { return t.group == group; });
+        if (it == worker.tasks.end())
+            continue;
+
+        task = std::move(*it);
+        worker.tasks.erase(it);
+        pending--;
+        return true;
+    }
+    return false;
+}
+
+bool ParallelOpThreadPool::RunQueuedTask() {
+    if (pending == 0 || active_workers == 0)
+        return false;
+
+    bool fWorker = current_worker < active_workers;
+    Task task;
+    if (!PopTask(fWorker ? current_worker : next_worker++, fWorker, task))
+        return false;
+
+    RunTask(task);
+    return true;
+}
+
+bool ParallelOpThreadPool::RunGroupTask(TaskGroup group) {
+    if (pending == 0 || active_workers == 0)
+        return false;
+
+    Task task;
+    if (!PopGroupTask(group, task))
+        return false;
+
+    RunTask(task);
+    return true;
+}
+
+void ParallelOpThreadPool::RunTask(Task& task) {
+    auto start = std::chrono::steady_clock::now();
+    task.function();
+    auto end = std::chrono::steady_clock::now();
+
+    int64_t queueMicros = MicrosSince(task.queuedAt, start);
+    int64_t runMicros = MicrosSince(start, end);
+
+    std::lock_guard<std::mutex> lock(cs_stats);
+    TaskStats& taskStats = stats[task.name];
+    taskStats.nTasks++;
+    taskStats.nQueueMicros += queueMicros;
+    taskStats.nMaxQueueMicros = std::max(taskStats.nMaxQueueMicros, queueMicros);
+    taskStats.nRunMicros += runMicros;
+    taskStats.nMaxRunMicros = std::max(taskStats.nMaxRunMicros, runMicros);
+}
+
+void ParallelOpThreadPool::StartThreads() {
+    // should be called with mutex aquired
+    std::size_t count = number_of_threads == 0 ? DefaultNumberOfThreads() : number_of_threads;
+
+    active_workers = count;
+    for (std::size_t i = 0; i < count; ++i)
+        threads.emplace_back(&ParallelOpThreadPool::ThreadProc, this, i);
+}
+
+void ParallelOpThreadPool::ThreadProc(std::size_t index) {
+    current_worker = index;
+    for (;;) {
+        Task task;
+        if (PopTask(index, true, task)) {
+            RunTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(cs);
+        cond.wait(lock, [this] { return pending > 0 || shutdown; });
+        if (shutdown && pending == 0)
+            break;
+    }
+    current_worker = std::numeric_limits<std::size_t>::max();
+}
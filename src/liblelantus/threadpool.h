@@ -1,115 +1,126 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <future>
+#include <map>
 #include <memory>
-#include <queue>
-#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
-//#include <algorithm>
 
-#define BOOST_THREAD_PROVIDES_FUTURE
+#include <boost/thread/thread.hpp>
 
-#include <boost/thread/locks.hpp>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/condition_variable.hpp>
-#include <boost/thread/future.hpp>
-#include <boost/chrono.hpp>
+// Maximum number of threads the pool can run
+static const std::size_t MAX_POOL_THREADS = 64;
+// Default number of the pool threads, 0 runs one per core
+static const int DEFAULT_PROOF_THREADS = 0;
 
-
-// our code currently relies on boost disable_interruption. This will go away with core upgrade
-//#include <boost/thread.hpp>
-
-// Number of seconds before thread shuts down if idle
-constexpr static int secondsBeforeThreadShutdown = 60;
-
-// Simple thread pool class for using multiple cores effeciently
-
-template <typename Result>
+// Process-wide pool of threads the provers, the verifiers and the batch proof container post their tasks to. Every
+// worker has its own queue, takes its latest task first and steals the oldest tasks of the other workers when its queue
+// is empty. The threads are started on the first task and stay around until the pool is stopped.
 class ParallelOpThreadPool {
-private:
-    std::list<boost::thread>                    threads;
-    std::queue<boost::packaged_task<Result>>  task_queue;
-    boost::mutex                                task_queue_mutex;
-    boost::condition_variable                   task_queue_condition;
-
-    bool                                      shutdown;
-    size_t const                              number_of_threads;
-
-    void ThreadProc() {
-        for (;;) {
-            boost::packaged_task<Result> job;
-            {
-                boost::unique_lock<boost::mutex> lock(task_queue_mutex);
-
-                task_queue_condition.wait_for(lock, boost::chrono::seconds(secondsBeforeThreadShutdown),
-                                              [this] { return !task_queue.empty() || shutdown; });
-                if (task_queue.empty()) {
-                    // Either timeout or shutdown. If it's a timeout we need to delete ourself from the thread list and detach the thread
-                    // In case of shutdown thread list will be empty and destructor will wait for this thread completion
-                    boost::thread::id currentId = boost::this_thread::get_id();
-                    auto pThread = std::find_if(threads.begin(), threads.end(),
-                                                [=](const boost::thread &t) { return t.get_id() == currentId; });
-                    if (pThread != threads.end()) {
-                        pThread->detach();
-                        threads.erase(pThread);
-                    }
-                    break;
-                }
-                job = std::move(task_queue.front());
-                task_queue.pop();
-            }
-            job();
-        }
-    }
-
-    void StartThreads() {
-        // should be called with mutex aquired
-        // start missing threads
-        while (threads.size() < number_of_threads)
-            threads.emplace_back(std::bind(&ParallelOpThreadPool::ThreadProc, this));
-    }
-
 public:
-    ParallelOpThreadPool(std::size_t thread_number) : number_of_threads(thread_number), shutdown(false) {}
-
-    ~ParallelOpThreadPool() {
-        std::list<boost::thread> threadsToJoin;
-
-        {
-            boost::mutex::scoped_lock lock(task_queue_mutex);
-            shutdown = true;
-            task_queue_condition.notify_all();
+    // Queue and run times of the tasks posted under the same name
+    struct TaskStats {
+        uint64_t nTasks = 0;
+        int64_t nQueueMicros = 0;
+        int64_t nMaxQueueMicros = 0;
+        int64_t nRunMicros = 0;
+        int64_t nMaxRunMicros = 0;
+    };
+
+    static ParallelOpThreadPool& GetInstance();
+
+    // Number of threads the pool runs, 0 for one per core. Running threads are stopped to be restarted at the new size
+    void SetNumberOfThreads(std::size_t thread_number);
+    std::size_t GetNumberOfThreads() const;
+
+    // Tasks posted under the same group can be run by the thread waiting for them, NO_TASK_GROUP is never helped with
+    typedef uint64_t TaskGroup;
+    static const TaskGroup NO_TASK_GROUP = 0;
+
+    // Returns a group no other waiter uses
+    TaskGroup NewTaskGroup();
+
+    // Post a task to the thread pool and return a future to wait for its completion, name has to be a literal as it
+    // is kept for the metrics
+    template <typename Result>
+    std::future<Result> PostTask(const char* name, std::function<Result()> task, TaskGroup group = NO_TASK_GROUP) {
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> ret = packagedTask->get_future();
+        Post(name, group, [packagedTask]() { (*packagedTask)(); });
+        return ret;
+    }
 
-            // move the list to separate variable to wait for the shutdown process to complete
-            threadsToJoin.swap(threads);
+    // Waits for the future, running the queued tasks of the group meanwhile so that tasks waiting for their own
+    // subtasks can't exhaust the pool. Tasks of the other groups are left to the pool as the caller may hold locks
+    // they don't expect, without a group it just blocks
+    template <typename Result>
+    void Wait(const std::future<Result>& future, TaskGroup group = NO_TASK_GROUP) {
+        while (group != NO_TASK_GROUP && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!RunGroupTask(group))
+                break;
         }
-
-        // wait for all the threads
-        for (boost::thread &t: threadsToJoin)
-            t.join();
+        future.wait();
     }
 
-    // Post a task to the thread pool and return a future to wait for its completion
-    boost::future<Result> PostTask(std::function<Result()> task) {
-        boost::packaged_task<Result> packagedTask(std::move(task));
-        boost::future<Result> ret = packagedTask.get_future();
-
-        boost::mutex::scoped_lock lock(task_queue_mutex);
+    // Runs all the tasks on the pool and the calling thread, returns when all of them are done
+    void RunAll(const char* name, std::vector<std::function<void()>>& tasks);
 
-        // lazy start threads on first request or after shutdown
-        if (threads.size() < number_of_threads)
-            StartThreads();
+    std::map<std::string, TaskStats> GetStats() const;
+    void ResetStats();
 
-        task_queue.emplace(std::move(packagedTask));
-        task_queue_condition.notify_one();
+    // Finishes the queued tasks and joins the threads
+    void Stop();
 
-        return std::move(ret);
-    }
+private:
+    struct Task {
+        const char* name;
+        TaskGroup group;
+        std::function<void()> function;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    struct Worker {
+        std::mutex cs;
+        std::deque<Task> tasks;
+    };
+
+    ParallelOpThreadPool();
+
+    void Post(const char* name, TaskGroup group, std::function<void()> function);
+    bool PopTask(std::size_t first, bool fOwn, Task& task);
+    bool PopGroupTask(TaskGroup group, Task& task);
+    bool RunQueuedTask();
+    bool RunGroupTask(TaskGroup group);
+    void RunTask(Task& task);
+    void StartThreads();
+    void ThreadProc(std::size_t index);
 
-    int GetNumberOfThreads() const {
-        return number_of_threads;
-    }
+private:
+    // guards the threads and the shutdown flag, the workers' queues have their own locks
+    mutable std::mutex cs;
+    std::condition_variable cond;
+    std::vector<std::thread> threads;
+    std::size_t number_of_threads;
+    bool shutdown;
+
+    // queues of all the possible workers, the first active_workers of them are used
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> active_workers;
+    // number of the queued tasks
+    std::atomic<std::size_t> pending;
+    std::atomic<std::size_t> next_worker;
+    std::atomic<TaskGroup> next_group;
+
+    mutable std::mutex cs_stats;
+    std::map<std::string, TaskStats> stats;
 };
 
 
@@ -122,4 +133,4 @@ public:
 };
 
 
-#endif
\ No newline at end of file
+#endif
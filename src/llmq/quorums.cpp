@@ -27,6 +27,12 @@ namespace llmq
 static const std::string DB_QUORUM_SK_SHARE = "q_Qsk";
 static const std::string DB_QUORUM_QUORUM_VVEC = "q_Qqvvec";
 
+// number of public key shares the cache populator builds between checks of whether the quorum is still active
+static const size_t CACHE_POPULATOR_ACTIVE_CHECK_INTERVAL = 16;
+
+// number of quorums kept in the cache besides the ones connections are kept to, recently dropped ones are still asked for
+static const size_t QUORUMS_CACHE_MARGIN = 2;
+
 CQuorumManager* quorumManager;
 
 static uint256 MakeQuorumKey(const CQuorum& q)
@@ -51,32 +57,24 @@ CQuorum::~CQuorum()
     }
 }
 
-void CQuorum::Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const std::vector<CDeterministicMNCPtr>& _members)
+void CQuorum::Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const CQuorumMembersCPtr& _quorumMembers)
 {
     qc = _qc;
     pindexQuorum = _pindexQuorum;
-    members = _members;
+    members = _quorumMembers->members;
+    quorumMembers = _quorumMembers;
     minedBlockHash = _minedBlockHash;
 }
 
 bool CQuorum::IsMember(const uint256& proTxHash) const
 {
-    for (auto& dmn : members) {
-        if (dmn->proTxHash == proTxHash) {
-            return true;
-        }
-    }
-    return false;
+    return GetMemberIndex(proTxHash) != -1;
 }
 
 bool CQuorum::IsValidMember(const uint256& proTxHash) const
 {
-    for (size_t i = 0; i < members.size(); i++) {
-        if (members[i]->proTxHash == proTxHash) {
-            return qc.validMembers[i];
-        }
-    }
-    return false;
+    int memberIdx = GetMemberIndex(proTxHash);
+    return memberIdx != -1 && qc.validMembers[memberIdx];
 }
 
 CBLSPublicKey CQuorum::GetPubKeyShare(size_t memberIdx) const
@@ -93,14 +91,14 @@ CBLSSecretKey CQuorum::GetSkShare() const
     return skShare;
 }
 
+CBLSWorkerCache::Stats CQuorum::GetBLSCacheStats() const
+{
+    return blsCache.GetStats();
+}
+
 int CQuorum::GetMemberIndex(const uint256& proTxHash) const
 {
-    for (size_t i = 0; i < members.size(); i++) {
-        if (members[i]->proTxHash == proTxHash) {
-            return (int)i;
-        }
-    }
-    return -1;
+    return quorumMembers->GetMemberIndex(proTxHash);
 }
 
 void CQuorum::WriteContributions(CEvoDB& evoDb)
@@ -147,11 +145,19 @@ void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
     _this->cachePopulatorThread = std::thread([_this, t]() {
         RenameThread("firo-q-cachepop");
         for (size_t i = 0; i < _this->members.size() && !_this->stopCachePopulatorThread && !ShutdownRequested(); i++) {
+            // quorums which are not active anymore are only asked for a few keys at most, so there is no point in
+            // filling the cache with all of them. Check from time to time as new quorums might get mined meanwhile
+            if (i % CACHE_POPULATOR_ACTIVE_CHECK_INTERVAL == 0 && quorumManager && !quorumManager->IsQuorumActive(_this->params.type, _this->qc.quorumHash)) {
+                LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- quorum %s is not active, stopping\n", _this->qc.quorumHash.ToString());
+                break;
+            }
             if (_this->qc.validMembers[i]) {
                 _this->GetPubKeyShare(i);
             }
         }
-        LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- done. time=%d\n", t.count());
+        auto stats = _this->blsCache.GetStats().publicKeyShare;
+        LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- done. time=%d, pubKeyShares hits=%d misses=%d size=%d\n",
+                 t.count(), stats.hits, stats.misses, stats.size);
     });
 }
 
@@ -160,6 +166,11 @@ CQuorumManager::CQuorumManager(CEvoDB& _evoDb, CBLSWorker& _blsWorker, CDKGSessi
     blsWorker(_blsWorker),
     dkgManager(_dkgManager)
 {
+    for (const auto& p : Params().GetConsensus().llmqs) {
+        // the active quorums and the ones connections are kept to are looked up on every block
+        size_t cacheSize = std::max<size_t>(p.second.keepOldConnections, p.second.signingActiveQuorumCount + 1) + QUORUMS_CACHE_MARGIN;
+        quorumsCache.emplace(std::piecewise_construct, std::forward_as_tuple(p.first), std::forward_as_tuple(cacheSize, cacheSize));
+    }
 }
 
 void CQuorumManager::UpdatedBlockTip(const CBlockIndex* pindexNew, bool fInitialDownload)
@@ -233,9 +244,9 @@ bool CQuorumManager::BuildQuorumFromCommitment(const CFinalCommitment& qc, const
     assert(pindexQuorum);
     assert(qc.quorumHash == pindexQuorum->GetBlockHash());
 
-    auto members = CLLMQUtils::GetAllQuorumMembers((Consensus::LLMQType)qc.llmqType, pindexQuorum);
+    auto quorumMembers = CLLMQUtils::GetQuorumMembers((Consensus::LLMQType)qc.llmqType, pindexQuorum);
 
-    quorum->Init(qc, pindexQuorum, minedBlockHash, members);
+    quorum->Init(qc, pindexQuorum, minedBlockHash, quorumMembers);
 
     bool hasValidVvec = false;
     if (quorum->ReadContributions(evoDb)) {
@@ -358,6 +369,29 @@ std::vector<CQuorumCPtr> CQuorumManager::ScanQuorums(Consensus::LLMQType llmqTyp
     return result;
 }
 
+bool CQuorumManager::IsQuorumActive(Consensus::LLMQType llmqType, const uint256& quorumHash)
+{
+    auto& params = Params().GetConsensus().llmqs.at(llmqType);
+
+    const CBlockIndex* pindexTip;
+    {
+        LOCK(cs_main);
+        pindexTip = chainActive.Tip();
+    }
+    if (!pindexTip) {
+        return false;
+    }
+
+    // one more than signingActiveQuorumCount, so that a quorum is not dropped right when a new one gets mined
+    auto quorumIndexes = quorumBlockProcessor->GetMinedCommitmentsUntilBlock(llmqType, pindexTip, (size_t)params.signingActiveQuorumCount + 1);
+    for (auto& quorumIndex : quorumIndexes) {
+        if (quorumIndex->GetBlockHash() == quorumHash) {
+            return true;
+        }
+    }
+    return false;
+}
+
 CQuorumCPtr CQuorumManager::GetQuorum(Consensus::LLMQType llmqType, const uint256& quorumHash)
 {
     CBlockIndex* pindexQuorum;
@@ -388,9 +422,10 @@ CQuorumCPtr CQuorumManager::GetQuorum(Consensus::LLMQType llmqType, const CBlock
 
     LOCK(quorumsCacheCs);
 
-    auto it = quorumsCache.find(std::make_pair(llmqType, quorumHash));
-    if (it != quorumsCache.end()) {
-        return it->second;
+    auto& cache = quorumsCache.at(llmqType);
+    CQuorumPtr quorum;
+    if (cache.get(quorumHash, quorum)) {
+        return quorum;
     }
 
     CFinalCommitment qc;
@@ -401,13 +436,13 @@ CQuorumCPtr CQuorumManager::GetQuorum(Consensus::LLMQType llmqType, const CBlock
 
     auto& params = Params().GetConsensus().llmqs.at(llmqType);
 
-    auto quorum = std::make_shared<CQuorum>(params, blsWorker);
+    quorum = std::make_shared<CQuorum>(params, blsWorker);
 
     if (!BuildQuorumFromCommitment(qc, pindexQuorum, minedBlockHash, quorum)) {
         return nullptr;
     }
 
-    quorumsCache.emplace(std::make_pair(llmqType, quorumHash), quorum);
+    cache.insert(quorumHash, quorum);
 
     return quorum;
 }
@@ -8,6 +8,7 @@
 #include "evo/evodb.h"
 #include "evo/deterministicmns.h"
 #include "llmq/quorums_commitment.h"
+#include "llmq/quorums_utils.h"
 
 #include "validationinterface.h"
 #include "consensus/params.h"
@@ -46,16 +47,20 @@ public:
     CBLSSecretKey skShare;
 
 private:
+    // the same members, looked up by their proTxHash
+    CQuorumMembersCPtr quorumMembers;
+
     // Recovery of public key shares is very slow, so we start a background thread that pre-populates a cache so that
-    // the public key shares are ready when needed later
+    // the public key shares are ready when needed later. It holds one share per member at most, the shares of old
+    // quorums go away together with the quorums once CQuorumManager drops them from its cache
     mutable CBLSWorkerCache blsCache;
     std::atomic<bool> stopCachePopulatorThread;
     std::thread cachePopulatorThread;
 
 public:
-    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsCache(_blsWorker), stopCachePopulatorThread(false) {}
+    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsCache(_blsWorker, (size_t)_params.size), stopCachePopulatorThread(false) {}
     ~CQuorum();
-    void Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const std::vector<CDeterministicMNCPtr>& _members);
+    void Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const CQuorumMembersCPtr& _quorumMembers);
 
     bool IsMember(const uint256& proTxHash) const;
     bool IsValidMember(const uint256& proTxHash) const;
@@ -63,6 +68,7 @@ public:
 
     CBLSPublicKey GetPubKeyShare(size_t memberIdx) const;
     CBLSSecretKey GetSkShare() const;
+    CBLSWorkerCache::Stats GetBLSCacheStats() const;
 
 private:
     void WriteContributions(CEvoDB& evoDb);
@@ -86,7 +92,8 @@ private:
     CDKGSessionManager& dkgManager;
 
     CCriticalSection quorumsCacheCs;
-    std::map<std::pair<Consensus::LLMQType, uint256>, CQuorumPtr> quorumsCache;
+    // built quorums per LLMQ type, only the recently used ones are kept, the others are built again when asked for
+    std::map<Consensus::LLMQType, unordered_lru_cache<uint256, CQuorumPtr, StaticSaltedHasher>> quorumsCache;
     unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, std::vector<CQuorumCPtr>, StaticSaltedHasher, 32> scanQuorumsCache;
 
 public:
@@ -104,6 +111,10 @@ public:
     // this one is cs_main-free
     std::vector<CQuorumCPtr> ScanQuorums(Consensus::LLMQType llmqType, const CBlockIndex* pindexStart, size_t maxCount);
 
+    // whether the quorum is one of the signingActiveQuorumCount + 1 newest ones at the tip. Locks cs_main for a short
+    // period of time and doesn't build any quorums
+    bool IsQuorumActive(Consensus::LLMQType llmqType, const uint256& quorumHash);
+
 private:
     // all private methods here are cs_main-free
     void EnsureQuorumConnections(Consensus::LLMQType llmqType, const CBlockIndex *pindexNew);
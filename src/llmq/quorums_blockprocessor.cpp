@@ -253,6 +253,9 @@ bool CQuorumBlockProcessor::UndoBlock(const CBlock& block, const CBlockIndex* pi
         AddMinableCommitment(qc);
     }
 
+    // quorums based on this block won't be asked for anymore
+    CLLMQUtils::RemoveQuorumMembersFromCache(pindex->GetBlockHash());
+
     evoDb.Write(DB_BEST_BLOCK_UPGRADE, pindex->pprev->GetBlockHash());
 
     return true;
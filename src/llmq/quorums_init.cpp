@@ -13,6 +13,7 @@
 #include "quorums_instantsend.h"
 #include "quorums_signing.h"
 #include "quorums_signing_shares.h"
+#include "quorums_utils.h"
 
 #include "dbwrapper.h"
 #include "scheduler.h"
@@ -61,6 +62,9 @@ void DestroyLLMQSystem()
     blsWorker = nullptr;
     delete llmqDb;
     llmqDb = nullptr;
+
+    // the members were picked from the masternode lists of the chain the system is torn down with
+    CLLMQUtils::ClearQuorumMembersCache();
 }
 
 void StartLLMQSystem()
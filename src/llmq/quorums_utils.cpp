@@ -12,12 +12,94 @@
 namespace llmq
 {
 
+static CQuorumMembersCache quorumMembersCache;
+
+CQuorumMembers::CQuorumMembers(std::vector<CDeterministicMNCPtr> _members) :
+    members(std::move(_members))
+{
+    memberIndexes.reserve(members.size());
+    for (size_t i = 0; i < members.size(); i++) {
+        memberIndexes.emplace(members[i]->proTxHash, (int)i);
+    }
+}
+
+int CQuorumMembers::GetMemberIndex(const uint256& proTxHash) const
+{
+    auto it = memberIndexes.find(proTxHash);
+    return it != memberIndexes.end() ? it->second : -1;
+}
+
+CQuorumMembersCPtr CQuorumMembersCache::Get(Consensus::LLMQType llmqType, const uint256& quorumHash, size_t quorumSize, const std::function<CDeterministicMNList()>& getMnList)
+{
+    auto key = std::make_pair(llmqType, quorumHash);
+    CQuorumMembersCPtr quorumMembers;
+    {
+        LOCK(cs);
+        if (cache.get(key, quorumMembers)) {
+            hits++;
+            return quorumMembers;
+        }
+        misses++;
+    }
+
+    auto modifier = ::SerializeHash(std::make_pair((uint8_t) llmqType, quorumHash));
+    quorumMembers = std::make_shared<CQuorumMembers>(getMnList().CalculateQuorum(quorumSize, modifier));
+
+    LOCK(cs);
+    cache.insert(key, quorumMembers);
+    return quorumMembers;
+}
+
+void CQuorumMembersCache::RemoveQuorums(const uint256& quorumHash)
+{
+    LOCK(cs);
+    for (const auto& p : Params().GetConsensus().llmqs) {
+        cache.erase(std::make_pair(p.first, quorumHash));
+    }
+}
+
+void CQuorumMembersCache::Clear()
+{
+    LOCK(cs);
+    cache.clear();
+}
+
+CQuorumMembersCache::Stats CQuorumMembersCache::GetStats() const
+{
+    LOCK(cs);
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.size = cache.size();
+    return stats;
+}
+
 std::vector<CDeterministicMNCPtr> CLLMQUtils::GetAllQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum)
+{
+    return GetQuorumMembers(llmqType, pindexQuorum)->members;
+}
+
+CQuorumMembersCPtr CLLMQUtils::GetQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum)
 {
     auto& params = Params().GetConsensus().llmqs.at(llmqType);
-    auto allMns = deterministicMNManager->GetListForBlock(pindexQuorum);
-    auto modifier = ::SerializeHash(std::make_pair((uint8_t) llmqType, pindexQuorum->GetBlockHash()));
-    return allMns.CalculateQuorum(params.size, modifier);
+    return quorumMembersCache.Get(llmqType, pindexQuorum->GetBlockHash(), params.size, [&]() {
+        return deterministicMNManager->GetListForBlock(pindexQuorum);
+    });
+}
+
+void CLLMQUtils::RemoveQuorumMembersFromCache(const uint256& blockHash)
+{
+    quorumMembersCache.RemoveQuorums(blockHash);
+}
+
+void CLLMQUtils::ClearQuorumMembersCache()
+{
+    quorumMembersCache.Clear();
+}
+
+CQuorumMembersCache::Stats CLLMQUtils::GetQuorumMembersCacheStats()
+{
+    return quorumMembersCache.GetStats();
 }
 
 uint256 CLLMQUtils::BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const std::vector<bool>& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash)
@@ -45,29 +127,28 @@ std::set<uint256> CLLMQUtils::GetQuorumConnections(Consensus::LLMQType llmqType,
 {
     auto& params = Params().GetConsensus().llmqs.at(llmqType);
 
-    auto mns = GetAllQuorumMembers(llmqType, pindexQuorum);
+    auto quorumMembers = GetQuorumMembers(llmqType, pindexQuorum);
+    auto& mns = quorumMembers->members;
     std::set<uint256> result;
-    for (size_t i = 0; i < mns.size(); i++) {
+    int memberIdx = quorumMembers->GetMemberIndex(forMember);
+    if (memberIdx >= 0) {
+        size_t i = (size_t)memberIdx;
         auto& dmn = mns[i];
-        if (dmn->proTxHash == forMember) {
-            // Connect to nodes at indexes (i+2^k)%n, where
-            //   k: 0..max(1, floor(log2(n-1))-1)
-            //   n: size of the quorum/ring
-            int gap = 1;
-            int gap_max = (int)mns.size() - 1;
-            int k = 0;
-            while ((gap_max >>= 1) || k <= 1) {
-                size_t idx = (i + gap) % mns.size();
-                auto& otherDmn = mns[idx];
-                if (otherDmn == dmn) {
-                    continue;
-                }
-                result.emplace(otherDmn->proTxHash);
-                gap <<= 1;
-                k++;
+        // Connect to nodes at indexes (i+2^k)%n, where
+        //   k: 0..max(1, floor(log2(n-1))-1)
+        //   n: size of the quorum/ring
+        int gap = 1;
+        int gap_max = (int)mns.size() - 1;
+        int k = 0;
+        while ((gap_max >>= 1) || k <= 1) {
+            size_t idx = (i + gap) % mns.size();
+            auto& otherDmn = mns[idx];
+            if (otherDmn == dmn) {
+                continue;
             }
-            // there can be no two members with the same proTxHash, so return early
-            break;
+            result.emplace(otherDmn->proTxHash);
+            gap <<= 1;
+            k++;
         }
     }
     return result;
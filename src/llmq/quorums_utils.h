@@ -7,19 +7,82 @@
 
 #include "consensus/params.h"
 #include "net.h"
+#include "saltedhasher.h"
+#include "sync.h"
+#include "unordered_lru_cache.h"
 
 #include "evo/deterministicmns.h"
 
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace llmq
 {
 
+// Members of a quorum in the order of their scores, with the index of every member by its proTxHash
+class CQuorumMembers
+{
+public:
+    std::vector<CDeterministicMNCPtr> members;
+
+private:
+    std::unordered_map<uint256, int, StaticSaltedHasher> memberIndexes;
+
+public:
+    explicit CQuorumMembers(std::vector<CDeterministicMNCPtr> _members);
+
+    // -1 if proTxHash is not a member
+    int GetMemberIndex(const uint256& proTxHash) const;
+};
+typedef std::shared_ptr<const CQuorumMembers> CQuorumMembersCPtr;
+
+/**
+ * Picking the members of a quorum scores and sorts every confirmed masternode, and the same few active quorums are
+ * asked for over and over again by the DKG, the signing code and the quorum connections. The members of the most
+ * recently used quorums are kept here. They only depend on the quorum block, so entries stay valid until that block
+ * is disconnected, which is when they are dropped.
+ */
+class CQuorumMembersCache
+{
+public:
+    static const size_t DEFAULT_MAX_SIZE = 64;
+
+    struct Stats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        size_t size{0};
+    };
+
+private:
+    mutable CCriticalSection cs;
+    unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, CQuorumMembersCPtr, StaticSaltedHasher> cache;
+    uint64_t hits{0};
+    uint64_t misses{0};
+
+public:
+    explicit CQuorumMembersCache(size_t maxSize = DEFAULT_MAX_SIZE) : cache(maxSize) {}
+
+    // getMnList is only called when the members have to be calculated, and without holding the cache's lock
+    CQuorumMembersCPtr Get(Consensus::LLMQType llmqType, const uint256& quorumHash, size_t quorumSize, const std::function<CDeterministicMNList()>& getMnList);
+    void RemoveQuorums(const uint256& quorumHash);
+    void Clear();
+    Stats GetStats() const;
+};
+
 class CLLMQUtils
 {
 public:
     // includes members which failed DKG
     static std::vector<CDeterministicMNCPtr> GetAllQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum);
+    // same members, shared from the cache together with their indexes
+    static CQuorumMembersCPtr GetQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum);
+    // called for every disconnected block, the quorums based on it are gone from the chain
+    static void RemoveQuorumMembersFromCache(const uint256& blockHash);
+    // called when the LLMQ system is destroyed
+    static void ClearQuorumMembersCache();
+    static CQuorumMembersCache::Stats GetQuorumMembersCacheStats();
 
     static uint256 BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const std::vector<bool>& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash);
     static uint256 BuildSignHash(Consensus::LLMQType llmqType, const uint256& quorumHash, const uint256& id, const uint256& msgHash);
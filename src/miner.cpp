@@ -1149,7 +1149,7 @@ void static FiroMiner(const CChainParams &chainparams) {
 
                 while (true) {
                     if (pblock->IsProgPow()) {
-                        thash = pblock->GetProgPowHashFull(mix_hash);
+                        thash = pblock->GetProgPowHashFull(mix_hash, true);
                     } else if (pblock->IsMTP()) {
                         thash = mtp::hash(*pblock, Params().GetConsensus().powLimit);
                         pblock->mtpHashValue = thash;
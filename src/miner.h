@@ -24,6 +24,8 @@ namespace Consensus { struct Params; };
 
 static const bool DEFAULT_GENERATE = false;
 static const int DEFAULT_GENERATE_THREADS = 1;
+/** Default for -progpowdataset, whether the miners use the full ProgPow dataset */
+static const bool DEFAULT_PROGPOW_DATASET = false;
 
 static const bool DEFAULT_PRINTPRIORITY = false;
 
@@ -29,6 +29,7 @@
 #include "utilmoneystr.h"
 #include "utilstrencodings.h"
 #include "validationinterface.h"
+#include "lelantus_mempool_verifier.h"
 
 #include "masternode-payments.h"
 #include "masternode-sync.h"
@@ -312,6 +313,8 @@ void FinalizeNode(NodeId nodeid, bool& fUpdateConnectionTime) {
         mapBlocksInFlight.erase(entry.hash);
     }
     EraseOrphansFor(nodeid);
+    if (lelantus::mempoolVerifier)
+        lelantus::mempoolVerifier->RemovePeer(nodeid);
     nPreferredDownload -= state->fPreferredDownload;
     nPeersWithValidatedDownloads -= (state->nBlocksInFlightValidHeaders != 0);
     assert(nPeersWithValidatedDownloads >= 0);
@@ -940,6 +943,7 @@ bool static AlreadyHave(const CInv& inv) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
             return (recentRejects->contains(inv.hash) && !llmq::quorumInstantSendManager->IsLocked(inv.hash)) ||
                    mempool.exists(inv.hash) ||
                    mapOrphanTransactions.count(inv.hash) ||
+                   (lelantus::mempoolVerifier && lelantus::mempoolVerifier->IsQueued(inv.hash)) ||
                    pcoinsTip->HaveCoinInCache(COutPoint(inv.hash, 0)) || // Best effort: only try output 0 and 1
                    pcoinsTip->HaveCoinInCache(COutPoint(inv.hash, 1));
         }
@@ -2082,7 +2086,15 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 
         std::list<CTransactionRef> lRemovedTxn;
 
-        if (!AlreadyHave(inv) && AcceptToMemoryPool(mempool, state, ptx, true, &fMissingInputs, &lRemovedTxn, false, 0, true)) {
+        // JoinSplit proofs are batch verified without holding cs_main, the transaction comes back here once they are checked
+        if (tx.IsLelantusJoinSplit() && lelantus::mempoolVerifier && !lelantus::mempoolVerifier->IsVerified(inv.hash) &&
+                !AlreadyHave(inv) && lelantus::mempoolVerifier->Submit(ptx, pfrom->GetId(), state)) {
+            return true;
+        }
+
+        // the transaction is verified once for both the mempool and the stem pool
+        CTxPoolAcceptChecks checks(tx);
+        if (state.IsValid() && !AlreadyHave(inv) && AcceptToMemoryPool(mempool, state, ptx, true, &fMissingInputs, &lRemovedTxn, false, 0, true, true, &checks)) {
             LogPrintf("Transaction %s received and added to the mempool.\n", tx.GetHash().ToString());
 
             // Changes to mempool should also be made to Dandelion stempool.
@@ -2096,7 +2108,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 false, /* fOverrideMempoolLimit */
                 0, /* nAbsurdFee */
                 true, /* isCheckWalletTransaction */
-                false /* markFiroSpendTransactionSerial */
+                false, /* markFiroSpendTransactionSerial */
+                &checks
             );
 
             if (CNode::isTxDandelionEmbargoed(tx.GetHash())) {
@@ -2141,7 +2154,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 
                     if (setMisbehaving.count(fromPeer))
                         continue;
-                    if (AcceptToMemoryPool(mempool, stateDummy, porphanTx, true, &fMissingInputs2, &lRemovedTxn, false, 0, true)) {
+                    CTxPoolAcceptChecks orphanChecks(orphanTx);
+                    if (AcceptToMemoryPool(mempool, stateDummy, porphanTx, true, &fMissingInputs2, &lRemovedTxn, false, 0, true, true, &orphanChecks)) {
                         LogPrint("mempool", "   accepted orphan tx %s\n", orphanHash.ToString());
 
                         // Changes to mempool should also be made to Dandelion stempool
@@ -2155,7 +2169,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                             false, /* fOverrideMempoolLimit */
                             0, /* nAbsurdFee */
                             true, /* isCheckWalletTransaction */
-                            false /* markFiroSpendTransactionSerial */
+                            false, /* markFiroSpendTransactionSerial */
+                            &orphanChecks
                         );
 
                         connman.RelayTransaction(orphanTx);
@@ -2991,14 +3006,14 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         CGetSimplifiedMNListDiff cmd;
         vRecv >> cmd;
 
-        LOCK(cs_main);
-
+        // takes cs_main itself when the diff has to be built
         CSimplifiedMNListDiff mnListDiff;
         std::string strError;
         if (BuildSimplifiedMNListDiff(cmd.baseBlockHash, cmd.blockHash, mnListDiff, strError)) {
             connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::MNLISTDIFF, mnListDiff));
         } else {
             LogPrint("net", "getmnlistdiff failed for baseBlockHash=%s, blockHash=%s. error=%s\n", cmd.baseBlockHash.ToString(), cmd.blockHash.ToString(), strError);
+            LOCK(cs_main);
             Misbehaving(pfrom->id, 1);
         }
     }
@@ -3081,6 +3096,30 @@ static bool SendRejectsAndCheckIfBanned(CNode* pnode, CConnman& connman)
     return false;
 }
 
+// JoinSplits with verified proofs continue on their way to the mempool, the invalid ones are rejected
+void static ProcessVerifiedJoinSplits(CNode* pfrom, const CChainParams& chainparams, CConnman& connman, const std::atomic<bool>& interruptMsgProc)
+{
+    for (const auto& result : lelantus::mempoolVerifier->TakeResults(pfrom->GetId())) {
+        if (result.fValid) {
+            CDataStream txMsg(SER_NETWORK, PROTOCOL_VERSION);
+            txMsg << result.tx;
+            ProcessMessage(pfrom, NetMsgType::TX, txMsg, GetTimeMicros(), chainparams, connman, interruptMsgProc);
+            lelantus::mempoolVerifier->Erase(result.tx->GetHash());
+            continue;
+        }
+
+        const uint256& hash = result.tx->GetHash();
+        LogPrint("mempoolrej", "%s from peer=%d was not accepted: invalid joinsplit proofs\n", hash.ToString(), pfrom->id);
+
+        LOCK(cs_main);
+        assert(recentRejects);
+        recentRejects->insert(hash);
+        connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::REJECT, std::string(NetMsgType::TX),
+                (unsigned char)REJECT_INVALID, std::string("bad-txns-lelantus-proof"), hash));
+        Misbehaving(pfrom->GetId(), 100);
+    }
+}
+
 bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& interruptMsgProc)
 {
     const CChainParams& chainparams = Params();
@@ -3103,6 +3142,9 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
     // this maintains the order of responses
     if (!pfrom->vRecvGetData.empty()) return true;
 
+    if (lelantus::mempoolVerifier)
+        ProcessVerifiedJoinSplits(pfrom, chainparams, connman, interruptMsgProc);
+
         // Don't bother if send buffer is too full to respond anyway
         if (pfrom->fPauseSend)
             return false;
@@ -104,8 +104,8 @@ uint256 CBlockHeader::GetProgPowHeaderHash() const
     return SerializeHash(GetProgPowHeader());
 }
 
-uint256 CBlockHeader::GetProgPowHashFull(uint256& mix_hash) const {
-    return progpow_hash_full(GetProgPowHeader(), mix_hash);
+uint256 CBlockHeader::GetProgPowHashFull(uint256& mix_hash, bool fUseFullDataset) const {
+    return progpow_hash_full(GetProgPowHeader(), mix_hash, fUseFullDataset);
 }
 
 uint256 CBlockHeader::GetProgPowHashLight() const {
@@ -268,7 +268,7 @@ public:
 
     CProgPowHeader GetProgPowHeader() const;
     uint256 GetProgPowHeaderHash() const;
-    uint256 GetProgPowHashFull(uint256& mix_hash) const;
+    uint256 GetProgPowHashFull(uint256& mix_hash, bool fUseFullDataset = false) const;
     uint256 GetProgPowHashLight() const;
 
 };
@@ -34,4 +34,15 @@ uint256 GetPubCoinValueHash(const secp_primitives::GroupElement& bnValue) {
     return Hash(ss.begin(), ss.end());
 }
 
+std::vector<uint256> GetPubCoinValueHashes(const std::vector<secp_primitives::GroupElement>& values) {
+    std::vector<unsigned char> buffer(values.size() * secp_primitives::GroupElement::serialize_size);
+    secp_primitives::GroupElement::serialize_all(values, buffer.data());
+
+    std::vector<uint256> hashes;
+    hashes.reserve(values.size());
+    for (auto it = buffer.begin(); it != buffer.end(); it += secp_primitives::GroupElement::serialize_size)
+        hashes.push_back(Hash(it, it + secp_primitives::GroupElement::serialize_size));
+    return hashes;
+}
+
 }
@@ -270,6 +270,8 @@ public:
 namespace primitives {
 uint256 GetSerialHash(const secp_primitives::Scalar& bnSerial);
 uint256 GetPubCoinValueHash(const secp_primitives::GroupElement& bnValue);
+// Same as GetPubCoinValueHash for every value, with one shared affine conversion for all of them
+std::vector<uint256> GetPubCoinValueHashes(const std::vector<secp_primitives::GroupElement>& values);
 }
 
 #endif //PRIMITIVES_MINT_SPEND_H
@@ -0,0 +1,122 @@
+#include "proof_cache.h"
+
+#include "crypto/sha256.h"
+#include "random.h"
+#include "util.h"
+
+#include "cuckoocache.h"
+#include <boost/thread.hpp>
+
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+/**
+ * Entries are nonced hashes, so they don't need extra blinding in the set hash computation.
+ */
+class ProofCacheHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const uint256& key) const
+    {
+        static_assert(hash_select <8, "ProofCacheHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, key.begin()+4*hash_select, 4);
+        return u;
+    }
+};
+
+class CProofCache
+{
+private:
+    //! Entries are SHA256(nonce || proofs key)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, ProofCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_proofcache;
+    size_t nMaxEntries;
+
+public:
+    std::atomic<uint64_t> nHits;
+    std::atomic<uint64_t> nMisses;
+    std::atomic<uint64_t> nInserts;
+
+    CProofCache() : nMaxEntries(0), nHits(0), nMisses(0), nInserts(0)
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(uint256& entry, const uint256& key)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(key.begin(), 32).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_proofcache);
+        return setValid.contains(entry, false);
+    }
+
+    void Set(uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_proofcache);
+        setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_proofcache);
+        nMaxEntries = setValid.setup_bytes(n);
+        return nMaxEntries;
+    }
+
+    size_t max_entries()
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_proofcache);
+        return nMaxEntries;
+    }
+};
+
+static CProofCache proofCache;
+}
+
+void InitProofCache()
+{
+    // If -maxproofcachesize is set to zero, setup_bytes creates the minimum possible cache (2 elements).
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, GetArg("-maxproofcachesize", DEFAULT_MAX_PROOF_CACHE_SIZE)), MAX_MAX_PROOF_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = proofCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for proof cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+bool IsProofCached(const uint256& key)
+{
+    uint256 entry;
+    proofCache.ComputeEntry(entry, key);
+    if (proofCache.Get(entry)) {
+        proofCache.nHits++;
+        return true;
+    }
+    proofCache.nMisses++;
+    return false;
+}
+
+void AddProofToCache(const uint256& key)
+{
+    uint256 entry;
+    proofCache.ComputeEntry(entry, key);
+    proofCache.Set(entry);
+    proofCache.nInserts++;
+}
+
+ProofCacheStats GetProofCacheStats()
+{
+    ProofCacheStats stats;
+    stats.nMaxEntries = proofCache.max_entries();
+    stats.nHits = proofCache.nHits;
+    stats.nMisses = proofCache.nMisses;
+    stats.nInserts = proofCache.nInserts;
+    return stats;
+}
@@ -0,0 +1,38 @@
+#ifndef FIRO_PROOF_CACHE_H
+#define FIRO_PROOF_CACHE_H
+
+#include "uint256.h"
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Cache of the Sigma and Lelantus spend proofs verified successfully, to avoid doing the expensive proof
+ * verification again when the transaction is checked for the block template and once more when the block is
+ * connected. The keys identify the transaction together with the anonymity sets the proofs were checked against.
+ */
+
+// Limit the size of the verified proofs cache to 8MB, over 250000 entries on 64-bit systems
+static const unsigned int DEFAULT_MAX_PROOF_CACHE_SIZE = 8;
+// Maximum proof cache size allowed
+static const int64_t MAX_MAX_PROOF_CACHE_SIZE = 16384;
+
+// Hit and miss counters of the proof cache
+struct ProofCacheStats {
+    size_t nMaxEntries;
+    uint64_t nHits;
+    uint64_t nMisses;
+    uint64_t nInserts;
+};
+
+// To be called once in AppInit2/TestingSetup to initialize the proof cache
+void InitProofCache();
+
+// Whether the proofs with the given key were verified already, counts the hits and misses
+bool IsProofCached(const uint256& key);
+// Remembers the proofs with the given key as verified
+void AddProofToCache(const uint256& key);
+
+ProofCacheStats GetProofCacheStats();
+
+#endif //FIRO_PROOF_CACHE_H
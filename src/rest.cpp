@@ -10,6 +10,7 @@
 #include "validation.h"
 #include "httpserver.h"
 #include "rpc/server.h"
+#include "sigma_sync_cache.h"
 #include "streams.h"
 #include "sync.h"
 #include "txmempool.h"
@@ -591,6 +592,90 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
     return true; // continue to process further HTTP reqs on this cxn
 }
 
+template <typename Delta>
+static bool rest_sigma_reply(HTTPRequest* req, RetFormat rf, const Delta& delta, UniValue (*toJSON)(const Delta&))
+{
+    switch (rf) {
+    case RF_BINARY: {
+        CDataStream ssDelta(SER_NETWORK, PROTOCOL_VERSION);
+        ssDelta << delta;
+        std::string binaryDelta = ssDelta.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryDelta);
+        return true;
+    }
+
+    case RF_HEX: {
+        CDataStream ssDelta(SER_NETWORK, PROTOCOL_VERSION);
+        ssDelta << delta;
+        std::string strHex = HexStr(ssDelta.begin(), ssDelta.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        std::string strJSON = toJSON(delta).write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
+static bool rest_sigma_anonymityset(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 2 && path.size() != 3)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Use /rest/sigma/anonymityset/<denomination>/<groupid>[/<startblockhash>].<ext>.");
+
+    sigma::CoinDenomination denomination;
+    int64_t intDenom = atoi64(path[0]);
+    if (!sigma::IntegerToDenomination(intDenom, denomination))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid denomination: " + path[0]);
+
+    int coinGroupId = atoi(path[1]);
+    if (coinGroupId < 1)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid group id: " + path[1]);
+
+    uint256 startBlockHash;
+    if (path.size() == 3 && !ParseHashStr(path[2], startBlockHash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + path[2]);
+
+    return rest_sigma_reply(req, rf,
+            sigma::CSyncCache::GetInstance().GetAnonymitySet(denomination, coinGroupId, startBlockHash),
+            &sigma::AnonymitySetDeltaToJSON);
+}
+
+static bool rest_sigma_usedserials(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+
+    // the start block hash is optional, /rest/sigma/usedserials.<ext> returns all the serials
+    uint256 startBlockHash;
+    if (!param.empty()) {
+        if (param[0] != '/' || !ParseHashStr(param.substr(1), startBlockHash))
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + param);
+    }
+
+    return rest_sigma_reply(req, rf,
+            sigma::CSyncCache::GetInstance().GetUsedSerials(startBlockHash),
+            &sigma::UsedSerialsDeltaToJSON);
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -603,6 +688,8 @@ static const struct {
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/sigma/anonymityset/", rest_sigma_anonymityset},
+      {"/rest/sigma/usedserials", rest_sigma_usedserials},
 };
 
 bool StartREST()
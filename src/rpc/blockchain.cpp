@@ -28,6 +28,7 @@
 
 #include "llmq/quorums_chainlocks.h"
 #include "llmq/quorums_instantsend.h"
+#include "proof_cache.h"
 
 #include <stdint.h>
 
@@ -1431,6 +1432,34 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
     return mempoolInfoToJSON();
 }
 
+UniValue getproofcacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getproofcacheinfo\n"
+            "\nReturns details on the cache of verified Sigma and Lelantus spend proofs.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"maxentries\": xxxxx,         (numeric) Maximum number of proofs the cache holds\n"
+            "  \"hits\": xxxxx,               (numeric) Number of proofs found in the cache since startup\n"
+            "  \"misses\": xxxxx,             (numeric) Number of proofs not found in the cache since startup\n"
+            "  \"inserts\": xxxxx             (numeric) Number of proofs added to the cache since startup\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getproofcacheinfo", "")
+            + HelpExampleRpc("getproofcacheinfo", "")
+        );
+
+    ProofCacheStats stats = GetProofCacheStats();
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("maxentries", (int64_t)stats.nMaxEntries));
+    ret.push_back(Pair("hits", (int64_t)stats.nHits));
+    ret.push_back(Pair("misses", (int64_t)stats.nMisses));
+    ret.push_back(Pair("inserts", (int64_t)stats.nInserts));
+    return ret;
+}
+
 UniValue preciousblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1667,6 +1696,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  true,  {"txid","verbose"} },
     { "blockchain",         "getmempoolentry",        &getmempoolentry,        true,  {"txid"} },
     { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         true,  {} },
+    { "blockchain",         "getproofcacheinfo",      &getproofcacheinfo,      true,  {} },
     { "blockchain",         "getrawmempool",          &getrawmempool,          true,  {"verbose"} },
     { "blockchain",         "clearmempool",           &clearmempool,           true,  {} },
     { "blockchain",         "getspecialtxes",         &getspecialtxes,         true,  {"blockhash", "type", "count", "skip", "verbosity"} },
@@ -22,6 +22,7 @@
 #include "txdb.h"
 
 #include "masternode-sync.h"
+#include "sigma_sync_cache.h"
 
 #include <stdint.h>
 
@@ -640,6 +641,129 @@ bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     return a.second.time < b.second.time;
 }
 
+namespace {
+// Position a paged address query resumes from: the address and the first index key not returned yet
+template <typename Key>
+struct AddressCursor {
+    uint32_t nAddress = 0;
+    Key key;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nAddress);
+        READWRITE(key);
+    }
+};
+
+// Returns the page size, 0 if the result is not to be paged
+size_t getPageLimitFromParams(const UniValue& params)
+{
+    if (!params[0].isObject())
+        return 0;
+
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
+    if (limitValue.isNull())
+        return 0;
+    if (!limitValue.isNum() || limitValue.get_int64() <= 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Limit is expected to be a positive number");
+    return limitValue.get_int64();
+}
+
+template <typename Key>
+std::string encodeAddressCursor(const AddressCursor<Key>& cursor)
+{
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << cursor;
+    return HexStr(ss.begin(), ss.end());
+}
+
+// Reads the cursor of the previous page if there is one, the key has to belong to the address it points to
+template <typename Key>
+bool getAddressCursorFromParams(const UniValue& params, const std::vector<std::pair<uint160, AddressType> >& addresses,
+                                AddressCursor<Key>& cursor)
+{
+    UniValue cursorValue = find_value(params[0].get_obj(), "cursor");
+    if (cursorValue.isNull())
+        return false;
+    if (!cursorValue.isStr() || !IsHex(cursorValue.get_str()))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+
+    try {
+        CDataStream ss(ParseHex(cursorValue.get_str()), SER_NETWORK, PROTOCOL_VERSION);
+        ss >> cursor;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+
+    if (cursor.nAddress >= addresses.size()
+            || addresses[cursor.nAddress].first != cursor.key.hashBytes
+            || addresses[cursor.nAddress].second != cursor.key.type)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    return true;
+}
+
+/*
+ * Walks the address index entries of the addresses one after another from the cursor on, stopping once handle
+ * returns false for an entry. Returns the cursor pointing to that entry then.
+ */
+boost::optional<AddressCursor<CAddressIndexKey> > walkAddressIndex(const UniValue& params,
+        const std::vector<std::pair<uint160, AddressType> >& addresses, int start, int end,
+        const std::function<bool(const CAddressIndexKey&, CAmount)>& handle)
+{
+    AddressCursor<CAddressIndexKey> cursor;
+    bool fResume = getAddressCursorFromParams(params, addresses, cursor);
+
+    boost::optional<AddressCursor<CAddressIndexKey> > next;
+    for (uint32_t nAddress = cursor.nAddress; nAddress < addresses.size() && !next; nAddress++) {
+        CAddressIndexKey startKey = fResume && nAddress == cursor.nAddress ? cursor.key
+            : CAddressIndexKey(addresses[nAddress].second, addresses[nAddress].first, start, 0, uint256(), 0, false);
+
+        auto handleEntry = [&](const CAddressIndexKey& key, CAmount amount) {
+            if (handle(key, amount))
+                return true;
+            next = AddressCursor<CAddressIndexKey>();
+            next->nAddress = nAddress;
+            next->key = key;
+            return false;
+        };
+        if (!GetAddressIndex(startKey, end, handleEntry)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+    }
+    return next;
+}
+
+// Same as walkAddressIndex for the unspent outputs of the addresses
+boost::optional<AddressCursor<CAddressUnspentKey> > walkAddressUnspent(const UniValue& params,
+        const std::vector<std::pair<uint160, AddressType> >& addresses,
+        const std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)>& handle)
+{
+    AddressCursor<CAddressUnspentKey> cursor;
+    bool fResume = getAddressCursorFromParams(params, addresses, cursor);
+
+    boost::optional<AddressCursor<CAddressUnspentKey> > next;
+    for (uint32_t nAddress = cursor.nAddress; nAddress < addresses.size() && !next; nAddress++) {
+        CAddressUnspentKey startKey = fResume && nAddress == cursor.nAddress ? cursor.key
+            : CAddressUnspentKey(addresses[nAddress].second, addresses[nAddress].first, uint256(), 0);
+
+        auto handleEntry = [&](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+            if (handle(key, value))
+                return true;
+            next = AddressCursor<CAddressUnspentKey>();
+            next->nAddress = nAddress;
+            next->key = key;
+            return false;
+        };
+        if (!GetAddressUnspent(startKey, handleEntry)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+    }
+    return next;
+}
+}
+
 UniValue getaddressmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -723,6 +847,8 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
                         "      \"address\"  (string) The base58check encoded address\n"
                         "      ,...\n"
                         "    ]\n"
+                        "  \"limit\" (number, optional) Return at most this many outputs, in index order, and a cursor to the rest\n"
+                        "  \"cursor\" (string, optional) The cursor returned with the previous page\n"
                         "}\n"
                         "\nResult\n"
                         "[\n"
@@ -735,8 +861,14 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
                         "    \"height\"  (number) The block height\n"
                         "  }\n"
                         "]\n"
+                        "\nResult with a limit\n"
+                        "{\n"
+                        "  \"utxos\"  (array) The outputs as above\n"
+                        "  \"cursor\"  (string) The cursor to pass for the next page, missing on the last one\n"
+                        "}\n"
                         "\nExamples:\n"
                 + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+                + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
                 + HelpExampleRpc("getaddressutxos", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
@@ -746,6 +878,38 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    auto outputToJSON = [](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+        UniValue output(UniValue::VOBJ);
+        std::string address;
+        if (!getAddressFromIndex(key.type, key.hashBytes, address)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+        }
+
+        output.push_back(Pair("address", address));
+        output.push_back(Pair("txid", key.txhash.GetHex()));
+        output.push_back(Pair("outputIndex", (int)key.index));
+        output.push_back(Pair("script", HexStr(value.script.begin(), value.script.end())));
+        output.push_back(Pair("satoshis", value.satoshis));
+        output.push_back(Pair("height", value.blockHeight));
+        return output;
+    };
+
+    if (size_t limit = getPageLimitFromParams(request.params)) {
+        UniValue utxos(UniValue::VARR);
+        auto next = walkAddressUnspent(request.params, addresses, [&](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+            if (utxos.size() >= limit)
+                return false;
+            utxos.push_back(outputToJSON(key, value));
+            return true;
+        });
+
+        UniValue result(UniValue::VOBJ);
+        result.push_back(Pair("utxos", utxos));
+        if (next)
+            result.push_back(Pair("cursor", encodeAddressCursor(*next)));
+        return result;
+    }
+
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
 
     for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -759,19 +923,7 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
     UniValue result(UniValue::VARR);
 
     for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=unspentOutputs.begin(); it!=unspentOutputs.end(); it++) {
-        UniValue output(UniValue::VOBJ);
-        std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-        }
-
-        output.push_back(Pair("address", address));
-        output.push_back(Pair("txid", it->first.txhash.GetHex()));
-        output.push_back(Pair("outputIndex", (int)it->first.index));
-        output.push_back(Pair("script", HexStr(it->second.script.begin(), it->second.script.end())));
-        output.push_back(Pair("satoshis", it->second.satoshis));
-        output.push_back(Pair("height", it->second.blockHeight));
-        result.push_back(output);
+        result.push_back(outputToJSON(it->first, it->second));
     }
 
     return result;
@@ -792,6 +944,8 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
                         "    ]\n"
                         "  \"start\" (number) The start block height\n"
                         "  \"end\" (number) The end block height\n"
+                        "  \"limit\" (number, optional) Return at most this many deltas and a cursor to the rest\n"
+                        "  \"cursor\" (string, optional) The cursor returned with the previous page\n"
                         "}\n"
                         "\nResult:\n"
                         "[\n"
@@ -804,6 +958,11 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
                         "    \"address\"  (string) The base58check encoded address\n"
                         "  }\n"
                         "]\n"
+                        "\nResult with a limit:\n"
+                        "{\n"
+                        "  \"deltas\"  (array) The deltas as above\n"
+                        "  \"cursor\"  (string) The cursor to pass for the next page, missing on the last one\n"
+                        "}\n"
                         "\nExamples:\n"
                 + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
                 + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
@@ -830,6 +989,40 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    auto deltaToJSON = [](const CAddressIndexKey& key, CAmount amount) {
+        std::string address;
+        if (!getAddressFromIndex(key.type, key.hashBytes, address)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+        }
+
+        UniValue delta(UniValue::VOBJ);
+        delta.push_back(Pair("satoshis", amount));
+        delta.push_back(Pair("txid", key.txhash.GetHex()));
+        delta.push_back(Pair("index", (int)key.index));
+        delta.push_back(Pair("blockindex", (int)key.txindex));
+        delta.push_back(Pair("height", key.blockHeight));
+        delta.push_back(Pair("address", address));
+        return delta;
+    };
+
+    if (size_t limit = getPageLimitFromParams(request.params)) {
+        UniValue deltas(UniValue::VARR);
+        bool fRange = start > 0 && end > 0;
+        auto next = walkAddressIndex(request.params, addresses, fRange ? start : 0, fRange ? end : 0,
+                [&](const CAddressIndexKey& key, CAmount amount) {
+            if (deltas.size() >= limit)
+                return false;
+            deltas.push_back(deltaToJSON(key, amount));
+            return true;
+        });
+
+        UniValue result(UniValue::VOBJ);
+        result.push_back(Pair("deltas", deltas));
+        if (next)
+            result.push_back(Pair("cursor", encodeAddressCursor(*next)));
+        return result;
+    }
+
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
     for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -847,19 +1040,7 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
     UniValue result(UniValue::VARR);
 
     for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-        }
-
-        UniValue delta(UniValue::VOBJ);
-        delta.push_back(Pair("satoshis", it->second));
-        delta.push_back(Pair("txid", it->first.txhash.GetHex()));
-        delta.push_back(Pair("index", (int)it->first.index));
-        delta.push_back(Pair("blockindex", (int)it->first.txindex));
-        delta.push_back(Pair("height", it->first.blockHeight));
-        delta.push_back(Pair("address", address));
-        result.push_back(delta);
+        result.push_back(deltaToJSON(it->first, it->second));
     }
 
     return result;
@@ -883,6 +1064,8 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
                         "{\n"
                         "  \"balance\"  (string) The current balance in duffs\n"
                         "  \"received\"  (string) The total number of duffs received (including change)\n"
+                        "  \"txcount\"  (numeric) The number of transactions, summed over the addresses\n"
+                        "  \"utxocount\"  (numeric) The number of unspent outputs\n"
                         "}\n"
                         "\nExamples:\n"
                 + HelpExampleCli("getaddressbalance", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
@@ -895,27 +1078,21 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    CAddressBalanceValue total;
 
     for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+        CAddressBalanceValue balance;
+        if (!GetAddressBalance((*it).first, (*it).second, balance)) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
         }
-    }
-
-    CAmount balance = 0;
-    CAmount received = 0;
-
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        if (it->second > 0) {
-            received += it->second;
-        }
-        balance += it->second;
+        total += balance;
     }
 
     UniValue result(UniValue::VOBJ);
-    result.push_back(Pair("balance", balance));
-    result.push_back(Pair("received", received));
+    result.push_back(Pair("balance", total.balance));
+    result.push_back(Pair("received", total.received));
+    result.push_back(Pair("txcount", total.txCount));
+    result.push_back(Pair("utxocount", total.unspentCount));
 
     return result;
 
@@ -923,7 +1100,7 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
 
 UniValue getanonymityset(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() != 2)
+    if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
         throw std::runtime_error(
                 "getanonymityset\n"
                         "\nReturns the anonymity set and latest block hash.\n"
@@ -931,11 +1108,13 @@ UniValue getanonymityset(const JSONRPCRequest& request)
                         "{\n"
                         "      \"denomination\"  (int64_t) int denomination\n"
                         "      \"coinGroupId\"  (int)\n"
+                        "      \"startBlockHash\"  (string, optional) blockHash of a previous response, only the coins added since are returned\n"
                         "}\n"
                         "\nResult:\n"
                         "{\n"
                         "  \"blockHash\"   (string) Latest block hash for anonymity set\n"
-                        "  \"anonymityset\"(std::string[]) array of Serialized GroupElements\n"
+                        "  \"full\"        (bool) Whether the whole set is returned, new coins are to be put in front of the known ones otherwise\n"
+                        "  \"serializedCoins\"(std::string[]) array of Serialized GroupElements, latest first\n"
                         "}\n"
                 + HelpExampleCli("getanonymityset", "100000000 1")
                 + HelpExampleRpc("getanonymityset", "\"100000000\", \"1\"")
@@ -954,32 +1133,12 @@ UniValue getanonymityset(const JSONRPCRequest& request)
     sigma::CoinDenomination denomination;
     sigma::IntegerToDenomination(intDenom, denomination);
 
-    uint256 blockHash;
-    std::vector<sigma::PublicCoin> coins;
+    uint256 startBlockHash;
+    if (request.params.size() > 2 && !request.params[2].get_str().empty())
+        startBlockHash = ParseHashV(request.params[2], "startBlockHash");
 
-    {
-        LOCK(cs_main);
-        sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-        sigmaState->GetCoinSetForSpend(
-                &chainActive,
-                chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1),
-                denomination,
-                coinGroupId,
-                blockHash,
-                coins);
-    }
-
-    UniValue serializedCoins(UniValue::VARR);
-    for(sigma::PublicCoin const & coin : coins) {
-        std::vector<unsigned char> vch = coin.getValue().getvch();
-        serializedCoins.push_back(HexStr(vch.begin(), vch.end()));
-    }
-
-    UniValue ret(UniValue::VOBJ);
-    ret.push_back(Pair("blockHash", blockHash.GetHex()));
-    ret.push_back(Pair("serializedCoins", serializedCoins));
-
-    return ret;
+    return sigma::AnonymitySetDeltaToJSON(
+            sigma::CSyncCache::GetInstance().GetAnonymitySet(denomination, coinGroupId, startBlockHash));
 }
 
 UniValue getmintmetadata(const JSONRPCRequest& request)
@@ -1009,22 +1168,32 @@ UniValue getmintmetadata(const JSONRPCRequest& request)
     if (!mintValues.isArray()) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "mints is expected to be an array");
     }
-    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-    UniValue ret(UniValue::VARR);
-    for(UniValue const & mintData : mintValues.getValues()){
+    const std::vector<UniValue>& mints = mintValues.getValues();
+    const size_t serializeSize = secp_primitives::GroupElement::serialize_size;
+
+    // decode all the pubcoins in one go
+    std::vector<unsigned char> serializedCoins;
+    serializedCoins.reserve(mints.size() * serializeSize);
+    for(UniValue const & mintData : mints){
         std::vector<unsigned char> serializedCoin = ParseHex(find_value(mintData, "pubcoin").get_str().c_str());
+        serializedCoin.resize(serializeSize);
+        serializedCoins.insert(serializedCoins.end(), serializedCoin.begin(), serializedCoin.end());
+    }
 
-        secp_primitives::GroupElement pubCoin;
-        pubCoin.deserialize(serializedCoin.data());
+    std::vector<secp_primitives::GroupElement> pubCoins;
+    secp_primitives::GroupElement::deserialize_all(serializedCoins.data(), mints.size(), pubCoins);
 
-        int64_t intDenom = find_value(mintData, "denom").get_int64();
+    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+    UniValue ret(UniValue::VARR);
+    for(size_t i = 0; i < mints.size(); i++){
+        int64_t intDenom = find_value(mints[i], "denom").get_int64();
         sigma::CoinDenomination denomination;
         sigma::IntegerToDenomination(intDenom, denomination);
 
         std::pair<int, int> coinHeightAndId;
         {
             LOCK(cs_main);
-            coinHeightAndId = sigmaState->GetMintedCoinHeightAndId(sigma::PublicCoin(pubCoin, denomination));
+            coinHeightAndId = sigmaState->GetMintedCoinHeightAndId(sigma::PublicCoin(pubCoins[i], denomination));
         }
         UniValue metaData(UniValue::VOBJ);
         metaData.pushKV(std::to_string(coinHeightAndId.first), coinHeightAndId.second);
@@ -1035,31 +1204,25 @@ UniValue getmintmetadata(const JSONRPCRequest& request)
 
 UniValue getusedcoinserials(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() != 0)
+    if (request.fHelp || request.params.size() > 1)
         throw std::runtime_error(
                 "getusedcoinserials\n"
                 "\nReturns the set of used coin serial.\n"
+                "\nArguments:\n"
+                "1. \"startBlockHash\" (string, optional) blockHash of a previous response, only the serials used since are returned\n"
                 "\nResult:\n"
                 "{\n"
+                "  \"blockHash\" (string) Tip the serials are taken at\n"
+                "  \"full\"      (bool) Whether all the used serials are returned\n"
                 "  \"serials\" (std::string[]) array of Serialized Scalars\n"
                 "}\n"
         );
 
-    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-    sigma::spend_info_container serials;
-    {
-        LOCK(cs_main);
-        serials = sigmaState->GetSpends();
-    }
-
-    UniValue serializedSerials(UniValue::VARR);
-    for ( auto it = serials.begin(); it != serials.end(); ++it )
-        serializedSerials.push_back(it->first.GetHex());
-
-    UniValue ret(UniValue::VOBJ);
-    ret.push_back(Pair("serials", serializedSerials));
+    uint256 startBlockHash;
+    if (request.params.size() > 0 && !request.params[0].get_str().empty())
+        startBlockHash = ParseHashV(request.params[0], "startBlockHash");
 
-    return ret;
+    return sigma::UsedSerialsDeltaToJSON(sigma::CSyncCache::GetInstance().GetUsedSerials(startBlockHash));
 }
 
 UniValue getlatestcoinids(const JSONRPCRequest& request)
@@ -1117,12 +1280,19 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
                         "    ]\n"
                         "  \"start\" (number) The start block height\n"
                         "  \"end\" (number) The end block height\n"
+                        "  \"limit\" (number, optional) Return at most this many txids, address by address, and a cursor to the rest\n"
+                        "  \"cursor\" (string, optional) The cursor returned with the previous page\n"
                         "}\n"
                         "\nResult:\n"
                         "[\n"
                         "  \"transactionid\"  (string) The transaction id\n"
                         "  ,...\n"
                         "]\n"
+                        "\nResult with a limit:\n"
+                        "{\n"
+                        "  \"txids\"  (array) The transaction ids as above\n"
+                        "  \"cursor\"  (string) The cursor to pass for the next page, missing on the last one\n"
+                        "}\n"
                         "\nExamples:\n"
                 + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
                 + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
@@ -1145,6 +1315,29 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
         }
     }
 
+    if (size_t limit = getPageLimitFromParams(request.params)) {
+        // the entries of a transaction are next to each other, so a page never ends in the middle of them
+        UniValue txids(UniValue::VARR);
+        CAddressIndexKey lastKey;
+        bool fRange = start > 0 && end > 0;
+        auto next = walkAddressIndex(request.params, addresses, fRange ? start : 0, fRange ? end : 0,
+                [&](const CAddressIndexKey& key, CAmount) {
+            if (key.txhash == lastKey.txhash && key.hashBytes == lastKey.hashBytes && key.type == lastKey.type)
+                return true;
+            if (txids.size() >= limit)
+                return false;
+            lastKey = key;
+            txids.push_back(key.txhash.GetHex());
+            return true;
+        });
+
+        UniValue result(UniValue::VOBJ);
+        result.push_back(Pair("txids", txids));
+        if (next)
+            result.push_back(Pair("cursor", encodeAddressCursor(*next)));
+        return result;
+    }
+
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
     for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
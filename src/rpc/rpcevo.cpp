@@ -1077,9 +1077,13 @@ UniValue protx_diff(const JSONRPCRequest& request)
         protx_diff_help();
     }
 
-    LOCK(cs_main);
-    uint256 baseBlockHash = ParseBlock(request.params[1], "baseBlock");
-    uint256 blockHash = ParseBlock(request.params[2], "block");
+    uint256 baseBlockHash;
+    uint256 blockHash;
+    {
+        LOCK(cs_main);
+        baseBlockHash = ParseBlock(request.params[1], "baseBlock");
+        blockHash = ParseBlock(request.params[2], "block");
+    }
 
     CSimplifiedMNListDiff mnListDiff;
     std::string strError;
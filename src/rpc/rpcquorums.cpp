@@ -102,6 +102,13 @@ UniValue BuildQuorumInfo(const llmq::CQuorumCPtr& quorum, bool includeMembers, b
         }
 
         ret.push_back(Pair("members", membersArr));
+
+        auto stats = quorum->GetBLSCacheStats().publicKeyShare;
+        UniValue cacheObj(UniValue::VOBJ);
+        cacheObj.push_back(Pair("hits", stats.hits));
+        cacheObj.push_back(Pair("misses", stats.misses));
+        cacheObj.push_back(Pair("size", (uint64_t)stats.size));
+        ret.push_back(Pair("pubKeyShareCache", cacheObj));
     }
     ret.push_back(Pair("quorumPublicKey", quorum->qc.quorumPublicKey.ToString()));
     CBLSSecretKey skShare = quorum->GetSkShare();
@@ -185,6 +192,13 @@ UniValue quorum_dkgstatus(const JSONRPCRequest& request)
 
     ret.push_back(Pair("minableCommitments", minableCommitments));
 
+    auto cacheStats = llmq::CLLMQUtils::GetQuorumMembersCacheStats();
+    UniValue membersCache(UniValue::VOBJ);
+    membersCache.push_back(Pair("hits", cacheStats.hits));
+    membersCache.push_back(Pair("misses", cacheStats.misses));
+    membersCache.push_back(Pair("size", (uint64_t)cacheStats.size));
+    ret.push_back(Pair("quorumMembersCache", membersCache));
+
     return ret;
 }
 
@@ -477,11 +477,17 @@ static UniValue JSONRPCExecOne(const UniValue& req)
 
 std::string JSONRPCExecBatch(const UniValue& vReq)
 {
-    UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(vReq[reqIdx]));
+    std::string strReply;
+    JSONRPCExecBatch(vReq, [&strReply](const std::string& strPart) { strReply += strPart; });
+    return strReply;
+}
 
-    return ret.write() + "\n";
+void JSONRPCExecBatch(const UniValue& vReq, const std::function<void(const std::string&)>& writePart)
+{
+    writePart("[");
+    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
+        writePart((reqIdx > 0 ? "," : "") + JSONRPCExecOne(vReq[reqIdx]).write());
+    writePart("]\n");
 }
 
 /**
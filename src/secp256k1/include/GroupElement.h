@@ -21,15 +21,17 @@ public:
 
   GroupElement();
 
-  ~GroupElement();
+  GroupElement(const GroupElement& other) = default;
 
-  GroupElement(const GroupElement& other);
+  GroupElement(GroupElement&& other) noexcept = default;
 
   GroupElement(const char* x,const char* y,  int base = 10);
 
   GroupElement& set(const GroupElement& other);
 
-  GroupElement& operator=(const GroupElement& other);
+  GroupElement& operator=(const GroupElement& other) = default;
+
+  GroupElement& operator=(GroupElement&& other) noexcept = default;
 
   // Operator for multiplying with a scalar number.
   GroupElement operator*(const Scalar& multiplier) const;
@@ -81,6 +83,14 @@ public:
   // it accepts infinity point, handle it based on your use case
   unsigned const char* deserialize(unsigned const char* buffer);
 
+  // Vector versions of the functions above. Conversion of the points to affine
+  // coordinates shares one field inversion between all of them.
+  static void normalize_all(std::vector<GroupElement>& points);
+  // Serializes all points one after another, buffer must hold points.size() * memoryRequired() bytes.
+  static unsigned char* serialize_all(const std::vector<GroupElement>& points, unsigned char* buffer);
+  // Deserializes count points, throws if any of them is invalid.
+  static unsigned const char* deserialize_all(unsigned const char* buffer, std::size_t count, std::vector<GroupElement>& points);
+
   // These functions are for READWRITE() in serialize.h
   template<typename Stream>
   inline void Serialize(Stream& s) const {
@@ -110,6 +120,7 @@ public:
   GroupElement& set_base_g();
 
   friend class MultiExponent;
+  friend class FixedBaseMultiExponent;
 private:
     // Returns the secp object inside it.
     const void * get_value() const;
@@ -117,7 +128,10 @@ private:
     GroupElement(const void *g);
 
 private:
-    void *g_; // secp256k1_gej
+    // Storage for secp256k1_gej, kept inline so that vectors of elements are
+    // contiguous and copies do not touch the heap. Size is checked in GroupElement.cpp.
+    static constexpr std::size_t storage_size = 128;
+    alignas(8) unsigned char g_[storage_size];
 
 };
 
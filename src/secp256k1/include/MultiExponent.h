@@ -1,24 +1,60 @@
 #ifndef SECP_MULTIEXPONENT_H
 #define SECP_MULTIEXPONENT_H
 
+#include <cstddef>
+#include <functional>
 #include <vector>
 #include "../include/GroupElement.h"
 #include "../include/Scalar.h"
 
 namespace secp_primitives {
 
+// Computes sum of powers[i] * generators[i].
+// Generators and powers are kept by reference and read in place, be sure they outlive the object and are not modified.
+// Scratch memory is kept per thread and reused by later calls.
 class MultiExponent {
 public:
-    MultiExponent(const MultiExponent& other);
     MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers);
-    ~MultiExponent();
+    MultiExponent(const GroupElement* generators, const Scalar* powers, std::size_t n);
 
-    GroupElement get_multiple();
+    GroupElement get_multiple() const;
+
+    // Splits the points into up to n_threads chunks which are multiplied concurrently on the executor, the partial
+    // results are summed. Small inputs, or any without an executor set, are computed on the calling thread only.
+    GroupElement get_multiple(std::size_t n_threads) const;
+
+    // Runs the tasks concurrently and returns once all of them are done
+    typedef std::function<void(std::vector<std::function<void()>>&)> Executor;
+
+    // Sets where the chunks of parallel multiexponentiations run, by default they are not split at all.
+    // Safe to call while multiexponentiations run, the ones already started keep the executor they took. Whatever the
+    // executor uses has to outlive it.
+    static void set_executor(Executor executor);
+
+private:
+    const GroupElement *pt_;
+    const Scalar *sc_;
+    std::size_t n_points;
+};
+
+// Multiexponentiation over bases which are known in advance, like the generators of a proof system.
+// Every base is stored together with its multiples by 2^(8*j) in affine coordinates, so computing
+// a multiple takes point additions only, without doublings or per call tables.
+class FixedBaseMultiExponent {
+public:
+    FixedBaseMultiExponent(const std::vector<GroupElement>& bases);
+    FixedBaseMultiExponent(const FixedBaseMultiExponent& other) = delete;
+    FixedBaseMultiExponent& operator=(const FixedBaseMultiExponent& other) = delete;
+    ~FixedBaseMultiExponent();
+
+    // Returns sum of powers[i] * bases[i], powers may be shorter than the bases.
+    GroupElement get_multiple(const std::vector<Scalar>& powers) const;
+
+    std::size_t size() const;
 
 private:
-    void  *sc_; // secp256k1_scalar[]
-    void  *pt_; // secp256k1_gej[]
-    int n_points;
+    void *table_; // secp256k1_ge_storage[]
+    std::size_t n_bases;
 };
 
 }// namespace secp_primitives
@@ -21,15 +21,17 @@ public:
     Scalar(uint64_t value);
 
     // Copy constructor
-    Scalar(const Scalar& other);
+    Scalar(const Scalar& other) = default;
 
-    Scalar(const unsigned char* str);
+    Scalar(Scalar&& other) noexcept = default;
 
-    ~Scalar();
+    Scalar(const unsigned char* str);
 
     Scalar& set(const Scalar& other);
 
-    Scalar& operator=(const Scalar& other);
+    Scalar& operator=(const Scalar& other) = default;
+
+    Scalar& operator=(Scalar&& other) noexcept = default;
 
     Scalar& operator=(unsigned int i);
 
@@ -120,7 +122,9 @@ private:
     Scalar(const void *value);
 
 private:
-    void *value_; // secp256k1_scalar
+    // Storage for secp256k1_scalar, kept inline. Size is checked in Scalar.cpp.
+    static constexpr std::size_t storage_size = 32;
+    alignas(8) unsigned char value_[storage_size];
 
 };
 
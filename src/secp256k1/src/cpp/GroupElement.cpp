@@ -23,15 +23,73 @@
 
 static secp256k1_ecmult_context ctx;
 
-// Converts the value from secp256k1_gej to secp256k1_ge and returns.
+static const secp256k1_fe fe_one = SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 1);
+
+// Returns true if the point is already in affine coordinates, i.e. its z is one.
+static bool gej_is_affine(const secp256k1_gej &gej)
+{
+    return !gej.infinity && secp256k1_fe_equal_var(&fe_one, &gej.z);
+}
+
+// Converts the value from secp256k1_gej to secp256k1_ge with normalized coordinates and returns.
 static secp256k1_ge gej_to_ge(const secp256k1_gej &gej)
 {
     secp256k1_ge ge;
-    secp256k1_gej j(gej);
-    secp256k1_ge_set_gej(&ge, &j);
+    if (gej_is_affine(gej)) {
+        // No inversion is needed, deserialized and batch normalized points take this path
+        ge.x = gej.x;
+        ge.y = gej.y;
+        ge.infinity = 0;
+    } else {
+        secp256k1_gej j(gej);
+        secp256k1_ge_set_gej(&ge, &j);
+    }
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
     return ge;
 }
 
+// Converts len values from secp256k1_gej to secp256k1_ge sharing a single field inversion
+// between all of them (Montgomery's trick), instead of doing one inversion per value.
+static void gej_to_ge_all(secp256k1_ge *r, const secp256k1_gej * const *a, std::size_t len)
+{
+    std::vector<std::size_t> indexes;
+    std::vector<secp256k1_fe> zs;
+    indexes.reserve(len);
+    zs.reserve(len);
+
+    for (std::size_t i = 0; i < len; i++) {
+        if (a[i]->infinity || gej_is_affine(*a[i])) {
+            r[i] = gej_to_ge(*a[i]);
+        } else {
+            indexes.push_back(i);
+            zs.push_back(a[i]->z);
+        }
+    }
+
+    std::vector<secp256k1_fe> zinvs(zs.size());
+    secp256k1_fe_inv_all_var(zinvs.data(), zs.data(), zs.size());
+
+    for (std::size_t i = 0; i < indexes.size(); i++) {
+        secp256k1_ge *ge = &r[indexes[i]];
+        secp256k1_ge_set_gej_zinv(ge, a[indexes[i]], &zinvs[i]);
+        secp256k1_fe_normalize_var(&ge->x);
+        secp256k1_fe_normalize_var(&ge->y);
+    }
+}
+
+// Decodes a point serialized by GroupElement::serialize, returns false if it is neither valid nor infinity.
+static bool ge_decompress(secp256k1_ge *r, const unsigned char *buffer)
+{
+    secp256k1_fe x;
+    secp256k1_fe_set_b32(&x, buffer);
+    unsigned char oddness = buffer[32];
+    unsigned char infinity = buffer[33];
+    int valid = secp256k1_ge_set_xo_var(r, &x, (int)oddness);
+    r->infinity = (int)infinity;
+    return valid || r->infinity;
+}
+
 //	Implements the algorithm from:
 //   Indifferentiable Hashing to Barreto-Naehrig Curves
 //    Pierre-Alain Fouque and Mehdi Tibouchi
@@ -159,22 +217,19 @@ static void _negate (uint8_t(&num) [Len])
     }
 }
 
+static_assert(sizeof(secp256k1_gej) <= sizeof(GroupElement), "GroupElement storage is too small for secp256k1_gej");
+static_assert(alignof(secp256k1_gej) <= alignof(GroupElement), "GroupElement storage is misaligned for secp256k1_gej");
+
 GroupElement::GroupElement()
-        : g_(new secp256k1_gej())
 {
     auto g = reinterpret_cast<secp256k1_gej *>(g_);
     secp256k1_gej_clear(g);
     g->infinity = 1;
 }
 
-GroupElement::GroupElement(const GroupElement& other)
-        : g_(new secp256k1_gej(*reinterpret_cast<secp256k1_gej *>(other.g_)))
-{
-}
-
 GroupElement::GroupElement(const void *g)
-        : g_(new secp256k1_gej(*reinterpret_cast<const secp256k1_gej *>(g)))
 {
+    *reinterpret_cast<secp256k1_gej *>(g_) = *reinterpret_cast<const secp256k1_gej *>(g);
 }
 
 static void _convertToFieldElement(secp256k1_fe *r, const char* str, int base) {
@@ -225,7 +280,6 @@ static void _convertToFieldElement(secp256k1_fe *r, const char* str, int base) {
 }
 
 GroupElement::GroupElement(const char* x,const char* y, int base)
-        : g_(new secp256k1_gej())
 {
     auto g = reinterpret_cast<secp256k1_gej *>(g_);
 
@@ -237,19 +291,9 @@ GroupElement::GroupElement(const char* x,const char* y, int base)
     secp256k1_gej_set_ge(g,&element);
 }
 
-GroupElement::~GroupElement()
-{
-    delete reinterpret_cast<secp256k1_gej *>(g_);
-}
-
-GroupElement& GroupElement::operator=(const GroupElement &other)
-{
-    return set(other);
-}
-
 GroupElement& GroupElement::set(const GroupElement &other)
 {
-    *reinterpret_cast<secp256k1_gej *>(g_) = *reinterpret_cast<secp256k1_gej *>(other.g_);
+    *reinterpret_cast<secp256k1_gej *>(g_) = *reinterpret_cast<const secp256k1_gej *>(other.g_);
     return *this;
 }
 
@@ -258,7 +302,7 @@ GroupElement GroupElement::operator*(const Scalar& multiplier) const
     secp256k1_gej result;
     secp256k1_scalar ng;
     secp256k1_scalar_set_int(&ng,0);
-    secp256k1_ecmult(&ctx,&result,reinterpret_cast<secp256k1_gej *>(g_), reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
+    secp256k1_ecmult(&ctx,&result,reinterpret_cast<const secp256k1_gej *>(g_), reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
     return &result;
 }
 
@@ -274,21 +318,21 @@ GroupElement& GroupElement::operator*=(const Scalar& multiplier)
 GroupElement GroupElement::operator+(const GroupElement &other) const
 {
     secp256k1_gej result_gej;
-    secp256k1_gej_add_var(&result_gej, reinterpret_cast<secp256k1_gej *>(g_), reinterpret_cast<secp256k1_gej *>(other.g_), NULL);
+    secp256k1_gej_add_var(&result_gej, reinterpret_cast<const secp256k1_gej *>(g_), reinterpret_cast<const secp256k1_gej *>(other.g_), NULL);
     return &result_gej;
 }
 
 GroupElement& GroupElement::operator+=(const GroupElement& other)
 {
     auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    secp256k1_gej_add_var(g, g, reinterpret_cast<secp256k1_gej *>(other.g_), NULL);
+    secp256k1_gej_add_var(g, g, reinterpret_cast<const secp256k1_gej *>(other.g_), NULL);
     return *this;
 }
 
 GroupElement GroupElement::inverse() const
 {
     secp256k1_gej result_gej;
-    secp256k1_gej_neg(&result_gej,reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_gej_neg(&result_gej,reinterpret_cast<const secp256k1_gej *>(g_));
     return &result_gej;
 }
 
@@ -300,8 +344,8 @@ void GroupElement::square()
 
 bool GroupElement::operator==(const  GroupElement& other) const
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    auto og = reinterpret_cast<secp256k1_gej *>(other.g_);
+    auto g = reinterpret_cast<const secp256k1_gej *>(g_);
+    auto og = reinterpret_cast<const secp256k1_gej *>(other.g_);
 
     if(g->infinity && og->infinity)
         return true;
@@ -324,7 +368,7 @@ bool GroupElement::operator!=(const  GroupElement& other) const
 
 bool GroupElement::isMember() const
 {
-    secp256k1_ge v1 = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge v1 = gej_to_ge(*reinterpret_cast<const secp256k1_gej *>(g_));
     if (secp256k1_ge_is_infinity(&v1)) {
         return true;
     }
@@ -396,7 +440,7 @@ void GroupElement::normalSha256(unsigned char* result) const {
 }
 
 void GroupElement::sha256(unsigned char* result) const {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = reinterpret_cast<const secp256k1_gej *>(g_);
     unsigned char buff[64];
     secp256k1_fe_get_b32(&buff[0], &g->x);
     secp256k1_fe_get_b32(&buff[32], &g->y);
@@ -455,7 +499,7 @@ std::string _convertToString(const unsigned char(&buffer) [Len], int base) {
 
 std::string GroupElement::tostring() const {
     int base = 10;
-    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<const secp256k1_gej *>(g_));
 
     if (ge.infinity) {
     return std::string("O");
@@ -477,7 +521,7 @@ std::string GroupElement::tostring() const {
 
 std::string GroupElement::GetHex() const {
     int base = 16;
-    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<const secp256k1_gej *>(g_));
 
     if (ge.infinity) {
         return std::string("O");
@@ -498,7 +542,7 @@ std::string GroupElement::GetHex() const {
 }
 
 unsigned char* GroupElement::serialize() const {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = reinterpret_cast<const secp256k1_gej *>(g_);
     unsigned char* data = new unsigned char[ 2 * sizeof(secp256k1_fe)];
     memcpy(&data[0], &g->x.n[0], sizeof(secp256k1_fe));
     memcpy(&data[0] + sizeof(secp256k1_fe), &g->y.n[0], sizeof(secp256k1_fe));
@@ -506,7 +550,7 @@ unsigned char* GroupElement::serialize() const {
 }
 
 unsigned char* GroupElement::serialize(unsigned char* buffer) const {
-    secp256k1_ge value = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge value = gej_to_ge(*reinterpret_cast<const secp256k1_gej *>(g_));
     secp256k1_fe x = value.x;
     secp256k1_fe y = value.y;
     secp256k1_fe_normalize(&x);
@@ -520,22 +564,65 @@ unsigned char* GroupElement::serialize(unsigned char* buffer) const {
 }
 
 const unsigned char* GroupElement::deserialize(const unsigned char* buffer) {
-    secp256k1_fe x;
-    secp256k1_fe_set_b32(&x, buffer);
-    unsigned char oddness = buffer[32];
-    unsigned char infinity = buffer[33];
     secp256k1_ge result;
-    secp256k1_ge_set_xo_var(&result, &x, (int)oddness);
-    result.infinity = (int)infinity;
+    bool valid = ge_decompress(&result, buffer);
 
     secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &result);
 
-    if (!secp256k1_ge_is_valid_var(&result) && !result.infinity) {
+    if (!valid) {
         throw std::invalid_argument("GroupElement: deserialize failed");
     }
     return buffer + memoryRequired();
 }
 
+void GroupElement::normalize_all(std::vector<GroupElement>& points) {
+    std::vector<const secp256k1_gej *> gejs(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        gejs[i] = reinterpret_cast<const secp256k1_gej *>(points[i].g_);
+    }
+
+    std::vector<secp256k1_ge> ges(points.size());
+    gej_to_ge_all(ges.data(), gejs.data(), gejs.size());
+
+    for (std::size_t i = 0; i < points.size(); i++) {
+        // Keep infinity untouched, its coordinates are not meaningful
+        if (!ges[i].infinity) {
+            secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(points[i].g_), &ges[i]);
+        }
+    }
+}
+
+unsigned char* GroupElement::serialize_all(const std::vector<GroupElement>& points, unsigned char* buffer) {
+    std::vector<const secp256k1_gej *> gejs(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        gejs[i] = reinterpret_cast<const secp256k1_gej *>(points[i].g_);
+    }
+
+    std::vector<secp256k1_ge> ges(points.size());
+    gej_to_ge_all(ges.data(), gejs.data(), gejs.size());
+
+    for (auto& ge : ges) {
+        secp256k1_fe_get_b32(buffer, &ge.x);
+        buffer[32] = secp256k1_fe_is_odd(&ge.y);
+        buffer[33] = ge.infinity;
+        buffer += memoryRequired();
+    }
+    return buffer;
+}
+
+const unsigned char* GroupElement::deserialize_all(const unsigned char* buffer, std::size_t count, std::vector<GroupElement>& points) {
+    points.resize(count);
+    for (auto& point : points) {
+        secp256k1_ge result;
+        if (!ge_decompress(&result, buffer)) {
+            throw std::invalid_argument("GroupElement: deserialize failed");
+        }
+        secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(point.g_), &result);
+        buffer += memoryRequired();
+    }
+    return buffer;
+}
+
 std::vector<unsigned char> GroupElement::getvch() const {
     unsigned char buffer[memoryRequired()];
     serialize(buffer);
@@ -546,7 +633,7 @@ std::vector<unsigned char> GroupElement::getvch() const {
 
 std::size_t GroupElement::hash() const
 {
-    auto ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    auto ge = gej_to_ge(*reinterpret_cast<const secp256k1_gej *>(g_));
     std::array<unsigned char, 32 * 2> coord;
 
     if (ge.infinity) {
@@ -560,7 +647,7 @@ std::size_t GroupElement::hash() const
 }
 
 std::size_t GroupElement::get_hash() const {
-    secp256k1_fe x = reinterpret_cast<secp256k1_gej *>(g_)->x;
+    secp256k1_fe x = reinterpret_cast<const secp256k1_gej *>(g_)->x;
     secp256k1_fe_normalize(&x);
     return x.n[0] ^ (x.n[1] << 16);
 }
@@ -12,73 +12,253 @@
 #include "../src/scratch_impl.h"
 #include "../src/ecmult_impl.h"
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
 
+
+// Points and scalars are read in place from the GroupElement and Scalar arrays
 typedef struct {
-    secp256k1_scalar *sc;
-    secp256k1_gej *pt;
+    const unsigned char *sc;
+    const unsigned char *pt;
 } ecmult_multi_data;
 
 int ecmult_multi_callback(secp256k1_scalar *sc, secp256k1_gej *pt, size_t idx, void *cbdata) {
     ecmult_multi_data *data = (ecmult_multi_data*) cbdata;
-    *sc = data->sc[idx];
-    *pt = data->pt[idx];
+    *sc = *reinterpret_cast<const secp256k1_scalar *>(data->sc + idx * sizeof(secp_primitives::Scalar));
+    *pt = *reinterpret_cast<const secp256k1_gej *>(data->pt + idx * sizeof(secp_primitives::GroupElement));
     return 1;
 }
 
-namespace secp_primitives {
+namespace {
 
-MultiExponent::MultiExponent(const MultiExponent& other)
-        : sc_(new secp256k1_scalar[other.n_points])
-        , pt_(new secp256k1_gej[other.n_points])
-        , n_points(other.n_points)
-{
-    for(int i = 0; i < n_points; ++i)
-    {
-        (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = (reinterpret_cast<secp256k1_scalar *>(other.sc_))[i];
-        (reinterpret_cast<secp256k1_gej *>(pt_))[i] = (reinterpret_cast<secp256k1_gej *>(other.pt_))[i];
+// Scratch space owned by the calling thread, its frames grow to the largest multiexponentiation seen and are reused after
+class ThreadScratch {
+public:
+    ThreadScratch() : scratch(secp256k1_scratch_create(NULL, 0)) {
+        if (scratch == NULL) {
+            throw std::bad_alloc();
+        }
     }
-}
 
-MultiExponent::MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers){
-    sc_ = new secp256k1_scalar[powers.size()];
-    pt_ = new secp256k1_gej[generators.size()];
-    n_points = generators.size();
-    for(int i = 0; i < n_points; ++i)
-    {
-        (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = *reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value());
-        (reinterpret_cast<secp256k1_gej *>(pt_))[i] = *reinterpret_cast<const secp256k1_gej *>(generators[i].get_value());
+    ~ThreadScratch() {
+        secp256k1_scratch_destroy(scratch);
+    }
+
+    secp256k1_scratch *get(size_t max_size) {
+        scratch->max_size = max_size;
+        return scratch;
+    }
+
+private:
+    secp256k1_scratch *scratch;
+};
+
+thread_local ThreadScratch thread_scratch;
+
+} // namespace
+
+namespace secp_primitives {
+
+MultiExponent::MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers)
+        : pt_(generators.data())
+        , sc_(powers.data())
+        , n_points(generators.size())
+{
+    if (powers.size() < generators.size()) {
+        throw std::invalid_argument("MultiExponent: not enough powers");
     }
 }
 
-MultiExponent::~MultiExponent(){
-    delete []reinterpret_cast<secp256k1_scalar *>(sc_);
-    delete []reinterpret_cast<secp256k1_gej *>(pt_);
+MultiExponent::MultiExponent(const GroupElement* generators, const Scalar* powers, std::size_t n)
+        : pt_(generators)
+        , sc_(powers)
+        , n_points(n)
+{
 }
 
-GroupElement MultiExponent::get_multiple() {
+GroupElement MultiExponent::get_multiple() const {
     secp256k1_gej r;
 
+    if (n_points == 0) {
+        return GroupElement();
+    }
+
     ecmult_multi_data data;
-    data.sc = reinterpret_cast<secp256k1_scalar *>(sc_);
-    data.pt = reinterpret_cast<secp256k1_gej *>(pt_);
+    data.sc = reinterpret_cast<const unsigned char *>(sc_[0].get_value());
+    data.pt = reinterpret_cast<const unsigned char *>(pt_[0].get_value());
 
-    secp256k1_scratch *scratch;
+    size_t scratch_size;
     if (n_points > ECMULT_PIPPENGER_THRESHOLD) {
         int bucket_window = secp256k1_pippenger_bucket_window(n_points);
-        size_t scratch_size = secp256k1_pippenger_scratch_size(n_points, bucket_window);
-        scratch = secp256k1_scratch_create(NULL, scratch_size + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
+        scratch_size = secp256k1_pippenger_scratch_size(n_points, bucket_window) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT;
     } else {
-        size_t scratch_size = secp256k1_strauss_scratch_size(n_points);
-        scratch = secp256k1_scratch_create(NULL, scratch_size + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT);
+        scratch_size = secp256k1_strauss_scratch_size(n_points) + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT;
     }
+    secp256k1_scratch *scratch = thread_scratch.get(scratch_size);
 
     secp256k1_ecmult_context ctx;
 
     secp256k1_ecmult_multi_var(&ctx, scratch, &r, NULL, ecmult_multi_callback, &data, n_points);
 
-    secp256k1_scratch_destroy(scratch);
-
     return  reinterpret_cast<secp256k1_scalar *>(&r);
 }
 
+// Smallest chunk a parallel multiexponentiation is split into, below that Pippenger loses too much of its advantage
+static const std::size_t PARALLEL_MIN_CHUNK_POINTS = 2048;
+
+// Read by the verifying threads while it may be set, every call takes its own reference under the lock
+static std::mutex cs_parallel_executor;
+static std::shared_ptr<const MultiExponent::Executor> parallel_executor;
+
+void MultiExponent::set_executor(Executor executor) {
+    std::shared_ptr<const Executor> new_executor;
+    if (executor) {
+        new_executor = std::make_shared<const Executor>(std::move(executor));
+    }
+    std::lock_guard<std::mutex> lock(cs_parallel_executor);
+    parallel_executor = std::move(new_executor);
+}
+
+GroupElement MultiExponent::get_multiple(std::size_t n_threads) const {
+    std::size_t n_chunks = std::min(n_threads, n_points / PARALLEL_MIN_CHUNK_POINTS);
+    if (n_chunks <= 1) {
+        return get_multiple();
+    }
+
+    std::shared_ptr<const Executor> executor;
+    {
+        std::lock_guard<std::mutex> lock(cs_parallel_executor);
+        executor = parallel_executor;
+    }
+    // Starting threads for every call costs more than it saves and loses their scratch, without persistent ones
+    // the calling thread does it all
+    if (!executor) {
+        return get_multiple();
+    }
+
+    std::size_t chunk_size = (n_points + n_chunks - 1) / n_chunks;
+    std::vector<GroupElement> partial_results((n_points + chunk_size - 1) / chunk_size);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(partial_results.size());
+    for (std::size_t start = 0, i = 0; start < n_points; start += chunk_size, ++i) {
+        MultiExponent chunk(pt_ + start, sc_ + start, std::min(chunk_size, n_points - start));
+        GroupElement* partial_result = &partial_results[i];
+        tasks.emplace_back([chunk, partial_result] { *partial_result = chunk.get_multiple(); });
+    }
+    (*executor)(tasks);
+
+    GroupElement result;
+    for (const auto& partial_result : partial_results) {
+        result += partial_result;
+    }
+    return result;
+}
+
+// Number of scalar bits handled by one precomputed multiple of a base
+static const std::size_t FIXED_BASE_WINDOW_BITS = 8;
+static const std::size_t FIXED_BASE_WINDOWS = 256 / FIXED_BASE_WINDOW_BITS;
+static const std::size_t FIXED_BASE_BUCKETS = (1 << FIXED_BASE_WINDOW_BITS) - 1;
+// Below this number of powers summing up the buckets costs more than the ordinary multiexponentiation
+static const std::size_t FIXED_BASE_MIN_POWERS = 16;
+
+FixedBaseMultiExponent::FixedBaseMultiExponent(const std::vector<GroupElement>& bases)
+        : table_(nullptr)
+        , n_bases(bases.size())
+{
+    std::size_t table_size = n_bases * FIXED_BASE_WINDOWS;
+    std::vector<secp256k1_gej> multiples(table_size);
+    for (std::size_t i = 0; i < n_bases; ++i) {
+        secp256k1_gej p = *reinterpret_cast<const secp256k1_gej *>(bases[i].get_value());
+        if (p.infinity) {
+            throw std::invalid_argument("FixedBaseMultiExponent: base is infinity");
+        }
+        for (std::size_t j = 0; j < FIXED_BASE_WINDOWS; ++j) {
+            multiples[i * FIXED_BASE_WINDOWS + j] = p;
+            for (std::size_t k = 0; k < FIXED_BASE_WINDOW_BITS; ++k) {
+                secp256k1_gej_double_var(&p, &p, NULL);
+            }
+        }
+    }
+
+    // Convert everything to affine with a single inversion
+    std::vector<secp256k1_fe> zs(table_size), zinvs(table_size);
+    for (std::size_t i = 0; i < table_size; ++i) {
+        zs[i] = multiples[i].z;
+    }
+    secp256k1_fe_inv_all_var(zinvs.data(), zs.data(), table_size);
+
+    secp256k1_ge_storage *table = new secp256k1_ge_storage[table_size];
+    for (std::size_t i = 0; i < table_size; ++i) {
+        secp256k1_ge ge;
+        secp256k1_ge_set_gej_zinv(&ge, &multiples[i], &zinvs[i]);
+        secp256k1_fe_normalize_var(&ge.x);
+        secp256k1_fe_normalize_var(&ge.y);
+        secp256k1_ge_to_storage(&table[i], &ge);
+    }
+    table_ = table;
+}
+
+FixedBaseMultiExponent::~FixedBaseMultiExponent() {
+    delete []reinterpret_cast<secp256k1_ge_storage *>(table_);
+}
+
+GroupElement FixedBaseMultiExponent::get_multiple(const std::vector<Scalar>& powers) const {
+    if (powers.size() > n_bases) {
+        throw std::invalid_argument("FixedBaseMultiExponent: too many powers");
+    }
+
+    const secp256k1_ge_storage *table = reinterpret_cast<const secp256k1_ge_storage *>(table_);
+
+    if (powers.size() < FIXED_BASE_MIN_POWERS) {
+        std::vector<GroupElement> bases;
+        bases.reserve(powers.size());
+        for (std::size_t i = 0; i < powers.size(); ++i) {
+            secp256k1_ge ge;
+            secp256k1_gej gej;
+            secp256k1_ge_from_storage(&ge, &table[i * FIXED_BASE_WINDOWS]);
+            secp256k1_gej_set_ge(&gej, &ge);
+            bases.emplace_back(GroupElement(&gej));
+        }
+        return MultiExponent(bases, powers).get_multiple();
+    }
+
+    // Bucket method: every nonzero digit d of powers[i] adds the matching multiple of the base to bucket d
+    std::vector<secp256k1_gej> buckets(FIXED_BASE_BUCKETS);
+    for (auto& bucket : buckets) {
+        secp256k1_gej_set_infinity(&bucket);
+    }
+
+    for (std::size_t i = 0; i < powers.size(); ++i) {
+        unsigned char b32[32];
+        secp256k1_scalar_get_b32(b32, reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value()));
+        for (std::size_t j = 0; j < FIXED_BASE_WINDOWS; ++j) {
+            unsigned char digit = b32[31 - j];
+            if (digit == 0) {
+                continue;
+            }
+            secp256k1_ge ge;
+            secp256k1_ge_from_storage(&ge, &table[i * FIXED_BASE_WINDOWS + j]);
+            secp256k1_gej_add_ge_var(&buckets[digit - 1], &buckets[digit - 1], &ge, NULL);
+        }
+    }
+
+    // sum of d * bucket[d], as running sums from the highest digit down
+    secp256k1_gej running, result;
+    secp256k1_gej_set_infinity(&running);
+    secp256k1_gej_set_infinity(&result);
+    for (std::size_t d = FIXED_BASE_BUCKETS; d > 0; --d) {
+        secp256k1_gej_add_var(&running, &running, &buckets[d - 1], NULL);
+        secp256k1_gej_add_var(&result, &result, &running, NULL);
+    }
+
+    return &result;
+}
+
+std::size_t FixedBaseMultiExponent::size() const {
+    return n_bases;
+}
+
 }// namespace secp_primitives
@@ -18,13 +18,14 @@
 
 namespace secp_primitives {
 
-Scalar::Scalar()
-   : value_(new secp256k1_scalar()) {
+static_assert(sizeof(secp256k1_scalar) <= sizeof(Scalar), "Scalar storage is too small for secp256k1_scalar");
+static_assert(alignof(secp256k1_scalar) <= alignof(Scalar), "Scalar storage is misaligned for secp256k1_scalar");
+
+Scalar::Scalar() {
     secp256k1_scalar_clear(reinterpret_cast<secp256k1_scalar *>(value_));
 }
 
-Scalar::Scalar(uint64_t value)
-   : value_(new secp256k1_scalar()) {
+Scalar::Scalar(uint64_t value) {
     unsigned char b32[32];
     for(int i = 0; i < 24; i++)
         b32[i] = 0;
@@ -39,27 +40,12 @@ Scalar::Scalar(uint64_t value)
     secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), b32, 0);
 }
 
-Scalar::Scalar(const unsigned char* str)
-     : value_(new secp256k1_scalar()) {
+Scalar::Scalar(const unsigned char* str) {
     secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), str, 0);
 }
 
-Scalar::Scalar(const void *value)
-   : value_(new secp256k1_scalar(*reinterpret_cast<const secp256k1_scalar *>(value))) {
-
-}
-
-Scalar::Scalar(const Scalar& other)
-   : value_(new secp256k1_scalar(*reinterpret_cast<const secp256k1_scalar *>(other.value_))) {
-
-}
-
-Scalar::~Scalar() {
-    delete reinterpret_cast<secp256k1_scalar *>(value_);
-}
-
-Scalar& Scalar::operator=(const Scalar& other) {
-    return set(other);
+Scalar::Scalar(const void *value) {
+    *reinterpret_cast<secp256k1_scalar *>(value_) = *reinterpret_cast<const secp256k1_scalar *>(value);
 }
 
 Scalar& Scalar::operator=(unsigned int i) {
@@ -13,6 +13,7 @@
 #include "sigma/coin.h"
 #include "primitives/mint_spend.h"
 #include "batchproof_container.h"
+#include "proof_cache.h"
 
 #include <atomic>
 #include <sstream>
@@ -29,6 +30,14 @@ namespace sigma {
 
 static CSigmaState sigmaState;
 
+static std::vector<uint256> GetCoinValueHashes(const std::vector<PublicCoin>& coins) {
+    std::vector<GroupElement> values;
+    values.reserve(coins.size());
+    for (const auto& coin : coins)
+        values.push_back(coin.getValue());
+    return primitives::GetPubCoinValueHashes(values);
+}
+
 bool CheckSigmaSpendSerial(
         CValidationState &state,
         CSigmaTxInfo *sigmaTxInfo,
@@ -173,6 +182,22 @@ bool CheckSigmaBlock(CValidationState &state, const CBlock& block) {
     return true;
 }
 
+// Key of the spend proof of the input checked against the anonymity set of the given size ending at the given block
+static uint256 GetSpendProofKey(
+        const uint256& hashTx,
+        int vinIndex,
+        const std::pair<sigma::CoinDenomination, int>& denominationAndId,
+        bool fPadding,
+        const uint256& setBlockHash,
+        size_t setSize) {
+    int64_t intDenom;
+    DenominationToInteger(denominationAndId.first, intDenom);
+
+    CHashWriter h(SER_GETHASH, PROTOCOL_VERSION);
+    h << hashTx << vinIndex << intDenom << denominationAndId.second << fPadding << setBlockHash << uint64_t(setSize);
+    return h.GetHash();
+}
+
 // Will return false for V1, V1.5 and V2 spends.
 // Mixing V2 and sigma spends into the same transaction will fail.
 bool CheckSigmaSpendTransaction(
@@ -265,15 +290,17 @@ bool CheckSigmaSpendTransaction(
         // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
         while (index != coinGroup.firstBlock && index->GetBlockHash() != accumulatorBlockHash)
             index = index->pprev;
+        uint256 setBlockHash = index->GetBlockHash();
 
         // Build a vector with all the public coins with given denomination and accumulator id before
         // the block on which the spend occured.
         // This list of public coins is required by function "Verify" of CoinSpend.
         std::vector<sigma::PublicCoin> anonymity_set;
         while(true) {
-            if (index->sigmaMintedPubCoins.count(denominationAndId) > 0) {
+            if (index->GetSigmaMintCount(denominationAndId) > 0) {
+                auto coinData = index->GetCoinData();
                 BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
-                        index->sigmaMintedPubCoins[denominationAndId]) {
+                        coinData->sigmaMintedPubCoins.at(denominationAndId)) {
                     if (nHeight >= params.nStartSigmaBlacklist) {
                         if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
                             continue;
@@ -294,13 +321,21 @@ bool CheckSigmaSpendTransaction(
                 return state.DoS(1, error("Incorrect sigma spend transaction version"));
         }
 
+        // proofs verified before are not verified again if they were checked against the same anonymity set
+        uint256 proofKey = GetSpendProofKey(hashTx, vinIndex, denominationAndId, fPadding, setBlockHash, anonymity_set.size());
+        bool fCachedProof = IsProofCached(proofKey);
+
         BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
+        // proofs are only collected for the transactions of a block being connected, never for the mempool
+        bool useBatching = batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && sigmaTxInfo && !sigmaTxInfo->fInfoIsComplete;
         // if we are collecting proofs, skip verification and collect proofs
-        passVerify = spend->Verify(anonymity_set, newMetaData, fPadding, batchProofContainer->fCollectProofs);
+        passVerify = spend->Verify(anonymity_set, newMetaData, fPadding, useBatching || fCachedProof);
 
         // add proofs into container
-        if(batchProofContainer->fCollectProofs) {
+        if(useBatching && !fCachedProof) {
             batchProofContainer->add(spend.get(), fPadding, coinGroupId, anonymity_set.size(), nHeight >= params.nStartSigmaBlacklist);
+        } else if (passVerify && !fCachedProof) {
+            AddProofToCache(proofKey);
         }
 
         if (passVerify) {
@@ -612,9 +647,10 @@ bool ConnectBlockSigma(
         bool fJustCheck) {
     // Add zerocoin transaction information to index
     if (pblock && pblock->sigmaTxInfo) {
-        if (!fJustCheck) {
-            pindexNew->sigmaMintedPubCoins.clear();
-            pindexNew->sigmaSpentSerials.clear();
+        if (!fJustCheck && pindexNew->HasCoinData()) {
+            CBlockCoinData &coinData = pindexNew->ModifyCoinData();
+            coinData.sigmaMintedPubCoins.clear();
+            coinData.sigmaSpentSerials.clear();
         }
 
         if (!CheckSigmaBlock(state, *pblock)) {
@@ -633,7 +669,7 @@ bool ConnectBlockSigma(
             }
 
             if (!fJustCheck) {
-                pindexNew->sigmaSpentSerials.insert(serial);
+                pindexNew->ModifyCoinData().sigmaSpentSerials.insert(serial);
                 sigmaState.AddSpend(serial.first, serial.second.denomination, serial.second.coinGroupId);
             }
         }
@@ -776,8 +812,9 @@ CSigmaState::Containers::Containers(std::atomic<bool> & surgeCondition)
 : surgeCondition(surgeCondition)
 {}
 
-void CSigmaState::Containers::AddMint(sigma::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo) {
+void CSigmaState::Containers::AddMint(sigma::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& valueHash) {
     mintedPubCoins.insert(std::make_pair(pubCoin, coinInfo));
+    hashToPublicCoin.insert(std::make_pair(valueHash, pubCoin));
     mintMetaInfo[coinInfo.coinGroupId][coinInfo.denomination] += 1;
     CheckSurgeCondition(coinInfo.coinGroupId, coinInfo.denomination);
 }
@@ -785,6 +822,7 @@ void CSigmaState::Containers::AddMint(sigma::PublicCoin const & pubCoin, CMinted
 void CSigmaState::Containers::RemoveMint(sigma::PublicCoin const & pubCoin) {
     mint_info_container::const_iterator iter = mintedPubCoins.find(pubCoin);
     if (iter != mintedPubCoins.end()) {
+        hashToPublicCoin.erase(pubCoin.getValueHash());
         mintMetaInfo[iter->second.coinGroupId][iter->second.denomination] -= 1;
         CMintedCoinInfo tmpMintInfo(iter->second);
         mintedPubCoins.erase(iter);
@@ -794,6 +832,7 @@ void CSigmaState::Containers::RemoveMint(sigma::PublicCoin const & pubCoin) {
 
 void CSigmaState::Containers::AddSpend(Scalar const & serial, CSpendCoinInfo const & coinInfo) {
     usedCoinSerials[serial] = coinInfo;
+    hashToSerial[primitives::GetSerialHash(serial)] = serial;
     spendMetaInfo[coinInfo.coinGroupId][coinInfo.denomination] += 1;
     CheckSurgeCondition(coinInfo.coinGroupId, coinInfo.denomination);
 }
@@ -802,6 +841,7 @@ void CSigmaState::Containers::RemoveSpend(Scalar const & serial) {
     spend_info_container::const_iterator iter = usedCoinSerials.find(serial);
     if (iter != usedCoinSerials.end()) {
         spendMetaInfo[iter->second.coinGroupId][iter->second.denomination] -= 1;
+        hashToSerial.erase(primitives::GetSerialHash(serial));
         CSpendCoinInfo tmpSpendInfo(iter->second);
         usedCoinSerials.erase(iter);
         CheckSurgeCondition(tmpSpendInfo.coinGroupId, tmpSpendInfo.denomination);
@@ -816,6 +856,14 @@ spend_info_container const & CSigmaState::Containers::GetSpends() const {
     return usedCoinSerials;
 }
 
+std::unordered_map<uint256, sigma::PublicCoin> const & CSigmaState::Containers::GetHashToPublicCoin() const {
+    return hashToPublicCoin;
+}
+
+std::unordered_map<uint256, Scalar> const & CSigmaState::Containers::GetHashToSerial() const {
+    return hashToSerial;
+}
+
 bool CSigmaState::Containers::IsSurgeCondition() const {
     return surgeCondition;
 }
@@ -823,6 +871,8 @@ bool CSigmaState::Containers::IsSurgeCondition() const {
 void CSigmaState::Containers::Reset() {
     mintedPubCoins.clear();
     usedCoinSerials.clear();
+    hashToPublicCoin.clear();
+    hashToSerial.clear();
     mintMetaInfo.clear();
     spendMetaInfo.clear();
     surgeCondition = false;
@@ -900,12 +950,16 @@ void CSigmaState::AddMintsToStateAndBlockIndex(
             newCoinGroup.nCoins = mintsWithThisDenom.size();
         }
 
-        for (const auto& mint : mintsWithThisDenom) {
-            containers.AddMint(mint, CMintedCoinInfo::make(denomination, mintCoinGroupId, index->nHeight));
+        std::vector<uint256> valueHashes = GetCoinValueHashes(mintsWithThisDenom);
+        for (size_t i = 0; i < mintsWithThisDenom.size(); i++) {
+            const auto& mint = mintsWithThisDenom[i];
+            containers.AddMint(mint, CMintedCoinInfo::make(denomination, mintCoinGroupId, index->nHeight), valueHashes[i]);
 
             LogPrintf("AddMintsToStateAndBlockIndex: mint added denomination=%d, id=%d\n", denomination, mintCoinGroupId);
-            index->sigmaMintedPubCoins[{denomination, mintCoinGroupId}].push_back(mint);
         }
+
+        auto &indexMints = index->ModifyCoinData().sigmaMintedPubCoins[{denomination, mintCoinGroupId}];
+        indexMints.insert(indexMints.end(), mintsWithThisDenom.begin(), mintsWithThisDenom.end());
     }
 }
 
@@ -914,9 +968,10 @@ void CSigmaState::AddSpend(const Scalar &serial, CoinDenomination denom, int coi
 }
 
 void CSigmaState::AddBlock(CBlockIndex *index) {
+    auto coinData = index->GetCoinData();
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int), std::vector<sigma::PublicCoin>) &pubCoins,
-            index->sigmaMintedPubCoins) {
+            coinData->sigmaMintedPubCoins) {
 
         if (pubCoins.second.empty())
             continue;
@@ -929,21 +984,24 @@ void CSigmaState::AddBlock(CBlockIndex *index) {
         coinGroup.nCoins += pubCoins.second.size();
 
         latestCoinIds[pubCoins.first.first] = pubCoins.first.second;
-        BOOST_FOREACH(const sigma::PublicCoin &coin, pubCoins.second) {
-            containers.AddMint(coin, CMintedCoinInfo::make(pubCoins.first.first, pubCoins.first.second, index->nHeight));
+        std::vector<uint256> valueHashes = GetCoinValueHashes(pubCoins.second);
+        for (size_t i = 0; i < pubCoins.second.size(); i++) {
+            containers.AddMint(pubCoins.second[i], CMintedCoinInfo::make(pubCoins.first.first, pubCoins.first.second, index->nHeight), valueHashes[i]);
         }
     }
 
-    BOOST_FOREACH(const spend_info_container::value_type &serial, index->sigmaSpentSerials) {
+    BOOST_FOREACH(const spend_info_container::value_type &serial, coinData->sigmaSpentSerials) {
         AddSpend(serial.first, serial.second.denomination, serial.second.coinGroupId);
     }
 }
 
 void CSigmaState::RemoveBlock(CBlockIndex *index) {
+    auto coinData = index->GetCoinData();
+
     // roll back accumulator updates
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),std::vector<sigma::PublicCoin>) &coin,
-        index->sigmaMintedPubCoins)
+        coinData->sigmaMintedPubCoins)
     {
         SigmaCoinGroupInfo   &coinGroup = coinGroups[coin.first];
         int  nMintsToForget = coin.second.size();
@@ -969,14 +1027,13 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->sigmaMintedPubCoins.count(coin.first) == 0 ||
-                        coinGroup.lastBlock->sigmaMintedPubCoins[coin.first].size() == 0);
+            } while (coinGroup.lastBlock->GetSigmaMintCount(coin.first) == 0);
         }
     }
 
     // roll back mints
     BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),std::vector<sigma::PublicCoin>) &pubCoins,
-                  index->sigmaMintedPubCoins) {
+                  coinData->sigmaMintedPubCoins) {
         BOOST_FOREACH(const sigma::PublicCoin &coin, pubCoins.second) {
             auto coins = containers.GetMints().equal_range(coin);
             auto coinIt = find_if(
@@ -991,7 +1048,7 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
     }
 
     // roll back spends
-    BOOST_FOREACH(const spend_info_container::value_type &serial, index->sigmaSpentSerials) {
+    BOOST_FOREACH(const spend_info_container::value_type &serial, coinData->sigmaSpentSerials) {
         containers.RemoveSpend(serial.first);
     }
 }
@@ -1014,11 +1071,11 @@ bool CSigmaState::IsUsedCoinSerial(const Scalar &coinSerial) {
 }
 
 bool CSigmaState::IsUsedCoinSerialHash(Scalar &coinSerial, const uint256 &coinSerialHash) {
-    for ( auto it = GetSpends().begin(); it != GetSpends().end(); ++it ){
-        if(primitives::GetSerialHash(it->first)==coinSerialHash){
-            coinSerial = it->first;
-            return true;
-        }
+    auto const& serials = containers.GetHashToSerial();
+    auto it = serials.find(coinSerialHash);
+    if (it != serials.end()) {
+        coinSerial = it->second;
+        return true;
     }
     return false;
 }
@@ -1028,12 +1085,11 @@ bool CSigmaState::HasCoin(const sigma::PublicCoin& pubCoin) {
 }
 
 bool CSigmaState::HasCoinHash(GroupElement &pubCoinValue, const uint256 &pubCoinValueHash) {
-    for ( auto it = GetMints().begin(); it != GetMints().end(); ++it ){
-        const sigma::PublicCoin & pubCoin = (*it).first;
-        if(pubCoin.getValueHash()==pubCoinValueHash){
-            pubCoinValue = pubCoin.getValue();
-            return true;
-        }
+    auto const& mints = containers.GetHashToPublicCoin();
+    auto it = mints.find(pubCoinValueHash);
+    if (it != mints.end()) {
+        pubCoinValue = it->second.getValue();
+        return true;
     }
     return false;
 }
@@ -1059,16 +1115,16 @@ int CSigmaState::GetCoinSetForSpend(
     for (CBlockIndex *block = coinGroup.lastBlock;
             ;
             block = block->pprev) {
-        if (block->sigmaMintedPubCoins.count(denomAndId) > 0 &&
-                block->sigmaMintedPubCoins[denomAndId].size() > 0) {
+        if (block->GetSigmaMintCount(denomAndId) > 0) {
             if (block->nHeight <= maxHeight) {
                 if (numberOfCoins == 0) {
                     // latest block satisfying given conditions
                     // remember block hash
                     blockHash_out = block->GetBlockHash();
                 }
+                auto coinData = block->GetCoinData();
                 BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
-                        block->sigmaMintedPubCoins[denomAndId]) {
+                        coinData->sigmaMintedPubCoins.at(denomAndId)) {
                     if (chainActive.Height() >= ::Params().GetConsensus().nStartSigmaBlacklist) {
                         if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
                             continue;
@@ -1106,11 +1162,11 @@ void CSigmaState::GetAnonymitySet(
     for (CBlockIndex *block = coinGroup.lastBlock;
             ;
             block = block->pprev) {
-        if (block->sigmaMintedPubCoins.count(denomAndId) > 0 &&
-                block->sigmaMintedPubCoins[denomAndId].size() > 0) {
+        if (block->GetSigmaMintCount(denomAndId) > 0) {
             if (block->nHeight <= maxHeight) {
+                auto coinData = block->GetCoinData();
                 BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
-                        block->sigmaMintedPubCoins[denomAndId]) {
+                        coinData->sigmaMintedPubCoins.at(denomAndId)) {
                     if (fStartSigmaBlacklist && chainActive.Height() >= params.nStartSigmaBlacklist) {
                         if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
                             continue;
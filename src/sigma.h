@@ -227,7 +227,7 @@ private:
     struct Containers {
         Containers(std::atomic<bool> & surgeCondition);
 
-        void AddMint(sigma::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo);
+        void AddMint(sigma::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& valueHash);
         void RemoveMint(sigma::PublicCoin const & pubCoin);
 
         void AddSpend(Scalar const & serial, CSpendCoinInfo const & coinInfo);
@@ -237,6 +237,8 @@ private:
 
         mint_info_container const & GetMints() const;
         spend_info_container const & GetSpends() const;
+        std::unordered_map<uint256, sigma::PublicCoin> const & GetHashToPublicCoin() const;
+        std::unordered_map<uint256, Scalar> const & GetHashToSerial() const;
         bool IsSurgeCondition() const;
     private:
         // Set of all minted pubCoin values, keyed by the public coin.
@@ -245,6 +247,10 @@ private:
         // Set of all used coin serials.
         spend_info_container usedCoinSerials;
 
+        // Hashes of minted pubCoin values and of used serials, used by the wallet to look them up
+        std::unordered_map<uint256, sigma::PublicCoin> hashToPublicCoin;
+        std::unordered_map<uint256, Scalar> hashToSerial;
+
         std::atomic<bool> & surgeCondition;
 
         typedef std::map<int, std::map<CoinDenomination, size_t>> metainfo_container_t;
@@ -47,6 +47,12 @@ Params::Params(const GroupElement& g, int n, int m) :
         h_[i - 1].sha256(buff);
         h_[i].generate(buff);
     }
+
+    std::vector<GroupElement> generators;
+    generators.reserve(1 + h_.size());
+    generators.emplace_back(g_);
+    generators.insert(generators.end(), h_.begin(), h_.end());
+    generators_table_.reset(new FixedBaseMultiExponent(generators));
 }
 
 Params::~Params(){
@@ -64,6 +70,10 @@ const std::vector<GroupElement>& Params::get_h() const{
     return h_;
 }
 
+const FixedBaseMultiExponent* Params::get_generators_table() const{
+    return generators_table_.get();
+}
+
 uint64_t Params::get_n() const{
     return n_;
 }
@@ -9,9 +9,11 @@ template<class Exponent, class GroupElement>
 class SigmaPlusVerifier{
 
 public:
+    // generators_table, if given, holds precomputed multiples of g followed by h_gens and must outlive the verifier
     SigmaPlusVerifier(const GroupElement& g,
                       const std::vector<GroupElement>& h_gens,
-                      std::size_t n, std::size_t m_);
+                      std::size_t n, std::size_t m_,
+                      const secp_primitives::FixedBaseMultiExponent* generators_table = nullptr);
 
     bool verify(const std::vector<GroupElement>& commits,
                 const SigmaPlusProof<Exponent, GroupElement>& proof,
@@ -49,6 +51,7 @@ private:
     std::vector<GroupElement> h_;
     std::size_t n;
     std::size_t m;
+    const secp_primitives::FixedBaseMultiExponent* generators_;
 };
 
 } // namespace sigma
@@ -7,11 +7,13 @@ SigmaPlusVerifier<Exponent, GroupElement>::SigmaPlusVerifier(
         const GroupElement& g,
         const std::vector<GroupElement>& h_gens,
         std::size_t n,
-        std::size_t m)
+        std::size_t m,
+        const secp_primitives::FixedBaseMultiExponent* generators_table)
     : g_(g)
     , h_(h_gens)
     , n(n)
-    , m(m){
+    , m(m)
+    , generators_(generators_table){
 }
 
 template<class Exponent, class GroupElement>
@@ -75,6 +77,10 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
         LogPrintf("Generator vector size is invalid");
         return false;
     }
+    if (generators_ && generators_->size() != 1 + n * m) {
+        LogPrintf("Generator table size is invalid");
+        return false;
+    }
     if (serials.size() != M) {
         LogPrintf("Invalid number of serials provided");
         return false;
@@ -111,7 +117,10 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
     // Set up the final batch elements
     std::vector<GroupElement> points;
     std::vector<Scalar> scalars;
-    std::size_t final_size = 2 + m * n + commits.size(); // g, h, (h_), (commits)
+    std::size_t final_size = commits.size(); // (commits)
+    if (!generators_) {
+        final_size += 2 + m * n; // g, h, (h_)
+    }
     for (std::size_t t = 0; t < M; t++) {
         final_size += 4 + proofs[t].Gk_.size(); // A, B, C, D, (G)
     }
@@ -221,14 +230,22 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
         }
     }
 
-    // Add common generators
-    points.emplace_back(g_);
-    scalars.emplace_back(g_scalar);
-    points.emplace_back(h_[0]);
-    scalars.emplace_back(h_scalar);
-    for (std::size_t i = 0; i < m * n; i++) {
-        points.emplace_back(h_[i]);
-        scalars.emplace_back(h_scalars[i]);
+    // Add common generators, these go to the precomputed table if we have one
+    std::vector<Scalar> generator_scalars;
+    if (generators_) {
+        h_scalars[0] += h_scalar;
+        generator_scalars.reserve(1 + m * n);
+        generator_scalars.emplace_back(g_scalar);
+        generator_scalars.insert(generator_scalars.end(), h_scalars.begin(), h_scalars.end());
+    } else {
+        points.emplace_back(g_);
+        scalars.emplace_back(g_scalar);
+        points.emplace_back(h_[0]);
+        scalars.emplace_back(h_scalar);
+        for (std::size_t i = 0; i < m * n; i++) {
+            points.emplace_back(h_[i]);
+            scalars.emplace_back(h_scalars[i]);
+        }
     }
     for (std::size_t i = 0; i < commits.size(); i++) {
         points.emplace_back(commits[i]);
@@ -240,8 +257,12 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
         LogPrintf("Unexpected final evaluation size");
         return false;
     }
-    secp_primitives::MultiExponent result(points, scalars);
-    if (result.get_multiple().isInfinity()) {
+    secp_primitives::MultiExponent mult(points, scalars);
+    GroupElement result = mult.get_multiple();
+    if (generators_) {
+        result += generators_->get_multiple(generator_scalars);
+    }
+    if (result.isInfinity()) {
         return true;
     }
     return false;
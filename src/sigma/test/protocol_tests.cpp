@@ -274,4 +274,37 @@ BOOST_AUTO_TEST_CASE(prove_coin_not_in_set)
     BOOST_CHECK(!verifier.verify(commits, proof, true));
 }
 
+BOOST_AUTO_TEST_CASE(one_out_of_n_fixed_base)
+{
+    auto params = sigma::Params::get_default();
+    std::size_t N = 16384;
+    std::size_t n = params->get_n();
+    std::size_t m = params->get_m();
+    std::size_t index = 10;
+
+    secp_primitives::Scalar r;
+    r.randomize();
+    sigma::SigmaPlusProver<secp_primitives::Scalar,secp_primitives::GroupElement> prover(params->get_g(), params->get_h(), n, m);
+
+    std::vector<secp_primitives::GroupElement> commits;
+    for (std::size_t i = 0; i < N; ++i) {
+        commits.push_back(secp_primitives::GroupElement());
+        commits[i].randomize();
+    }
+    secp_primitives::Scalar zero(uint64_t(0));
+    commits[index] = sigma::SigmaPrimitives<secp_primitives::Scalar,secp_primitives::GroupElement>::commit(params->get_g(), zero, params->get_h0(), r);
+
+    sigma::SigmaPlusProof<secp_primitives::Scalar,secp_primitives::GroupElement> proof(n, m);
+    prover.proof(commits, index, r, true, proof);
+
+    // Verification with the precomputed generator table agrees with the plain one
+    sigma::SigmaPlusVerifier<secp_primitives::Scalar,secp_primitives::GroupElement> verifier(params->get_g(), params->get_h(), n, m);
+    sigma::SigmaPlusVerifier<secp_primitives::Scalar,secp_primitives::GroupElement> tableVerifier(params->get_g(), params->get_h(), n, m, params->get_generators_table());
+    BOOST_CHECK(verifier.verify(commits, proof, true));
+    BOOST_CHECK(tableVerifier.verify(commits, proof, true));
+
+    commits[index].randomize();
+    BOOST_CHECK(!tableVerifier.verify(commits, proof, true));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
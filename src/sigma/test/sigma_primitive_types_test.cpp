@@ -20,4 +20,51 @@ BOOST_AUTO_TEST_CASE(scalar_test)
     BOOST_CHECK(s == s2);
 }
 
+BOOST_AUTO_TEST_CASE(group_element_batch_test)
+{
+    // Build points that are not in affine coordinates, plus infinity.
+    secp_primitives::GroupElement g;
+    g.set_base_g();
+    secp_primitives::GroupElement value(g);
+
+    std::vector<secp_primitives::GroupElement> points;
+    for (int i = 0; i < 100; i++) {
+        points.push_back(value);
+        value += g;
+        value.square();
+    }
+    points.push_back(secp_primitives::GroupElement());
+
+    const size_t size = secp_primitives::GroupElement::serialize_size;
+    std::vector<unsigned char> expected(points.size() * size);
+    for (size_t i = 0; i < points.size(); i++)
+        points[i].serialize(expected.data() + i * size);
+
+    // Serializing all of them at once gives the same bytes.
+    std::vector<unsigned char> buffer(points.size() * size);
+    BOOST_CHECK(secp_primitives::GroupElement::serialize_all(points, buffer.data()) == buffer.data() + buffer.size());
+    BOOST_CHECK(buffer == expected);
+
+    // Normalized points stay equal to the original ones.
+    std::vector<secp_primitives::GroupElement> normalized(points);
+    secp_primitives::GroupElement::normalize_all(normalized);
+    for (size_t i = 0; i < points.size(); i++) {
+        BOOST_CHECK(normalized[i] == points[i]);
+        BOOST_CHECK(normalized[i].getvch() == points[i].getvch());
+        BOOST_CHECK(normalized[i].GetHex() == points[i].GetHex());
+    }
+
+    // And they can be read back in one call.
+    std::vector<secp_primitives::GroupElement> deserialized;
+    secp_primitives::GroupElement::deserialize_all(buffer.data(), points.size(), deserialized);
+    BOOST_CHECK(deserialized == points);
+
+    // x = 5 is not on the curve.
+    std::fill(buffer.begin(), buffer.begin() + size, 0);
+    buffer[31] = 5;
+    BOOST_CHECK_THROW(
+        secp_primitives::GroupElement::deserialize_all(buffer.data(), points.size(), deserialized),
+        std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+#include "sigma_sync_cache.h"
+
+#include "chainparams.h"
+#include "firo_params.h"
+#include "sigma.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+
+namespace sigma {
+
+UniValue AnonymitySetDeltaToJSON(const CAnonymitySetDelta& delta)
+{
+    const size_t serializeSize = secp_primitives::GroupElement::serialize_size;
+
+    UniValue serializedCoins(UniValue::VARR);
+    for (auto it = delta.serializedCoins.begin(); it != delta.serializedCoins.end(); it += serializeSize)
+        serializedCoins.push_back(HexStr(it, it + serializeSize));
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("blockHash", delta.blockHash.GetHex()));
+    ret.push_back(Pair("full", delta.fFull));
+    ret.push_back(Pair("serializedCoins", serializedCoins));
+    return ret;
+}
+
+UniValue UsedSerialsDeltaToJSON(const CUsedSerialsDelta& delta)
+{
+    const size_t serializeSize = Scalar::memoryRequired();
+
+    UniValue serializedSerials(UniValue::VARR);
+    for (auto it = delta.serializedSerials.begin(); it != delta.serializedSerials.end(); it += serializeSize)
+        serializedSerials.push_back(HexStr(it, it + serializeSize));
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("blockHash", delta.blockHash.GetHex()));
+    ret.push_back(Pair("full", delta.fFull));
+    ret.push_back(Pair("serials", serializedSerials));
+    return ret;
+}
+
+CSyncCache& CSyncCache::GetInstance()
+{
+    static CSyncCache instance;
+    return instance;
+}
+
+CAnonymitySetDelta CSyncCache::GetAnonymitySet(CoinDenomination denomination, int coinGroupId, const uint256& startBlockHash)
+{
+    CAnonymitySetDelta delta;
+    std::shared_ptr<const SetSnapshot> snapshot;
+    int startHeight = -1;
+
+    {
+        LOCK(cs_main);
+        CSigmaState* sigmaState = CSigmaState::GetState();
+        std::pair<CoinDenomination, int> denomAndId = std::make_pair(denomination, coinGroupId);
+
+        CSigmaState::SigmaCoinGroupInfo coinGroup;
+        if (!sigmaState->GetCoinGroupInfo(denomination, coinGroupId, coinGroup))
+            return delta;
+
+        // the set ends with the latest block having coins of the group and enough confirmations, the same way
+        // GetCoinSetForSpend picks it
+        int maxHeight = chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1);
+        CBlockIndex* setBlock = nullptr;
+        for (CBlockIndex* block = coinGroup.lastBlock; ; block = block->pprev) {
+            if (block->nHeight <= maxHeight && block->GetSigmaMintCount(denomAndId) > 0) {
+                setBlock = block;
+                break;
+            }
+            if (block == coinGroup.firstBlock)
+                break;
+        }
+        if (!setBlock)
+            return delta;
+
+        const Consensus::Params& params = ::Params().GetConsensus();
+        bool fBlacklist = chainActive.Height() >= params.nStartSigmaBlacklist;
+
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            snapshot = sets[denomAndId];
+        }
+
+        if (!snapshot || snapshot->blockHash != setBlock->GetBlockHash() || snapshot->fBlacklist != fBlacklist) {
+            std::shared_ptr<SetSnapshot> newSnapshot = std::make_shared<SetSnapshot>();
+            newSnapshot->fBlacklist = fBlacklist;
+
+            std::vector<PublicCoin> coins;
+            sigmaState->GetCoinSetForSpend(&chainActive, maxHeight, denomination, coinGroupId, newSnapshot->blockHash, coins);
+
+            std::vector<GroupElement> values;
+            values.reserve(coins.size());
+            for (const PublicCoin& coin : coins)
+                values.push_back(coin.getValue());
+            newSnapshot->serializedCoins.resize(values.size() * GroupElement::serialize_size);
+            GroupElement::serialize_all(values, newSnapshot->serializedCoins.data());
+
+            // the set is the coins of its blocks, latest first, with the blacklisted ones left out
+            size_t offset = 0;
+            for (CBlockIndex* block = setBlock; offset < coins.size(); block = block->pprev) {
+                if (block->GetSigmaMintCount(denomAndId) > 0) {
+                    newSnapshot->blockOffsets.emplace_back(block->nHeight, offset);
+                    auto coinData = block->GetCoinData();
+                    for (const PublicCoin& coin : coinData->sigmaMintedPubCoins.at(denomAndId)) {
+                        if (offset < coins.size() && coins[offset] == coin)
+                            offset++;
+                    }
+                }
+                if (block == coinGroup.firstBlock)
+                    break;
+            }
+
+            snapshot = newSnapshot;
+            std::lock_guard<std::mutex> lock(cs);
+            sets[denomAndId] = snapshot;
+        }
+
+        // the blacklist changes the coins of old blocks, a set taken before it started has to be replaced
+        if (!startBlockHash.IsNull() && mapBlockIndex.count(startBlockHash)) {
+            CBlockIndex* startBlock = mapBlockIndex[startBlockHash];
+            if (chainActive.Contains(startBlock) && (!fBlacklist || startBlock->nHeight >= params.nStartSigmaBlacklist))
+                startHeight = startBlock->nHeight;
+        }
+    }
+
+    size_t nCoins = snapshot->serializedCoins.size() / GroupElement::serialize_size;
+    if (startHeight >= 0) {
+        for (const auto& blockOffset : snapshot->blockOffsets) {
+            if (blockOffset.first <= startHeight) {
+                nCoins = blockOffset.second;
+                break;
+            }
+        }
+        delta.fFull = false;
+    }
+
+    delta.blockHash = snapshot->blockHash;
+    delta.serializedCoins.assign(snapshot->serializedCoins.begin(),
+                                 snapshot->serializedCoins.begin() + nCoins * GroupElement::serialize_size);
+    return delta;
+}
+
+CUsedSerialsDelta CSyncCache::GetUsedSerials(const uint256& startBlockHash)
+{
+    CUsedSerialsDelta delta;
+    std::shared_ptr<const SerialsSnapshot> snapshot;
+
+    {
+        LOCK(cs_main);
+        if (!chainActive.Tip())
+            return delta;
+        delta.blockHash = chainActive.Tip()->GetBlockHash();
+
+        // a client that synced to a block of the active chain gets the serials of the blocks after it
+        if (!startBlockHash.IsNull() && mapBlockIndex.count(startBlockHash)) {
+            CBlockIndex* startBlock = mapBlockIndex[startBlockHash];
+            if (chainActive.Contains(startBlock)) {
+                delta.fFull = false;
+                for (CBlockIndex* block = chainActive.Next(startBlock); block; block = chainActive.Next(block)) {
+                    if (!block->HasCoinData())
+                        continue;
+                    auto coinData = block->GetCoinData();
+                    size_t offset = delta.serializedSerials.size();
+                    delta.serializedSerials.resize(offset + coinData->sigmaSpentSerials.size() * Scalar::memoryRequired());
+                    unsigned char* buffer = delta.serializedSerials.data() + offset;
+                    for (const auto& serial : coinData->sigmaSpentSerials)
+                        buffer = serial.first.serialize(buffer);
+                }
+                return delta;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            snapshot = serials;
+        }
+
+        if (!snapshot || snapshot->blockHash != delta.blockHash) {
+            std::shared_ptr<SerialsSnapshot> newSnapshot = std::make_shared<SerialsSnapshot>();
+            newSnapshot->blockHash = delta.blockHash;
+
+            const spend_info_container& spends = CSigmaState::GetState()->GetSpends();
+            newSnapshot->serializedSerials.resize(spends.size() * Scalar::memoryRequired());
+            unsigned char* buffer = newSnapshot->serializedSerials.data();
+            for (const auto& spend : spends)
+                buffer = spend.first.serialize(buffer);
+
+            snapshot = newSnapshot;
+            std::lock_guard<std::mutex> lock(cs);
+            serials = snapshot;
+        }
+    }
+
+    delta.serializedSerials = snapshot->serializedSerials;
+    return delta;
+}
+
+} // namespace sigma
@@ -0,0 +1,94 @@
+#ifndef FIRO_SIGMA_SYNC_CACHE_H
+#define FIRO_SIGMA_SYNC_CACHE_H
+
+#include "sigma/coin.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <univalue.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace sigma {
+
+// Coins of an anonymity set minted after the block a light client synced to last time, or all of them
+struct CAnonymitySetDelta {
+    // Last block of the set, to be passed back with the next request
+    uint256 blockHash;
+    // Whether these are all the coins of the set rather than just the new ones
+    bool fFull = true;
+    // GroupElement::serialize_size bytes per coin, the latest coins first as GetCoinSetForSpend returns them
+    std::vector<unsigned char> serializedCoins;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(blockHash);
+        READWRITE(fFull);
+        READWRITE(serializedCoins);
+    }
+};
+
+// Serials spent after the block a light client synced to last time, or all of them
+struct CUsedSerialsDelta {
+    // Tip the serials are taken at, to be passed back with the next request
+    uint256 blockHash;
+    // Whether these are all the used serials rather than just the new ones
+    bool fFull = true;
+    // Scalar::memoryRequired() bytes per serial
+    std::vector<unsigned char> serializedSerials;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(blockHash);
+        READWRITE(fFull);
+        READWRITE(serializedSerials);
+    }
+};
+
+UniValue AnonymitySetDeltaToJSON(const CAnonymitySetDelta& delta);
+UniValue UsedSerialsDeltaToJSON(const CUsedSerialsDelta& delta);
+
+/*
+ * Serialized anonymity sets and used serials served to light clients. A snapshot of every coin group is kept until
+ * the set changes and the used serials until the tip does, so that clients polling them don't have the whole state
+ * walked and serialized on every request. A client passing the block hash of its previous response gets only what
+ * was added since, or everything once that block left the active chain.
+ */
+class CSyncCache {
+public:
+    static CSyncCache& GetInstance();
+
+    // Both take cs_main to look at the chain, the coins are copied out of the snapshots after releasing it
+    CAnonymitySetDelta GetAnonymitySet(CoinDenomination denomination, int coinGroupId, const uint256& startBlockHash);
+    CUsedSerialsDelta GetUsedSerials(const uint256& startBlockHash);
+
+private:
+    struct SetSnapshot {
+        uint256 blockHash;
+        bool fBlacklist;
+        std::vector<unsigned char> serializedCoins;
+        // Heights of the blocks having coins in the set, latest first, with the number of set coins minted after them
+        std::vector<std::pair<int, size_t>> blockOffsets;
+    };
+
+    struct SerialsSnapshot {
+        uint256 blockHash;
+        std::vector<unsigned char> serializedSerials;
+    };
+
+    std::mutex cs;
+    std::map<std::pair<CoinDenomination, int>, std::shared_ptr<const SetSnapshot>> sets;
+    std::shared_ptr<const SerialsSnapshot> serials;
+};
+
+} // namespace sigma
+
+#endif // FIRO_SIGMA_SYNC_CACHE_H
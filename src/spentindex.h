@@ -322,6 +322,83 @@ struct CAddressIndexIteratorKey {
     }
 };
 
+struct CAddressBalanceKey {
+    AddressType type;
+    uint160 hashBytes;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        ser_writedata8(s, static_cast<unsigned int>(type));
+        hashBytes.Serialize(s);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        type = static_cast<AddressType>(ser_readdata8(s));
+        hashBytes.Unserialize(s);
+    }
+
+    CAddressBalanceKey(AddressType addressType, uint160 addressHash) {
+        type = addressType;
+        hashBytes = addressHash;
+    }
+
+    CAddressBalanceKey() {
+        SetNull();
+    }
+
+    void SetNull() {
+        type = AddressType::unknown;
+        hashBytes.SetNull();
+    }
+
+    bool operator<(const CAddressBalanceKey& other) const {
+        if (type != other.type)
+            return type < other.type;
+        return hashBytes < other.hashBytes;
+    }
+};
+
+// Totals of the address index entries of an address, kept up to date as blocks are connected and disconnected
+struct CAddressBalanceValue {
+    CAmount balance;
+    CAmount received;
+    int64_t txCount;
+    int64_t unspentCount;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(balance);
+        READWRITE(received);
+        READWRITE(txCount);
+        READWRITE(unspentCount);
+    }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+        txCount = 0;
+        unspentCount = 0;
+    }
+
+    bool IsNull() const {
+        return balance == 0 && received == 0 && txCount == 0 && unspentCount == 0;
+    }
+
+    CAddressBalanceValue& operator+=(const CAddressBalanceValue& other) {
+        balance += other.balance;
+        received += other.received;
+        txCount += other.txCount;
+        unspentCount += other.unspentCount;
+        return *this;
+    }
+};
+
 struct CAddressIndexIteratorHeightKey {
     AddressType type;
     uint160 hashBytes;
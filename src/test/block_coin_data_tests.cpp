@@ -0,0 +1,151 @@
+#include "../chain.h"
+#include "../clientversion.h"
+#include "../streams.h"
+#include "../txdb.h"
+#include "../validation.h"
+
+#include "test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+class BlockCoinDataTests : public TestingSetup {
+public:
+    BlockCoinDataTests() : TestingSetup(CBaseChainParams::REGTEST) {
+        const auto& params = ::Params().GetConsensus();
+        index.nHeight = std::max(params.nLelantusFixesStartBlock, std::max(params.nSigmaStartBlock, params.nLelantusStartBlock));
+    }
+
+public:
+    // Puts Sigma mints of two groups, Lelantus mints and spends of both into the index
+    void AddCoins() {
+        CBlockCoinData& data = index.ModifyCoinData();
+        for (int i = 0; i < 3; i++) {
+            GroupElement value;
+            value.randomize();
+            data.sigmaMintedPubCoins[denom1Group1].push_back(sigma::PublicCoin(value, sigma::CoinDenomination::SIGMA_DENOM_1));
+        }
+        GroupElement value;
+        value.randomize();
+        data.sigmaMintedPubCoins[denom10Group2].push_back(sigma::PublicCoin(value, sigma::CoinDenomination::SIGMA_DENOM_10));
+
+        for (int i = 0; i < 2; i++) {
+            value.randomize();
+            data.lelantusMintedPubCoins[2].push_back(std::make_pair(lelantus::PublicCoin(value), GetRandHash()));
+        }
+
+        Scalar serial;
+        serial.randomize();
+        data.sigmaSpentSerials[serial] = sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+        for (int i = 0; i < 2; i++) {
+            serial.randomize();
+            data.lelantusSpentSerials[serial] = 1;
+        }
+
+        index.anonymitySetHash[2] = std::vector<unsigned char>(32, 0xab);
+    }
+
+    void CheckCounts(const CBlockCoinCounts& counts) {
+        BOOST_CHECK(counts.sigmaMints == (std::map<std::pair<sigma::CoinDenomination, int>, size_t>{{denom1Group1, 3}, {denom10Group2, 1}}));
+        BOOST_CHECK(counts.lelantusMints == (std::map<int, size_t>{{2, 2}}));
+        BOOST_CHECK_EQUAL(counts.nSpends, 3U);
+    }
+
+    void CheckData(const CBlockCoinData& data) {
+        const CBlockCoinData& expected = *index.GetCoinData();
+        BOOST_CHECK(data.sigmaMintedPubCoins == expected.sigmaMintedPubCoins);
+        BOOST_CHECK(data.sigmaSpentSerials.size() == expected.sigmaSpentSerials.size());
+        for (const auto& serial : expected.sigmaSpentSerials)
+            BOOST_CHECK(data.sigmaSpentSerials.count(serial.first));
+        BOOST_CHECK(data.lelantusMintedPubCoins == expected.lelantusMintedPubCoins);
+        BOOST_CHECK(data.lelantusSpentSerials == expected.lelantusSpentSerials);
+    }
+
+public:
+    CBlockIndex index;
+    std::pair<sigma::CoinDenomination, int> denom1Group1 = {sigma::CoinDenomination::SIGMA_DENOM_1, 1};
+    std::pair<sigma::CoinDenomination, int> denom10Group2 = {sigma::CoinDenomination::SIGMA_DENOM_10, 2};
+};
+
+BOOST_FIXTURE_TEST_SUITE(block_coin_data_tests, BlockCoinDataTests)
+
+BOOST_AUTO_TEST_CASE(count_coins_only)
+{
+    AddCoins();
+
+    CDataStream stream(SER_DISK, CLIENT_VERSION);
+    stream << CDiskBlockIndex(&index);
+
+    // counting skips exactly over the coins, the fields written after them are read as they were
+    CDiskBlockIndex counted;
+    counted.fCountCoinsOnly = true;
+    CDataStream(stream) >> counted;
+    CheckCounts(counted.diskCoinCounts);
+    BOOST_CHECK(counted.anonymitySetHash == index.anonymitySetHash);
+
+    CDiskBlockIndex full;
+    stream >> full;
+    CheckData(full.diskCoinData);
+    CheckCounts(CBlockCoinCounts(full.diskCoinData));
+    BOOST_CHECK(full.anonymitySetHash == index.anonymitySetHash);
+}
+
+BOOST_AUTO_TEST_CASE(counts_after_release)
+{
+    BOOST_CHECK(!index.HasCoinData());
+    BOOST_CHECK(!index.IsCoinDataModified());
+    BOOST_CHECK(index.GetCoinData()->sigmaMintedPubCoins.empty());
+
+    AddCoins();
+    BOOST_CHECK(index.HasCoinData());
+    BOOST_CHECK(index.IsCoinDataModified());
+    BOOST_CHECK_EQUAL(index.GetSigmaMintCount(denom1Group1), 3U);
+    BOOST_CHECK_EQUAL(index.GetLelantusMintCount(2), 2U);
+    BOOST_CHECK_EQUAL(index.GetLelantusMintCount(1), 0U);
+
+    // the data handed out isn't changed by later modifications
+    auto data = index.GetCoinData();
+    index.ModifyCoinData().lelantusMintedPubCoins.clear();
+    BOOST_CHECK_EQUAL(data->lelantusMintedPubCoins.size(), 1U);
+    BOOST_CHECK_EQUAL(index.GetLelantusMintCount(2), 0U);
+
+    index.ModifyCoinData().lelantusMintedPubCoins = data->lelantusMintedPubCoins;
+    index.ReleaseCoinData();
+    BOOST_CHECK(!index.IsCoinDataModified());
+    BOOST_CHECK(index.HasCoinData());
+    BOOST_CHECK_EQUAL(index.GetSigmaMintCount(denom1Group1), 3U);
+    BOOST_CHECK_EQUAL(index.GetSigmaMintCount(denom10Group2), 1U);
+    BOOST_CHECK_EQUAL(index.GetLelantusMintCount(2), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(read_from_db)
+{
+    uint256 hash = GetRandHash();
+    index.phashBlock = &hash;
+    AddCoins();
+    CBlockCoinData data = *index.GetCoinData();
+
+    BOOST_CHECK(pblocktree->WriteBatchSync({}, 0, {&index}));
+    index.ReleaseCoinData();
+
+    // read back from the database once the cache doesn't have them
+    CBlockIndex::ClearCoinDataCache();
+    CheckData(data);
+    CBlockCoinData diskData;
+    BOOST_CHECK(pblocktree->ReadBlockCoinData(hash, diskData));
+    CheckCounts(CBlockCoinCounts(diskData));
+
+    // changes are kept in memory until written again
+    index.ModifyCoinData().sigmaMintedPubCoins.erase(denom10Group2);
+    BOOST_CHECK_EQUAL(index.GetSigmaMintCount(denom10Group2), 0U);
+    BOOST_CHECK(pblocktree->ReadBlockCoinData(hash, diskData));
+    BOOST_CHECK_EQUAL(diskData.sigmaMintedPubCoins.count(denom10Group2), 1U);
+
+    BOOST_CHECK(pblocktree->WriteBatchSync({}, 0, {&index}));
+    index.ReleaseCoinData();
+    CBlockIndex::ClearCoinDataCache();
+    BOOST_CHECK_EQUAL(index.GetCoinData()->sigmaMintedPubCoins.count(denom10Group2), 0U);
+    BOOST_CHECK_EQUAL(index.GetSigmaMintCount(denom10Group2), 0U);
+    BOOST_CHECK_EQUAL(index.GetSigmaMintCount(denom1Group1), 3U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
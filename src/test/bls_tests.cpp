@@ -4,6 +4,7 @@
 
 #include "bls/bls.h"
 #include "bls/bls_batchverifier.h"
+#include "bls/bls_worker.h"
 #include "test/test_bitcoin.h"
 
 #include <boost/test/unit_test.hpp>
@@ -154,4 +155,41 @@ BOOST_AUTO_TEST_CASE(batch_verifier_tests)
     Verify(msgs);
 }
 
+BOOST_AUTO_TEST_CASE(worker_cache_tests)
+{
+    CBLSWorker worker;
+    CBLSWorkerCache cache(worker, 2);
+
+    std::vector<uint256> hashes;
+    BLSIdVector ids;
+    for (int i = 0; i < 6; i++) {
+        hashes.emplace_back(GetRandHash());
+        ids.emplace_back(hashes.back());
+    }
+    BLSVerificationVectorPtr vvec;
+    BLSSecretKeyVector skShares;
+    BOOST_CHECK(worker.GenerateContributions(3, ids, vvec, skShares));
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        BOOST_CHECK(cache.BuildPubKeyShare(hashes[i], vvec, ids[i]) == skShares[i].GetPublicKey());
+    }
+    // the least recently used entries were dropped once the cache had grown past twice its size
+    auto stats = cache.GetStats().publicKeyShare;
+    BOOST_CHECK_EQUAL(stats.hits, 0U);
+    BOOST_CHECK_EQUAL(stats.misses, 6U);
+    BOOST_CHECK_EQUAL(stats.size, 3U);
+
+    // the most recent ones are still there, the first one has to be built again
+    BOOST_CHECK(cache.BuildPubKeyShare(hashes[5], vvec, ids[5]) == skShares[5].GetPublicKey());
+    BOOST_CHECK(cache.BuildPubKeyShare(hashes[0], vvec, ids[0]) == skShares[0].GetPublicKey());
+    stats = cache.GetStats().publicKeyShare;
+    BOOST_CHECK_EQUAL(stats.hits, 1U);
+    BOOST_CHECK_EQUAL(stats.misses, 7U);
+    BOOST_CHECK_EQUAL(stats.size, 4U);
+
+    auto vvecStats = cache.GetStats().vvec;
+    BOOST_CHECK_EQUAL(vvecStats.hits + vvecStats.misses, 0U);
+    BOOST_CHECK_EQUAL(vvecStats.size, 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
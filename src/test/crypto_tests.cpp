@@ -269,6 +269,30 @@ BOOST_AUTO_TEST_CASE(sha256_testvectors) {
     TestSHA256(test1, "a316d55510b49662420f49d145d42fb83f31ef8dc016aa4e32df049991a91e26");
 }
 
+BOOST_AUTO_TEST_CASE(sha256_64) {
+    // Every batch size up to 32, so that the 8, 4, 2 and 1 way transforms all get their turn
+    for (int i = 0; i <= 32; ++i) {
+        unsigned char in[64 * 32];
+        unsigned char single[32 * 32], twice[32 * 32];
+        unsigned char out[32 * 32];
+        for (int j = 0; j < 64 * i; ++j) {
+            in[j] = insecure_rand() & 0xff;
+        }
+        for (int j = 0; j < i; ++j) {
+            CSHA256().Write(in + 64 * j, 64).Finalize(single + 32 * j);
+            CSHA256().Write(single + 32 * j, 32).Finalize(twice + 32 * j);
+        }
+        SHA256_64(out, in, i);
+        BOOST_CHECK(memcmp(single, out, 32 * i) == 0);
+        SHA256D64(out, in, i);
+        BOOST_CHECK(memcmp(twice, out, 32 * i) == 0);
+
+        // ComputeMerkleRoot hashes in place
+        SHA256D64(in, in, i);
+        BOOST_CHECK(memcmp(twice, in, 32 * i) == 0);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(sha512_testvectors) {
     TestSHA512("",
                "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
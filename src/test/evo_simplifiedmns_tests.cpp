@@ -5,7 +5,9 @@
 #include "test/test_bitcoin.h"
 
 #include "bls/bls.h"
+#include "evo/deterministicmns.h"
 #include "evo/simplifiedmns.h"
+#include "hash.h"
 #include "netbase.h"
 
 #include <boost/test/unit_test.hpp>
@@ -67,4 +69,58 @@ BOOST_AUTO_TEST_CASE(simplifiedmns_merkleroots)
 
     BOOST_CHECK(expectedMerkleRoot == calculatedMerkleRoot);
 }
+
+static CDeterministicMNCPtr BuildMN(uint64_t internalId)
+{
+    auto dmn = std::make_shared<CDeterministicMN>();
+    dmn->proTxHash = ::SerializeHash(internalId);
+    dmn->internalId = internalId;
+    dmn->collateralOutpoint = COutPoint(dmn->proTxHash, 0);
+
+    auto dmnState = std::make_shared<CDeterministicMNState>();
+    dmnState->keyIDOwner = CKeyID(Hash160(dmn->proTxHash.begin(), dmn->proTxHash.end()));
+    std::vector<unsigned char> vecBytes{static_cast<unsigned char>(internalId + 1)};
+    vecBytes.resize(CBLSSecretKey::SerSize);
+    dmnState->pubKeyOperator.Set(CBLSSecretKey(vecBytes).GetPublicKey());
+    dmn->pdmnState = dmnState;
+    return dmn;
+}
+
+static void UpdateMN(CDeterministicMNList& mnList, uint64_t internalId, const std::function<void(CDeterministicMNState&)>& update)
+{
+    auto dmn = mnList.GetMNByInternalId(internalId);
+    auto dmnState = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+    update(*dmnState);
+    mnList.UpdateMN(dmn->proTxHash, dmnState);
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_snapshots_and_diffs)
+{
+    CDeterministicMNList fromList(uint256(), 0, 0);
+    for (uint64_t i = 0; i < 20; i++) {
+        fromList.AddMN(BuildMN(i));
+    }
+
+    CDeterministicMNList toList = fromList;
+    toList.RemoveMN(toList.GetMNByInternalId(3)->proTxHash);
+    UpdateMN(toList, 5, [](CDeterministicMNState& dmnState) { dmnState.nPoSeBanHeight = 10; });
+    // not part of the simplified list
+    UpdateMN(toList, 7, [](CDeterministicMNState& dmnState) { dmnState.nLastPaidHeight = 10; });
+    toList.AddMN(BuildMN(20));
+
+    CSimplifiedMNListSnapshot fromSnapshot(fromList);
+    CSimplifiedMNListSnapshot toSnapshot(fromSnapshot, fromList, toList, fromList.BuildDiff(toList));
+    BOOST_CHECK(fromSnapshot.merkleRoot == CSimplifiedMNList(fromList).CalcMerkleRoot());
+    BOOST_CHECK(toSnapshot.merkleRoot == CSimplifiedMNList(toList).CalcMerkleRoot());
+    BOOST_CHECK(toSnapshot.entryHashes == CSimplifiedMNListSnapshot(toList).entryHashes);
+
+    // only looking at the changed MNs gives the same diff as comparing all of them
+    auto diff = fromList.BuildSimplifiedDiff(toList, {3, 5, 7, 20});
+    auto fullDiff = fromList.BuildSimplifiedDiff(toList);
+    BOOST_CHECK(diff.deletedMNs == fullDiff.deletedMNs);
+    BOOST_CHECK_EQUAL(diff.mnList.size(), 2U);
+    BOOST_CHECK_EQUAL(fullDiff.mnList.size(), 2U);
+    BOOST_CHECK(std::is_permutation(diff.mnList.begin(), diff.mnList.end(), fullDiff.mnList.begin()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
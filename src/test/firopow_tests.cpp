@@ -6,6 +6,9 @@
 #include <crypto/progpow/lib/ethash/ethash-internal.hpp>
 #include <crypto/progpow/include/ethash/progpow.hpp>
 #include <crypto/progpow/helpers.hpp>
+#include <crypto/progpow.h>
+
+#include <boost/thread.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(firpow_tests, BasicTestingSetup)
 BOOST_AUTO_TEST_CASE(firopow_hash_and_verify) {
@@ -39,4 +42,41 @@ BOOST_AUTO_TEST_CASE(firopow_hash_and_verify) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(firopow_epoch_context_cache) {
+
+    // Hash the test cases from several threads sharing the cached contexts
+    auto check = [](bool& ok) {
+        ok = true;
+        for (auto& t : firopow_hash_test_cases) {
+            const auto context{progpow_get_epoch_context(ethash::get_epoch_number(t.block_number))};
+            const ethash::hash256 header{to_hash256(t.header_hash_hex)};
+            const uint64_t nonce{std::stoull(t.nonce_hex, nullptr, 16)};
+
+            auto result{progpow::hash(*context, t.block_number, header, nonce)};
+            ok = ok && ethash::is_equal(result.final_hash, to_hash256(t.final_hash_hex));
+            ok = ok && ethash::is_equal(result.mix_hash, to_hash256(t.mix_hash_hex));
+        }
+    };
+
+    bool threadsOk[4];
+    boost::thread_group threads;
+    for (int i = 0; i < 4; ++i)
+        threads.create_thread(boost::bind<void>(check, boost::ref(threadsOk[i])));
+    threads.join_all();
+    for (int i = 0; i < 4; ++i)
+        BOOST_CHECK(threadsOk[i]);
+
+    // The same context is handed out while it is cached
+    const auto context{progpow_get_epoch_context(1)};
+    BOOST_CHECK_EQUAL(context->epoch_number, 1);
+    BOOST_CHECK(context == progpow_get_epoch_context(1));
+
+    // The next epoch is built in the background and then handed out
+    progpow_prefetch_epoch(2);
+    const auto next{progpow_get_epoch_context(2)};
+    BOOST_CHECK_EQUAL(next->epoch_number, 2);
+    BOOST_CHECK(next == progpow_get_epoch_context(2));
+    BOOST_CHECK(context == progpow_get_epoch_context(1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+#include "../lelantus_mempool_verifier.h"
+#include "../arith_uint256.h"
+#include "../firo_params.h"
+
+#include "test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+namespace lelantus {
+
+class LelantusMempoolVerifierTests : public BasicTestingSetup {
+public:
+    LelantusMempoolVerifierTests() : BasicTestingSetup(CBaseChainParams::REGTEST), params(Params::get_default()) {
+    }
+
+public:
+    // Builds a joinsplit spending a coin out of a fresh anonymity set and takes its proofs out of it
+    void AddJoinSplit() {
+        PrivateCoin input(params, 10 * COIN);
+        PrivateCoin output(params, 5 * COIN);
+
+        std::vector<PublicCoin> coins;
+        for (size_t i = 0; i < 20; i++) {
+            PrivateCoin coin(params, 1);
+            coins.push_back(coin.getPublicCoin());
+        }
+        coins[7] = input.getPublicCoin();
+
+        std::map<uint32_t, std::vector<PublicCoin>> anonymitySets = {{1, coins}};
+        std::vector<std::pair<PrivateCoin, uint32_t>> cin = {{input, 1}};
+        std::map<uint32_t, uint256> groupBlockHashes = {{1, ArithToUint256(1)}};
+
+        // inputs = 10, outputs = 5(mint) + 4.99(vout) + 0.01(fee)
+        uint64_t vout = 5 * COIN - CENT;
+        JoinSplit joinSplit(params, cin, anonymitySets, {}, vout, {output}, CENT, groupBlockHashes, ArithToUint256(2), LELANTUS_TX_VERSION_4);
+
+        std::vector<PublicCoin> cout = {output.getPublicCoin()};
+        Scalar challenge;
+        BOOST_CHECK(joinSplit.Verify(anonymitySets, {}, cout, vout, ArithToUint256(2), challenge, true));
+
+        JoinSplitProofs proofs;
+        proofs.Set(&joinSplit, {{1, std::make_shared<const std::vector<PublicCoin>>(coins)}}, challenge, cout, uint256());
+        joinSplits.push_back(proofs);
+    }
+
+    std::vector<bool> Verify() {
+        std::vector<const JoinSplitProofs*> proofs;
+        for (const auto& joinSplit : joinSplits)
+            proofs.push_back(&joinSplit);
+        return CMempoolVerifier::Verify(proofs);
+    }
+
+public:
+    const Params* params;
+    std::vector<JoinSplitProofs> joinSplits;
+};
+
+BOOST_FIXTURE_TEST_SUITE(lelantus_mempool_verifier_tests, LelantusMempoolVerifierTests)
+
+BOOST_AUTO_TEST_CASE(verify_batch)
+{
+    for (int i = 0; i < 5; i++)
+        AddJoinSplit();
+
+    BOOST_CHECK(Verify() == std::vector<bool>(5, true));
+
+    // sigma proof checked against a wrong challenge
+    joinSplits[1].challenge.randomize();
+    // range proof of the wrong output
+    joinSplits[4].Cout = joinSplits[3].Cout;
+
+    BOOST_CHECK(Verify() == std::vector<bool>({true, false, true, true, false}));
+}
+
+BOOST_AUTO_TEST_CASE(verify_single)
+{
+    AddJoinSplit();
+    BOOST_CHECK(Verify() == std::vector<bool>({true}));
+
+    joinSplits[0].sigmaProofs[0].serials[0].randomize();
+    BOOST_CHECK(Verify() == std::vector<bool>({false}));
+
+    BOOST_CHECK(CMempoolVerifier::Verify({}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(proofs_key)
+{
+    uint256 txHash = ArithToUint256(1);
+    Scalar challenge;
+    challenge.randomize();
+
+    uint256 blockHash = ArithToUint256(3);
+
+    uint256 key = CMempoolVerifier::GetProofsKey(txHash, challenge, {{1, 20}}, {{1, blockHash}});
+    BOOST_CHECK(key == CMempoolVerifier::GetProofsKey(txHash, challenge, {{1, 20}}, {{1, blockHash}}));
+    BOOST_CHECK(key != CMempoolVerifier::GetProofsKey(txHash, challenge, {{1, 21}}, {{1, blockHash}}));
+    BOOST_CHECK(key != CMempoolVerifier::GetProofsKey(txHash, challenge, {{2, 20}}, {{2, blockHash}}));
+    BOOST_CHECK(key != CMempoolVerifier::GetProofsKey(txHash, challenge, {{1, 20}}, {{1, ArithToUint256(4)}}));
+    BOOST_CHECK(key != CMempoolVerifier::GetProofsKey(ArithToUint256(2), challenge, {{1, 20}}, {{1, blockHash}}));
+
+    Scalar otherChallenge;
+    otherChallenge.randomize();
+    BOOST_CHECK(key != CMempoolVerifier::GetProofsKey(txHash, otherChallenge, {{1, 20}}, {{1, blockHash}}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace lelantus
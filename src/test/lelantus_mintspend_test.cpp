@@ -130,7 +130,9 @@ BOOST_AUTO_TEST_CASE(lelantus_mintspend_test)
 
     //Temporary disable usedCoinSerials check to force double spend in mempool
     auto tempSerials = lelantusState->containers.usedCoinSerials;
+    auto tempSerialHashes = lelantusState->containers.hashToSerial;
     lelantusState->containers.usedCoinSerials.clear();
+    lelantusState->containers.hashToSerial.clear();
 
     {
         //Set mints unused, and try to spend again
@@ -142,14 +144,18 @@ BOOST_AUTO_TEST_CASE(lelantus_mintspend_test)
     }
 
     lelantusState->containers.usedCoinSerials = tempSerials;
+    lelantusState->containers.hashToSerial = tempSerialHashes;
 
     BOOST_CHECK_EXCEPTION(CreateBlock({CMutableTransaction(*wtx.tx)}, script), std::runtime_error, no_check);
     BOOST_CHECK_MESSAGE(mempool.size() == 1, "Mempool not set");
     tempSerials = lelantusState->containers.usedCoinSerials;
+    tempSerialHashes = lelantusState->containers.hashToSerial;
     lelantusState->containers.usedCoinSerials.clear();
+    lelantusState->containers.hashToSerial.clear();
     CBlock b = CreateBlock({CMutableTransaction(*wtx.tx)}, script);
 
     lelantusState->containers.usedCoinSerials = tempSerials;
+    lelantusState->containers.hashToSerial = tempSerialHashes;
 
     mempool.clear();
     previousHeight = chainActive.Height();
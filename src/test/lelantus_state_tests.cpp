@@ -86,7 +86,7 @@ public:
                 Scalar serial;
                 serial.randomize();
 
-                index->lelantusSpentSerials[serial] = s.first;
+                index->ModifyCoinData().lelantusSpentSerials[serial] = s.first;
             }
         }
 
@@ -287,7 +287,7 @@ BOOST_AUTO_TEST_CASE(add_remove_block)
     auto index3 = GenerateBlock({});
     auto block3 = GetCBlock(index3);
     PopulateLelantusTxInfo(block3, {}, {{serial1, 1}, {serial2, 1}});
-    index3->lelantusSpentSerials = block3.lelantusTxInfo->spentSerials;
+    index3->ModifyCoinData().lelantusSpentSerials = block3.lelantusTxInfo->spentSerials;
 
     lelantusState->AddBlock(index3);
 
@@ -305,7 +305,7 @@ BOOST_AUTO_TEST_CASE(add_remove_block)
     auto block4 = GetCBlock(index4);
     PopulateLelantusTxInfo(block4, {{mint3, {1, uint256()}}}, {{serial3, 1}});
     lelantusState->AddMintsToStateAndBlockIndex(index4, &block4);
-    index4->lelantusSpentSerials = block4.lelantusTxInfo->spentSerials;
+    index4->ModifyCoinData().lelantusSpentSerials = block4.lelantusTxInfo->spentSerials;
 
     lelantusState->AddBlock(index4);
 
@@ -327,6 +327,17 @@ BOOST_AUTO_TEST_CASE(add_remove_block)
     BOOST_CHECK(lelantusState->IsUsedCoinSerial(serial2));
     BOOST_CHECK(!lelantusState->IsUsedCoinSerial(serial3));
 
+    // verify hash lookups are rolled back as well
+    GroupElement receivedMint;
+    Scalar receivedSerial;
+    BOOST_CHECK(lelantusState->HasCoinHash(receivedMint, primitives::GetPubCoinValueHash(mint1)));
+    BOOST_CHECK(receivedMint == mint1);
+    BOOST_CHECK(!lelantusState->HasCoinHash(receivedMint, primitives::GetPubCoinValueHash(mint3)));
+
+    BOOST_CHECK(lelantusState->IsUsedCoinSerialHash(receivedSerial, primitives::GetSerialHash(serial2)));
+    BOOST_CHECK(receivedSerial == serial2);
+    BOOST_CHECK(!lelantusState->IsUsedCoinSerialHash(receivedSerial, primitives::GetSerialHash(serial3)));
+
     lelantusState->Reset();
 }
 
@@ -401,7 +412,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
 
     verifyGroup(1, 6, indexes[0], indexes[2]);
     uint256 blockHashOut1;
-    std::vector<PublicCoin> coinOut1;
+    CLelantusState::AnonymitySetRef coinOut1;
     std::vector<unsigned char> setHash;
     BOOST_CHECK_EQUAL(6, lelantusState->GetCoinSetForSpend(
         &chainActive,
@@ -411,7 +422,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
         coinOut1,
         setHash));
 
-    verifyMints(0, 6, coinOut1);
+    verifyMints(0, 6, *coinOut1);
     BOOST_CHECK(indexes[2]->GetBlockHash() == blockHashOut1);
 
     // 8 coins, 1(6), 2(4)
@@ -420,7 +431,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
     verifyGroup(1, 6, indexes[0], indexes[2], 1);
 
     uint256 blockHashOut2;
-    std::vector<PublicCoin> coinOut2;
+    CLelantusState::AnonymitySetRef coinOut2;
     BOOST_CHECK_EQUAL(4, lelantusState->GetCoinSetForSpend(
         &chainActive,
         indexes[3]->nHeight + 1, // specify limit with no mints block
@@ -429,7 +440,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
         coinOut2,
         setHash));
 
-    verifyMints(4, 8, coinOut2);
+    verifyMints(4, 8, *coinOut2);
     BOOST_CHECK(indexes[3]->GetBlockHash() == blockHashOut2);
 
     // 10 coins, 1(6), 2(6)
@@ -439,7 +450,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
     verifyGroup(1, 6, indexes[0], indexes[2], 1);
 
     uint256 blockHashOut3;
-    std::vector<PublicCoin> coinOut3;
+    CLelantusState::AnonymitySetRef coinOut3;
     BOOST_CHECK_EQUAL(6, lelantusState->GetCoinSetForSpend(
         &chainActive,
         indexes[4]->nHeight,
@@ -448,7 +459,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
         coinOut3,
         setHash));
 
-    verifyMints(4, 10, coinOut3);
+    verifyMints(4, 10, *coinOut3);
     BOOST_CHECK(indexes[4]->GetBlockHash() == blockHashOut3);
 
     // 12 coins, 1(6), 2(6), 3(4)
@@ -459,7 +470,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
     verifyGroup(1, 6, indexes[0], indexes[2], 1);
 
     uint256 blockHashOut4;
-    std::vector<PublicCoin> coinOut4;
+    CLelantusState::AnonymitySetRef coinOut4;
     BOOST_CHECK_EQUAL(4, lelantusState->GetCoinSetForSpend(
         &chainActive,
         indexes[5]->nHeight,
@@ -468,11 +479,11 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
         coinOut4,
         setHash));
 
-    verifyMints(8, 12, coinOut4);
+    verifyMints(8, 12, *coinOut4);
 
     // Get first group
     uint256 blockHashOut5;
-    std::vector<PublicCoin> coinOut5;
+    CLelantusState::AnonymitySetRef coinOut5;
     BOOST_CHECK_EQUAL(6, lelantusState->GetCoinSetForSpend(
         &chainActive,
         indexes[5]->nHeight,
@@ -481,12 +492,12 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
         coinOut5,
         setHash));
 
-    verifyMints(0, 6, coinOut5);
+    verifyMints(0, 6, *coinOut5);
     BOOST_CHECK(indexes[2]->GetBlockHash() == blockHashOut5);
 
     // Get first group with low max height
     uint256 blockHashOut6;
-    std::vector<PublicCoin> coinOut6;
+    CLelantusState::AnonymitySetRef coinOut6;
     BOOST_CHECK_EQUAL(2, lelantusState->GetCoinSetForSpend(
         &chainActive,
         indexes[0]->nHeight,
@@ -495,7 +506,7 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
         coinOut6,
         setHash));
 
-    verifyMints(0, 2, coinOut6);
+    verifyMints(0, 2, *coinOut6);
     BOOST_CHECK(indexes[0]->GetBlockHash() == blockHashOut6);
 
     lelantusState->RemoveBlock(indexes[5]);
@@ -505,6 +516,136 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
     lelantusState->Reset();
 }
 
+BOOST_AUTO_TEST_CASE(anonymity_set_at_block)
+{
+    GenerateBlocks(120);
+
+    std::vector<CAmount> amounts(8, COIN);
+    std::vector<CMutableTransaction> txs;
+
+    auto mints = GenerateMints(amounts, txs);
+
+    std::vector<PublicCoin> coins;
+    std::vector<CBlockIndex*> indexes, emptyIndexes;
+    std::vector<CBlock> blocks;
+
+    for (size_t i = 0; i != mints.size(); i += 2) {
+        auto index = GenerateBlock({txs[i], txs[i + 1]});
+        auto block = GetCBlock(index);
+        coins.push_back(mints[i + 1].GetPubcoinValue());
+        coins.push_back(mints[i].GetPubcoinValue());
+
+        PopulateLelantusTxInfo(
+            block,
+            {
+                {mints[i].GetPubcoinValue(), {1, uint256()}},
+                {mints[i + 1].GetPubcoinValue(), {1, uint256()}}
+            }, {});
+
+        indexes.push_back(index);
+        blocks.push_back(block);
+
+        // blocks without mints in between
+        emptyIndexes.push_back(GenerateBlock({}));
+    }
+
+    CLelantusState state(6, 2);
+
+    auto verifyMints = [&](size_t i, size_t j, std::vector<PublicCoin> const &coinSet) {
+        std::vector<PublicCoin> expected(coins.begin() + i, coins.begin() + j);
+        std::reverse(expected.begin(), expected.end());
+
+        BOOST_CHECK(expected == coinSet);
+    };
+
+    // 6 coins, 1(6)
+    for (size_t i = 0; i != 3; i++) {
+        state.AddMintsToStateAndBlockIndex(indexes[i], &blocks[i]);
+    }
+
+    CBlockIndex *index;
+    auto set1 = state.GetAnonymitySetAtBlock(1, indexes[1]->GetBlockHash(), true, index);
+    verifyMints(0, 4, *set1);
+    BOOST_CHECK_EQUAL(indexes[1], index);
+
+    // same set is shared between the callers
+    BOOST_CHECK(set1 == state.GetAnonymitySetAtBlock(1, indexes[1]->GetBlockHash(), true, index));
+
+    // unknown block resolves to the first block of the group
+    auto set2 = state.GetAnonymitySetAtBlock(1, uint256S("0x1"), true, index);
+    verifyMints(0, 2, *set2);
+    BOOST_CHECK_EQUAL(indexes[0], index);
+
+    // 8 coins, 1(6), 2(4)
+    state.AddMintsToStateAndBlockIndex(indexes[3], &blocks[3]);
+
+    // new group takes over the last coins of the previous one
+    auto set3 = state.GetAnonymitySetAtBlock(2, indexes[3]->GetBlockHash(), true, index);
+    verifyMints(4, 8, *set3);
+    BOOST_CHECK_EQUAL(indexes[3], index);
+
+    // earlier snapshot is not affected by new blocks
+    verifyMints(0, 4, *set1);
+
+    // block without mints inside of the group
+    auto set4 = state.GetAnonymitySetAtBlock(1, emptyIndexes[0]->GetBlockHash(), true, index);
+    verifyMints(0, 2, *set4);
+    BOOST_CHECK_EQUAL(emptyIndexes[0], index);
+
+    // roll back the group
+    state.RemoveBlock(indexes[3]);
+    BOOST_CHECK_EQUAL(1, state.GetLatestCoinID());
+    BOOST_CHECK(state.GetAnonymitySetAtBlock(2, indexes[3]->GetBlockHash(), true, index)->empty());
+
+    state.RemoveBlock(indexes[2]);
+    auto set5 = state.GetAnonymitySetAtBlock(1, indexes[2]->GetBlockHash(), true, index);
+    verifyMints(0, 2, *set5);
+    BOOST_CHECK_EQUAL(indexes[0], index);
+
+    auto set6 = state.GetAnonymitySetAtBlock(1, indexes[1]->GetBlockHash(), true, index);
+    verifyMints(0, 4, *set6);
+    BOOST_CHECK_EQUAL(indexes[1], index);
+}
+
+BOOST_AUTO_TEST_CASE(mint_outpoints_bounded)
+{
+    // keep the outpoints of 2 mints, up to twice as many before the older ones are dropped
+    CLelantusState state(ZC_LELANTUS_MAX_MINT_NUM, ZC_LELANTUS_SET_START_SIZE, 2);
+    state.Reset();
+
+    CMutableTransaction tx;
+    std::vector<GroupElement> coins(6);
+    for (auto &coin : coins) {
+        coin.randomize();
+
+        CScript script(OP_LELANTUSJMINT);
+        auto vch = coin.getvch();
+        script.insert(script.end(), vch.begin(), vch.end());
+        std::vector<unsigned char> encrypted(16, 0xff);
+        script.insert(script.end(), encrypted.begin(), encrypted.end());
+        tx.vout.push_back(CTxOut(0, script));
+    }
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(tx));
+    uint256 txHash = block.vtx[0]->GetHash();
+
+    state.AddMintOutPoints(block);
+
+    // the oldest outpoints are dropped, they are found by reading the block again
+    COutPoint outPoint;
+    for (size_t i = 0; i < 3; i++) {
+        BOOST_CHECK(!state.GetMintOutPoint(coins[i], outPoint));
+        BOOST_CHECK(GetOutPointFromBlock(outPoint, coins[i], block));
+        BOOST_CHECK(COutPoint(txHash, i) == outPoint);
+    }
+
+    for (size_t i = 3; i < coins.size(); i++) {
+        BOOST_CHECK(state.GetMintOutPoint(coins[i], outPoint));
+        BOOST_CHECK(COutPoint(txHash, i) == outPoint);
+    }
+}
+
 // Surge condition testing
 #define Undetected BOOST_CHECK(!state.IsSurgeConditionDetected())
 #define Detected BOOST_CHECK(state.IsSurgeConditionDetected())
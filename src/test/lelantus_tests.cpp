@@ -288,12 +288,21 @@ BOOST_AUTO_TEST_CASE(get_outpoint)
     block.lelantusTxInfo = std::make_shared<lelantus::CLelantusTxInfo>();
     block.lelantusTxInfo->mints.emplace_back(std::make_pair(mint.GetPubcoinValue(), std::make_pair(mint.GetAmount(), uint256())));
 
+    block.lelantusTxInfo->mintOutPoints[mint.GetPubcoinValue()] = COutPoint(tx.GetHash(), mintIdx);
+
     lelantusState->AddMintsToStateAndBlockIndex(blockIdx, &block);
     lelantusState->AddBlock(blockIdx);
 
     // verify
     COutPoint expectedOut(tx.GetHash(), mintIdx);
 
+    // recorded on connect
+    COutPoint recordedOut;
+    BOOST_CHECK(lelantusState->GetMintOutPoint(mint.GetPubcoinValue(), recordedOut));
+    BOOST_CHECK(expectedOut == recordedOut);
+
+    BOOST_CHECK(!lelantusState->GetMintOutPoint(nonCommitted.GetPubcoinValue(), recordedOut));
+
     // GetOutPointFromBlock
     COutPoint out;
     BOOST_CHECK(GetOutPointFromBlock(out, mint.GetPubcoinValue(), block));
@@ -322,6 +331,22 @@ BOOST_AUTO_TEST_CASE(get_outpoint)
     BOOST_CHECK(expectedOut == out);
 
     BOOST_CHECK(!GetOutPoint(out, nonCommitted.GetPubCoinHash()));
+
+    // by mint tags, read from the block once nothing is recorded
+    lelantusState->Reset();
+    lelantusState->AddMintsToStateAndBlockIndex(blockIdx, &block);
+    BOOST_CHECK(lelantusState->GetMintOutPoint(mint.GetPubcoinValue(), recordedOut));
+
+    block.lelantusTxInfo->mintOutPoints.clear();
+    lelantusState->Reset();
+    lelantusState->AddMintsToStateAndBlockIndex(blockIdx, &block);
+    BOOST_CHECK(!lelantusState->GetMintOutPoint(mint.GetPubcoinValue(), recordedOut));
+
+    auto outPoints = GetOutPointsFromMintTags({uint256(), uint256S("1")});
+    BOOST_CHECK_EQUAL(outPoints.size(), 1);
+    BOOST_CHECK(expectedOut == outPoints[uint256()].outPoint);
+    BOOST_CHECK_EQUAL(outPoints[uint256()].nHeight, blockIdx->nHeight);
+    BOOST_CHECK(lelantusState->GetMintOutPoint(mint.GetPubcoinValue(), recordedOut));
 }
 
 BOOST_AUTO_TEST_CASE(build_lelantus_state)
@@ -1,4 +1,5 @@
 #include "../secp256k1/include/MultiExponent.h"
+#include "../liblelantus/threadpool.h"
 
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
@@ -30,3 +31,110 @@ BOOST_AUTO_TEST_CASE(multiexponentation_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(fixed_base_multiexponentation_test)
+{
+    std::vector<int> sizes = {1, 4, 15, 16, 20, 65, 136, 2048};
+
+    for (unsigned int j = 0; j < sizes.size(); ++j) {
+        int size = sizes[j];
+        std::vector<secp_primitives::GroupElement> gens;
+        std::vector<secp_primitives::Scalar> scalars;
+
+        gens.resize(size);
+        scalars.resize(size);
+        for (int i = 0; i < size; ++i) {
+            gens[i].randomize();
+            scalars[i].randomize();
+        }
+
+        // zero, small and largest powers
+        scalars[0] = secp_primitives::Scalar(uint64_t(0));
+        if (size > 2) {
+            scalars[1] = secp_primitives::Scalar(uint64_t(255));
+            scalars[2] = secp_primitives::Scalar(uint64_t(0)) - secp_primitives::Scalar(uint64_t(1));
+        }
+
+        secp_primitives::FixedBaseMultiExponent table(gens);
+        BOOST_CHECK_EQUAL(table.size(), std::size_t(size));
+
+        secp_primitives::MultiExponent multiexponent(gens, scalars);
+        BOOST_CHECK_EQUAL(multiexponent.get_multiple(), table.get_multiple(scalars));
+
+        // only a prefix of the bases is used when there are fewer powers
+        std::vector<secp_primitives::Scalar> prefix(scalars.begin(), scalars.begin() + (size + 1) / 2);
+        secp_primitives::GroupElement r;
+        for (std::size_t i = 0; i < prefix.size(); ++i)
+            r += gens[i] * prefix[i];
+        BOOST_CHECK_EQUAL(r, table.get_multiple(prefix));
+    }
+
+    std::vector<secp_primitives::GroupElement> gens(2);
+    gens[0].randomize();
+    gens[1].randomize();
+    secp_primitives::FixedBaseMultiExponent table(gens);
+    BOOST_CHECK(table.get_multiple(std::vector<secp_primitives::Scalar>(2, secp_primitives::Scalar(uint64_t(0)))).isInfinity());
+    BOOST_CHECK_THROW(table.get_multiple(std::vector<secp_primitives::Scalar>(3)), std::invalid_argument);
+
+    gens.emplace_back();
+    BOOST_CHECK_THROW(secp_primitives::FixedBaseMultiExponent infinityTable(gens), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(multiexponentation_span_test)
+{
+    int size = 3000;
+    std::vector<secp_primitives::GroupElement> gens(size);
+    std::vector<secp_primitives::Scalar> scalars(size);
+    for (int i = 0; i < size; ++i) {
+        gens[i].randomize();
+        scalars[i].randomize();
+    }
+
+    // Subranges of different sizes, so the reused scratch space both grows and shrinks
+    std::vector<std::pair<int, int>> ranges = {{0, 3000}, {10, 20}, {100, 2000}, {0, 0}, {2999, 1}, {0, 3000}};
+    auto check = [&](bool& ok) {
+        ok = true;
+        for (const auto& range : ranges) {
+            secp_primitives::GroupElement r;
+            for (int i = range.first; i < range.first + range.second; ++i)
+                r += gens[i] * scalars[i];
+
+            secp_primitives::MultiExponent multiexponent(gens.data() + range.first, scalars.data() + range.first, range.second);
+            ok = ok && r == multiexponent.get_multiple();
+        }
+    };
+
+    bool ok;
+    check(ok);
+    BOOST_CHECK(ok);
+
+    // Every thread uses its own scratch space
+    bool threadsOk[4];
+    boost::thread_group threads;
+    for (int i = 0; i < 4; ++i)
+        threads.create_thread(boost::bind<void>(check, boost::ref(threadsOk[i])));
+    threads.join_all();
+    for (int i = 0; i < 4; ++i)
+        BOOST_CHECK(threadsOk[i]);
+}
+
+BOOST_AUTO_TEST_CASE(multiexponentation_parallel_test)
+{
+    std::vector<int> sizes = {1, 100, 4095, 4096, 10000, 20000};
+    std::vector<std::size_t> threads = {0, 1, 2, 3, 8, 64};
+    // the chunks are only split up on the pool
+    ParallelOpThreadPool::GetInstance();
+
+    for (int size : sizes) {
+        std::vector<secp_primitives::GroupElement> gens(size);
+        std::vector<secp_primitives::Scalar> scalars(size);
+        for (int i = 0; i < size; ++i) {
+            gens[i].randomize();
+            scalars[i].randomize();
+        }
+
+        secp_primitives::MultiExponent multiexponent(gens, scalars);
+        secp_primitives::GroupElement serial = multiexponent.get_multiple();
+        for (std::size_t n_threads : threads)
+            BOOST_CHECK_EQUAL(serial, multiexponent.get_multiple(n_threads));
+    }
+}
@@ -0,0 +1,30 @@
+#include "../proof_cache.h"
+#include "../arith_uint256.h"
+#include "../random.h"
+
+#include "test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(proof_cache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(hits_and_misses)
+{
+    ProofCacheStats before = GetProofCacheStats();
+    BOOST_CHECK(before.nMaxEntries > 0);
+
+    uint256 key = ArithToUint256(arith_uint256(GetRand(std::numeric_limits<uint64_t>::max())) + 1);
+    BOOST_CHECK(!IsProofCached(key));
+
+    AddProofToCache(key);
+    BOOST_CHECK(IsProofCached(key));
+    BOOST_CHECK(IsProofCached(key));
+    BOOST_CHECK(!IsProofCached(ArithToUint256(UintToArith256(key) + 1)));
+
+    ProofCacheStats after = GetProofCacheStats();
+    BOOST_CHECK_EQUAL(after.nHits - before.nHits, 2u);
+    BOOST_CHECK_EQUAL(after.nMisses - before.nMisses, 2u);
+    BOOST_CHECK_EQUAL(after.nInserts - before.nInserts, 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
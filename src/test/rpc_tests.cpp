@@ -7,6 +7,9 @@
 
 #include "base58.h"
 #include "netbase.h"
+#include "spentindex.h"
+#include "txdb.h"
+#include "validation.h"
 
 #include "test/test_bitcoin.h"
 
@@ -343,4 +346,151 @@ BOOST_AUTO_TEST_CASE(rpc_convert_values_generatetoaddress)
     BOOST_CHECK_EQUAL(result[2].get_int(), 9);
 }
 
+namespace {
+
+uint160 IndexHash(unsigned char c)
+{
+    return uint160(std::vector<unsigned char>(20, c));
+}
+
+std::string IndexAddress(unsigned char c)
+{
+    return CBitcoinAddress(CKeyID(IndexHash(c))).ToString();
+}
+
+std::vector<std::string> GetTxids(const UniValue& result)
+{
+    std::vector<std::string> txids;
+    for (const UniValue& txid : find_value(result, "txids").getValues())
+        txids.push_back(txid.get_str());
+    return txids;
+}
+
+// Fills the address index with the entries of two addresses, A has three transactions and the one at height 2
+// both spends and pays to it, B has two
+struct AddressIndexSetup {
+    std::string addressA = IndexAddress(0xaa);
+    std::string addressB = IndexAddress(0xbb);
+    std::vector<std::pair<CAddressIndexKey, CAmount> > index;
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+
+    AddressIndexSetup() {
+        uint160 hashA = IndexHash(0xaa);
+        uint160 hashB = IndexHash(0xbb);
+        CScript script;
+
+        index.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hashA, 1, 1, uint256S("a1"), 0, false), 10));
+        index.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hashA, 2, 1, uint256S("a2"), 0, true), -10));
+        index.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hashA, 2, 1, uint256S("a2"), 1, false), 5));
+        index.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hashA, 3, 1, uint256S("a3"), 0, false), 7));
+        index.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hashB, 1, 2, uint256S("b1"), 0, false), 3));
+        index.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hashB, 4, 1, uint256S("b4"), 0, false), 4));
+        BOOST_CHECK(pblocktree->WriteAddressIndex(index));
+
+        unspent.push_back(std::make_pair(CAddressUnspentKey(AddressType::payToPubKeyHash, hashA, uint256S("01"), 0), CAddressUnspentValue(1, script, 1)));
+        unspent.push_back(std::make_pair(CAddressUnspentKey(AddressType::payToPubKeyHash, hashA, uint256S("02"), 0), CAddressUnspentValue(2, script, 2)));
+        unspent.push_back(std::make_pair(CAddressUnspentKey(AddressType::payToPubKeyHash, hashA, uint256S("02"), 1), CAddressUnspentValue(3, script, 2)));
+        unspent.push_back(std::make_pair(CAddressUnspentKey(AddressType::payToPubKeyHash, hashB, uint256S("03"), 0), CAddressUnspentValue(4, script, 3)));
+        BOOST_CHECK(pblocktree->UpdateAddressUnspentIndex(unspent));
+
+        fAddressIndex = true;
+    }
+
+    ~AddressIndexSetup() {
+        fAddressIndex = false;
+    }
+
+    std::string Query(const std::string& addresses, int limit, const std::string& cursor = "") {
+        std::string query = "{\"addresses\":[" + addresses + "],\"limit\":" + std::to_string(limit);
+        if (!cursor.empty())
+            query += ",\"cursor\":\"" + cursor + "\"";
+        return query + "}";
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(rpc_addresstxids_paging)
+{
+    AddressIndexSetup setup;
+    std::string both = "\"" + setup.addressA + "\",\"" + setup.addressB + "\"";
+    UniValue r;
+
+    // without a limit the whole history comes in one array
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids {\"addresses\":[" + both + "]}"));
+    BOOST_CHECK(r.isArray());
+    BOOST_CHECK_EQUAL(r.size(), 5);
+
+    // the pages go on from one address to the next, the two entries of a2 never get split
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids " + setup.Query(both, 2)));
+    BOOST_CHECK(GetTxids(r) == std::vector<std::string>({uint256S("a1").GetHex(), uint256S("a2").GetHex()}));
+    std::string cursor = find_value(r, "cursor").get_str();
+
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids " + setup.Query(both, 2, cursor)));
+    BOOST_CHECK(GetTxids(r) == std::vector<std::string>({uint256S("a3").GetHex(), uint256S("b1").GetHex()}));
+    std::string cursorB = find_value(r, "cursor").get_str();
+
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids " + setup.Query(both, 2, cursorB)));
+    BOOST_CHECK(GetTxids(r) == std::vector<std::string>({uint256S("b4").GetHex()}));
+    BOOST_CHECK(find_value(r, "cursor").isNull());
+
+    // a page ending right on the last entry has no cursor
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids " + setup.Query(both, 5)));
+    BOOST_CHECK_EQUAL(GetTxids(r).size(), 5);
+    BOOST_CHECK(find_value(r, "cursor").isNull());
+
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids " + setup.Query(both, 4)));
+    BOOST_CHECK_EQUAL(GetTxids(r).size(), 4);
+    BOOST_CHECK(find_value(r, "cursor").isStr());
+
+    // cursors which can't be read or don't belong to the addresses asked for
+    BOOST_CHECK_THROW(CallRPC("getaddresstxids " + setup.Query(both, 2, "zz")), std::runtime_error);
+    BOOST_CHECK_THROW(CallRPC("getaddresstxids " + setup.Query(both, 2, "00")), std::runtime_error);
+    BOOST_CHECK_THROW(CallRPC("getaddresstxids " + setup.Query("\"" + setup.addressA + "\"", 2, cursorB)), std::runtime_error);
+    BOOST_CHECK_THROW(CallRPC("getaddresstxids " + setup.Query("\"" + setup.addressB + "\"", 2, cursor)), std::runtime_error);
+    BOOST_CHECK_THROW(CallRPC("getaddresstxids " + setup.Query(both, 0)), std::runtime_error);
+
+    // the entry a cursor points to may have been disconnected meanwhile, the next page starts at the entry after it
+    BOOST_CHECK(pblocktree->EraseAddressIndex(std::vector<std::pair<CAddressIndexKey, CAmount> >(1, setup.index[3])));
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddresstxids " + setup.Query(both, 2, cursor)));
+    BOOST_CHECK(GetTxids(r) == std::vector<std::string>({uint256S("b1").GetHex(), uint256S("b4").GetHex()}));
+    BOOST_CHECK(find_value(r, "cursor").isNull());
+}
+
+BOOST_AUTO_TEST_CASE(rpc_addressutxos_paging)
+{
+    AddressIndexSetup setup;
+    std::string both = "\"" + setup.addressA + "\",\"" + setup.addressB + "\"";
+    UniValue r;
+
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddressutxos " + setup.Query(both, 2)));
+    UniValue utxos = find_value(r, "utxos");
+    BOOST_CHECK_EQUAL(utxos.size(), 2);
+    BOOST_CHECK_EQUAL(find_value(utxos[0], "satoshis").get_int64(), 1);
+    BOOST_CHECK_EQUAL(find_value(utxos[1], "satoshis").get_int64(), 2);
+    BOOST_CHECK_EQUAL(find_value(utxos[1], "address").get_str(), setup.addressA);
+    std::string cursor = find_value(r, "cursor").get_str();
+
+    // the second page finishes A and goes on to B
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddressutxos " + setup.Query(both, 2, cursor)));
+    utxos = find_value(r, "utxos");
+    BOOST_CHECK_EQUAL(utxos.size(), 2);
+    BOOST_CHECK_EQUAL(find_value(utxos[0], "satoshis").get_int64(), 3);
+    BOOST_CHECK_EQUAL(find_value(utxos[0], "outputIndex").get_int(), 1);
+    BOOST_CHECK_EQUAL(find_value(utxos[1], "satoshis").get_int64(), 4);
+    BOOST_CHECK_EQUAL(find_value(utxos[1], "address").get_str(), setup.addressB);
+    BOOST_CHECK(find_value(r, "cursor").isNull());
+
+    BOOST_CHECK_THROW(CallRPC("getaddressutxos " + setup.Query(both, 2, cursor.substr(2))), std::runtime_error);
+    BOOST_CHECK_THROW(CallRPC("getaddressutxos " + setup.Query("\"" + setup.addressB + "\"", 2, cursor)), std::runtime_error);
+
+    // the output the cursor points to was spent meanwhile
+    BOOST_CHECK(pblocktree->UpdateAddressUnspentIndex(std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >(
+            1, std::make_pair(setup.unspent[2].first, CAddressUnspentValue()))));
+    BOOST_CHECK_NO_THROW(r = CallRPC("getaddressutxos " + setup.Query(both, 2, cursor)));
+    utxos = find_value(r, "utxos");
+    BOOST_CHECK_EQUAL(utxos.size(), 1);
+    BOOST_CHECK_EQUAL(find_value(utxos[0], "address").get_str(), setup.addressB);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -181,7 +181,9 @@ BOOST_AUTO_TEST_CASE(sigma_mintspend_test)
 
         //Temporary disable usedCoinSerials check to force double spend in mempool
         auto tempSerials = sigmaState->containers.usedCoinSerials;
+        auto tempSerialHashes = sigmaState->containers.hashToSerial;
         sigmaState->containers.usedCoinSerials.clear();
+        sigmaState->containers.hashToSerial.clear();
 
         {
             //Set mints unused, and try to spend again
@@ -193,14 +195,18 @@ BOOST_AUTO_TEST_CASE(sigma_mintspend_test)
         }
 
         sigmaState->containers.usedCoinSerials = tempSerials;
+        sigmaState->containers.hashToSerial = tempSerialHashes;
 
         BOOST_CHECK_EXCEPTION(CreateBlock(scriptPubKey), std::runtime_error, no_check);
         BOOST_CHECK_MESSAGE(mempool.size() == 1, "Mempool not set");
         tempSerials = sigmaState->containers.usedCoinSerials;
+        tempSerialHashes = sigmaState->containers.hashToSerial;
         sigmaState->containers.usedCoinSerials.clear();
+        sigmaState->containers.hashToSerial.clear();
         CreateBlock(scriptPubKey);
 
         sigmaState->containers.usedCoinSerials = tempSerials;
+        sigmaState->containers.hashToSerial = tempSerialHashes;
 
         mempool.clear();
         previousHeight = chainActive.Height();
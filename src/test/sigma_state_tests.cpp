@@ -638,8 +638,8 @@ BOOST_AUTO_TEST_CASE(sigma_addblock_minted_spend)
     std::pair<sigma::CoinDenomination, int> denomination1Group1(
         sigma::CoinDenomination::SIGMA_DENOM_1,1);
 
-	index.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin1);
-	index.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin2);
+	index.ModifyCoinData().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin1);
+	index.ModifyCoinData().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin2);
 
 	sigmaState->AddBlock(&index);
 	BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 2,
@@ -662,8 +662,8 @@ BOOST_AUTO_TEST_CASE(sigma_addblock_minted_spend)
 	auto spendSerial = coinSpend.getCoinSerialNumber();
 
     CBlockIndex index2 = CreateBlockIndex(2);
-	index2.sigmaSpentSerials.clear();
-	index2.sigmaSpentSerials.insert(std::make_pair(spendSerial, sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
+	index2.ModifyCoinData().sigmaSpentSerials.clear();
+	index2.ModifyCoinData().sigmaSpentSerials.insert(std::make_pair(spendSerial, sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
 	sigmaState->AddBlock(&index2);
 	BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 2,
 	  "Unexpected mintedPubCoins size, add new block without additional minted.");
@@ -677,7 +677,7 @@ BOOST_AUTO_TEST_CASE(sigma_addblock_minted_spend)
     pubcoin3 = privcoin3.getPublicCoin();
     CBlockIndex index3 = CreateBlockIndex(3);
 
-    index3.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin3);
+    index3.ModifyCoinData().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin3);
     sigmaState->AddBlock(&index3);
     BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 3,
 	  "Unexpected mintedPubCoins size, add new block with one more minted.");
@@ -700,7 +700,7 @@ BOOST_AUTO_TEST_CASE(sigma_removeblock_remove)
 
     auto index1 = CreateBlockIndex(1);
     std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
-    index1.sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    index1.ModifyCoinData().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
 
     // add index 2 with 10 minted and 1 spend
     auto coins2 = generateCoins(params,10, sigma::CoinDenomination::SIGMA_DENOM_1);
@@ -708,15 +708,15 @@ BOOST_AUTO_TEST_CASE(sigma_removeblock_remove)
 
     auto index2 = CreateBlockIndex(2);
     std::pair<sigma::CoinDenomination, int> denomination1Group2(sigma::CoinDenomination::SIGMA_DENOM_1, 2);
-    index2.sigmaMintedPubCoins[denomination1Group2] = pubCoins2;
+    index2.ModifyCoinData().sigmaMintedPubCoins[denomination1Group2] = pubCoins2;
 
     // Doesn't really matter what metadata we give here, it must pass.
     sigma::SpendMetaData metaData(0, uint256S("120"), uint256S("120"));
 
     sigma::CoinSpend coinSpend(params, coins[0], pubCoins, metaData, true);
 
-    index2.sigmaSpentSerials.clear();
-    index2.sigmaSpentSerials.insert(std::make_pair(coinSpend.getCoinSerialNumber(), sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
+    index2.ModifyCoinData().sigmaSpentSerials.clear();
+    index2.ModifyCoinData().sigmaSpentSerials.insert(std::make_pair(coinSpend.getCoinSerialNumber(), sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
 
     sigmaState->AddBlock(&index1);
     sigmaState->AddBlock(&index2);
@@ -933,7 +933,7 @@ BOOST_AUTO_TEST_CASE(sigma_build_state)
     std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
     std::pair<sigma::CoinDenomination, int> denomination10Group1(sigma::CoinDenomination::SIGMA_DENOM_10, 1);
 
-    index1.sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    index1.ModifyCoinData().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
 
     chainActive.SetTip(&index1);
 
@@ -948,10 +948,10 @@ BOOST_AUTO_TEST_CASE(sigma_build_state)
     secp_primitives::Scalar serial;
     serial.randomize();
 
-    index2.sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
+    index2.ModifyCoinData().sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
 
-    index2.sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
-    index2.sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
+    index2.ModifyCoinData().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+    index2.ModifyCoinData().sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
 
     chainActive.SetTip(&index2);
 
@@ -1071,7 +1071,7 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     auto coins3 = generateCoins(params, 5, sigma::CoinDenomination::SIGMA_DENOM_10);
     auto pubCoins3 = getPubcoins(coins3);
 
-    indexes[nextIndex].sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    indexes[nextIndex].ModifyCoinData().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
     chainActive.SetTip(&indexes[nextIndex]);
 
     nextIndex++;
@@ -1081,9 +1081,9 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     secp_primitives::Scalar serial;
     serial.randomize();
 
-    indexes[nextIndex].sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
-    indexes[nextIndex].sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
-    indexes[nextIndex].sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
+    indexes[nextIndex].ModifyCoinData().sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
+    indexes[nextIndex].ModifyCoinData().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+    indexes[nextIndex].ModifyCoinData().sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
 
     chainActive.SetTip(&indexes[nextIndex]);
 
@@ -0,0 +1,250 @@
+#include "../sigma_sync_cache.h"
+#include "../sigma.h"
+#include "../utilstrencodings.h"
+#include "../validation.h"
+
+#include "test/fixtures.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+
+namespace {
+
+const sigma::CoinDenomination testDenomination = sigma::CoinDenomination::SIGMA_DENOM_1;
+
+// Puts mints of new coins into the block of the active chain at the height, the way ConnectBlock does
+std::vector<sigma::PublicCoin> AddMints(int nHeight, size_t count)
+{
+    auto params = sigma::Params::get_default();
+    std::vector<sigma::PublicCoin> mints;
+    for (size_t i = 0; i < count; i++)
+        mints.push_back(sigma::PrivateCoin(params, testDenomination).getPublicCoin());
+
+    CBlock block;
+    block.sigmaTxInfo = std::make_shared<sigma::CSigmaTxInfo>();
+    block.sigmaTxInfo->mints = mints;
+
+    LOCK(cs_main);
+    sigma::CSigmaState::GetState()->AddMintsToStateAndBlockIndex(chainActive[nHeight], &block);
+    return mints;
+}
+
+std::vector<Scalar> AddSpends(int nHeight, size_t count)
+{
+    std::vector<Scalar> serials(count);
+    LOCK(cs_main);
+    for (Scalar& serial : serials) {
+        serial.randomize();
+        chainActive[nHeight]->ModifyCoinData().sigmaSpentSerials.insert(
+                std::make_pair(serial, sigma::CSpendCoinInfo::make(testDenomination, 1)));
+        sigma::CSigmaState::GetState()->AddSpend(serial, testDenomination, 1);
+    }
+    return serials;
+}
+
+// The coins in the order the sets have them, latest blocks first
+std::vector<unsigned char> SerializeCoins(const std::vector<std::vector<sigma::PublicCoin>>& blocks)
+{
+    std::vector<GroupElement> values;
+    for (auto block = blocks.rbegin(); block != blocks.rend(); ++block) {
+        for (const sigma::PublicCoin& coin : *block)
+            values.push_back(coin.getValue());
+    }
+    std::vector<unsigned char> serialized(values.size() * GroupElement::serialize_size);
+    GroupElement::serialize_all(values, serialized.data());
+    return serialized;
+}
+
+std::set<std::string> SerialsOf(const std::vector<unsigned char>& serialized)
+{
+    std::set<std::string> serials;
+    for (auto it = serialized.begin(); it != serialized.end(); it += Scalar::memoryRequired())
+        serials.insert(HexStr(it, it + Scalar::memoryRequired()));
+    return serials;
+}
+
+std::set<std::string> SerialsOf(const std::vector<Scalar>& values)
+{
+    std::vector<unsigned char> serialized(values.size() * Scalar::memoryRequired());
+    unsigned char* buffer = serialized.data();
+    for (const Scalar& serial : values)
+        buffer = serial.serialize(buffer);
+    return SerialsOf(serialized);
+}
+
+uint256 BlockHashAt(int nHeight)
+{
+    LOCK(cs_main);
+    return chainActive[nHeight]->GetBlockHash();
+}
+
+// for the duration of the test start the blacklist at the height
+class FakeSigmaBlacklist {
+    Consensus::Params &params;
+    Consensus::Params oldParams;
+public:
+    FakeSigmaBlacklist(int nStartHeight, const GroupElement& coin)
+            : params(const_cast<Consensus::Params &>(Params().GetConsensus())) {
+        oldParams = params;
+        params.nStartSigmaBlacklist = nStartHeight;
+        params.sigmaBlacklist.insert(coin);
+    }
+
+    ~FakeSigmaBlacklist() {
+        params = oldParams;
+    }
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(sigma_sync_cache_tests, ZerocoinTestingSetup200)
+
+BOOST_AUTO_TEST_CASE(anonymity_set_delta)
+{
+    sigma::CSyncCache& syncCache = sigma::CSyncCache::GetInstance();
+
+    auto mints150 = AddMints(150, 2);
+    auto mints160 = AddMints(160, 3);
+    auto mints170 = AddMints(170, 1);
+
+    // without a start block the whole set comes
+    sigma::CAnonymitySetDelta delta = syncCache.GetAnonymitySet(testDenomination, 1, uint256());
+    BOOST_CHECK(delta.fFull);
+    BOOST_CHECK(delta.blockHash == BlockHashAt(170));
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints150, mints160, mints170}));
+
+    // the coins of the blocks after the start block, wherever it is in between the blocks of the set
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(160));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints170}));
+
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(155));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints160, mints170}));
+
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(100));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints150, mints160, mints170}));
+
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(170));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins.empty());
+
+    // a block the node doesn't know
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, uint256S("1234"));
+    BOOST_CHECK(delta.fFull);
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints150, mints160, mints170}));
+
+    // the set grows, a client that synced to its previous last block gets the new coins only
+    auto mints180 = AddMints(180, 2);
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(170));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.blockHash == BlockHashAt(180));
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints180}));
+
+    // groups without coins
+    delta = syncCache.GetAnonymitySet(testDenomination, 2, uint256());
+    BOOST_CHECK(delta.blockHash.IsNull());
+    BOOST_CHECK(delta.serializedCoins.empty());
+}
+
+BOOST_AUTO_TEST_CASE(anonymity_set_start_reorged_away)
+{
+    sigma::CSyncCache& syncCache = sigma::CSyncCache::GetInstance();
+
+    auto mints150 = AddMints(150, 2);
+    auto mints160 = AddMints(160, 1);
+
+    uint256 startBlockHash = BlockHashAt(195);
+    sigma::CAnonymitySetDelta delta = syncCache.GetAnonymitySet(testDenomination, 1, startBlockHash);
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins.empty());
+
+    // the start block is still known but not on the active chain any more
+    BOOST_CHECK(DisconnectBlocks(10));
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, startBlockHash);
+    BOOST_CHECK(delta.fFull);
+    BOOST_CHECK(delta.blockHash == BlockHashAt(160));
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints150, mints160}));
+
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(155));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints160}));
+}
+
+BOOST_AUTO_TEST_CASE(anonymity_set_blacklist)
+{
+    sigma::CSyncCache& syncCache = sigma::CSyncCache::GetInstance();
+
+    auto mints150 = AddMints(150, 2);
+    auto mints160 = AddMints(160, 1);
+
+    sigma::CAnonymitySetDelta delta = syncCache.GetAnonymitySet(testDenomination, 1, uint256());
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints150, mints160}));
+
+    {
+        // the set taken before the blacklist started is replaced even though its last block is the same
+        FakeSigmaBlacklist blacklist(155, mints150[1].getValue());
+        std::vector<sigma::PublicCoin> allowed150(1, mints150[0]);
+
+        delta = syncCache.GetAnonymitySet(testDenomination, 1, uint256());
+        BOOST_CHECK(delta.fFull);
+        BOOST_CHECK(delta.blockHash == BlockHashAt(160));
+        BOOST_CHECK(delta.serializedCoins == SerializeCoins({allowed150, mints160}));
+
+        // a client that synced before the blacklist started may have the blacklisted coins, it gets the whole set
+        delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(152));
+        BOOST_CHECK(delta.fFull);
+        BOOST_CHECK(delta.serializedCoins == SerializeCoins({allowed150, mints160}));
+
+        delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(157));
+        BOOST_CHECK(!delta.fFull);
+        BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints160}));
+    }
+
+    delta = syncCache.GetAnonymitySet(testDenomination, 1, BlockHashAt(152));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedCoins == SerializeCoins({mints160}));
+}
+
+BOOST_AUTO_TEST_CASE(used_serials_delta)
+{
+    sigma::CSyncCache& syncCache = sigma::CSyncCache::GetInstance();
+
+    auto serials185 = AddSpends(185, 2);
+    auto serials190 = AddSpends(190, 1);
+    std::vector<Scalar> allSerials(serials185);
+    allSerials.insert(allSerials.end(), serials190.begin(), serials190.end());
+
+    sigma::CUsedSerialsDelta delta = syncCache.GetUsedSerials(uint256());
+    BOOST_CHECK(delta.fFull);
+    BOOST_CHECK(delta.blockHash == BlockHashAt(200));
+    BOOST_CHECK(SerialsOf(delta.serializedSerials) == SerialsOf(allSerials));
+
+    delta = syncCache.GetUsedSerials(BlockHashAt(187));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(SerialsOf(delta.serializedSerials) == SerialsOf(serials190));
+
+    delta = syncCache.GetUsedSerials(BlockHashAt(100));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(SerialsOf(delta.serializedSerials) == SerialsOf(allSerials));
+
+    delta = syncCache.GetUsedSerials(BlockHashAt(200));
+    BOOST_CHECK(!delta.fFull);
+    BOOST_CHECK(delta.serializedSerials.empty());
+
+    delta = syncCache.GetUsedSerials(uint256S("1234"));
+    BOOST_CHECK(delta.fFull);
+    BOOST_CHECK(SerialsOf(delta.serializedSerials) == SerialsOf(allSerials));
+
+    // the start block was disconnected, the serials are taken at the new tip
+    uint256 startBlockHash = BlockHashAt(199);
+    BOOST_CHECK(DisconnectBlocks(2));
+    delta = syncCache.GetUsedSerials(startBlockHash);
+    BOOST_CHECK(delta.fFull);
+    BOOST_CHECK(delta.blockHash == BlockHashAt(198));
+    BOOST_CHECK(SerialsOf(delta.serializedSerials) == SerialsOf(allSerials));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
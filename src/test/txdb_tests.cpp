@@ -73,7 +73,14 @@ BOOST_AUTO_TEST_CASE(dbindexhelper_coinbase)
             BOOST_CHECK(dbIndexHelper.getAddressUnspentIndex()[i].second.blockHeight == 7980);
             BOOST_CHECK(dbIndexHelper.getAddressUnspentIndex()[i].second.satoshis == amounts[i]*100000);
             BOOST_CHECK(dbIndexHelper.getAddressUnspentIndex()[i].second.script == tx.vout[i].scriptPubKey);
+
+            CAddressBalanceValue const & balance = dbIndexHelper.getAddressBalanceIndex().at(CAddressBalanceKey(type, key));
+            BOOST_CHECK(balance.balance == amounts[i]*100000);
+            BOOST_CHECK(balance.received == amounts[i]*100000);
+            BOOST_CHECK(balance.txCount == 1);
+            BOOST_CHECK(balance.unspentCount == 1);
         }
+        BOOST_CHECK(dbIndexHelper.getAddressBalanceIndex().size() == outNum);
     }
     {
         CDbIndexHelper dbIndexHelper(true, true);
@@ -101,6 +108,12 @@ BOOST_AUTO_TEST_CASE(dbindexhelper_coinbase)
             BOOST_CHECK(dbIndexHelper.getAddressUnspentIndex()[i].second.blockHeight == 0);
             BOOST_CHECK(dbIndexHelper.getAddressUnspentIndex()[i].second.satoshis == -1);
             BOOST_CHECK(dbIndexHelper.getAddressUnspentIndex()[i].second.script.empty());
+
+            CAddressBalanceValue const & balance = dbIndexHelper.getAddressBalanceIndex().at(CAddressBalanceKey(type, key));
+            BOOST_CHECK(balance.balance == -amounts[outNum-1-i]*100000);
+            BOOST_CHECK(balance.received == -amounts[outNum-1-i]*100000);
+            BOOST_CHECK(balance.txCount == -1);
+            BOOST_CHECK(balance.unspentCount == -1);
         }
     }
 }
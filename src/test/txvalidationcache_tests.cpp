@@ -84,4 +84,36 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_block_doublespend, TestChain100Setup)
     BOOST_CHECK_EQUAL(mempool.size(), 0);
 }
 */
+BOOST_FIXTURE_TEST_CASE(tx_pool_accept_checks, BasicTestingSetup)
+{
+    CMutableTransaction mtx;
+    mtx.vout.resize(1);
+    mtx.vout[0].nValue = CENT;
+    CTransaction tx(mtx);
+    mtx.vout[0].nValue = 2 * CENT;
+    CTransaction otherTx(mtx);
+
+    uint256 tip = GetRandHash();
+    uint256 otherTip = GetRandHash();
+
+    CTxPoolAcceptChecks checks(tx);
+    BOOST_CHECK(!checks.HasCheckedTx(tx, tip, false));
+
+    checks.SetCheckedTx(tip, false);
+    checks.SetCheckedInputs();
+    BOOST_CHECK(checks.HasCheckedTx(tx, tip, false));
+    BOOST_CHECK(checks.HasCheckedInputs(tx, tip, false));
+
+    // the checks are only reused for the same transaction, tip and wallet check setting
+    BOOST_CHECK(!checks.HasCheckedTx(otherTx, tip, false));
+    BOOST_CHECK(!checks.HasCheckedTx(tx, otherTip, false));
+    BOOST_CHECK(!checks.HasCheckedInputs(tx, tip, true));
+
+    // checking the transaction again at another tip leaves the inputs to be checked again too
+    checks.SetCheckedTx(otherTip, false);
+    BOOST_CHECK(checks.HasCheckedTx(tx, otherTip, false));
+    BOOST_CHECK(!checks.HasCheckedInputs(tx, otherTip, false));
+    BOOST_CHECK(!checks.HasCheckedTx(tx, tip, false));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -32,6 +32,7 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 static const char DB_TOTAL_SUPPLY = 'S';
+static const char DB_ADDRESSBALANCEINDEX = 'A';
 
 namespace {
 
@@ -309,6 +310,158 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, AddressType type,
     return true;
 }
 
+bool CBlockTreeDB::ReadAddressIndex(const CAddressIndexKey &start, int end,
+                                    const std::function<bool(const CAddressIndexKey&, CAmount)> &handle) {
+
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, start));
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX || key.second.hashBytes != start.hashBytes || key.second.type != start.type)
+            break;
+        if (end > 0 && key.second.blockHeight > end)
+            break;
+
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address index value");
+        if (!handle(key.second, nValue))
+            break;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool CBlockTreeDB::ReadAddressUnspentIndex(const CAddressUnspentKey &start,
+                                           const std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> &handle) {
+
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, start));
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressUnspentKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUNSPENTINDEX || key.second.hashBytes != start.hashBytes || key.second.type != start.type)
+            break;
+
+        CAddressUnspentValue nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address unspent value");
+        if (!handle(key.second, nValue))
+            break;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool CBlockTreeDB::UpdateAddressBalanceIndex(const std::map<CAddressBalanceKey, CAddressBalanceValue> &deltas) {
+    CDBBatch batch(*this);
+    for (std::map<CAddressBalanceKey, CAddressBalanceValue>::const_iterator it=deltas.begin(); it!=deltas.end(); it++) {
+        CAddressBalanceValue value;
+        if (Exists(std::make_pair(DB_ADDRESSBALANCEINDEX, it->first)) && !Read(std::make_pair(DB_ADDRESSBALANCEINDEX, it->first), value))
+            return error("failed to get address balance value");
+
+        value += it->second;
+        if (value.IsNull()) {
+            batch.Erase(std::make_pair(DB_ADDRESSBALANCEINDEX, it->first));
+        } else {
+            batch.Write(std::make_pair(DB_ADDRESSBALANCEINDEX, it->first), value);
+        }
+    }
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadAddressBalanceIndex(uint160 addressHash, AddressType type, CAddressBalanceValue &value) {
+    value.SetNull();
+    CAddressBalanceKey key(type, addressHash);
+    if (!Exists(std::make_pair(DB_ADDRESSBALANCEINDEX, key)))
+        return true;
+    return Read(std::make_pair(DB_ADDRESSBALANCEINDEX, key), value);
+}
+
+bool CBlockTreeDB::BuildAddressBalanceIndex() {
+    // the entries of an address are next to each other in both indices, so the totals are written out address by
+    // address as the iterators pass them
+    static const size_t nBatchSize = 10000;
+
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    // drop whatever is left of an interrupted build
+    CDBBatch batch(*this);
+    pcursor->Seek(DB_ADDRESSBALANCEINDEX);
+    while (pcursor->Valid()) {
+        std::pair<char,CAddressBalanceKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSBALANCEINDEX)
+            break;
+        batch.Erase(key);
+        pcursor->Next();
+    }
+    if (!WriteBatch(batch))
+        return false;
+
+    std::map<CAddressBalanceKey, CAddressBalanceValue> balances;
+    CAddressBalanceKey current;
+    uint256 lastTxHash;
+
+    pcursor->Seek(DB_ADDRESSINDEX);
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX)
+            break;
+
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address index value");
+
+        CAddressBalanceKey balanceKey(key.second.type, key.second.hashBytes);
+        if (balanceKey < current || current < balanceKey) {
+            if (balances.size() >= nBatchSize) {
+                if (!UpdateAddressBalanceIndex(balances))
+                    return false;
+                balances.clear();
+            }
+            current = balanceKey;
+            lastTxHash.SetNull();
+        }
+
+        CAddressBalanceValue& value = balances[balanceKey];
+        value.balance += nValue;
+        if (nValue > 0)
+            value.received += nValue;
+        // the entries of a transaction are adjacent as the transaction hash follows the height in the key
+        if (key.second.txhash != lastTxHash) {
+            value.txCount++;
+            lastTxHash = key.second.txhash;
+        }
+        pcursor->Next();
+    }
+
+    pcursor->Seek(DB_ADDRESSUNSPENTINDEX);
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressUnspentKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUNSPENTINDEX)
+            break;
+
+        CAddressBalanceKey balanceKey(key.second.type, key.second.hashBytes);
+        if (balances.size() >= nBatchSize && !balances.count(balanceKey)) {
+            if (!UpdateAddressBalanceIndex(balances))
+                return false;
+            balances.clear();
+        }
+        balances[balanceKey].unspentCount++;
+        pcursor->Next();
+    }
+
+    return UpdateAddressBalanceIndex(balances);
+}
 
 bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
     CDBBatch batch(*this);
@@ -361,6 +514,8 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
         std::pair<char, uint256> key;
         if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
             CDiskBlockIndex diskindex;
+            // the mints and spends are read on demand, only their numbers are kept in memory
+            diskindex.fCountCoinsOnly = true;
             if (pcursor->GetValue(diskindex)) {
                 // Construct block index object
                 CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
@@ -391,11 +546,7 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
                     pindexNew->reserved[1] = diskindex.reserved[1];
                 }
 
-                pindexNew->sigmaMintedPubCoins   = diskindex.sigmaMintedPubCoins;
-                pindexNew->sigmaSpentSerials     = diskindex.sigmaSpentSerials;
-
-                pindexNew->lelantusMintedPubCoins   = diskindex.lelantusMintedPubCoins;
-                pindexNew->lelantusSpentSerials     = diskindex.lelantusSpentSerials;
+                pindexNew->SetCoinCounts(diskindex.diskCoinCounts);
                 pindexNew->anonymitySetHash         = diskindex.anonymitySetHash;
 
                 pindexNew->activeDisablingSporks = diskindex.activeDisablingSporks;
@@ -415,6 +566,16 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
     return true;
 }
 
+bool CBlockTreeDB::ReadBlockCoinData(const uint256& blockHash, CBlockCoinData& coinData)
+{
+    CDiskBlockIndex diskindex;
+    if (!Read(std::make_pair(DB_BLOCK_INDEX, blockHash), diskindex))
+        return false;
+
+    coinData = std::move(diskindex.diskCoinData);
+    return true;
+}
+
 int CBlockTreeDB::GetBlockIndexVersion()
 {
     // Get random block index entry, check its version. The only reason for these functions to exist
@@ -473,6 +634,7 @@ CDbIndexHelper::CDbIndexHelper(bool addressIndex_, bool spentIndex_)
     if (addressIndex_) {
         addressIndex.reset(AddressIndex());
         addressUnspentIndex.reset(AddressUnspentIndex());
+        addressBalanceIndex.reset(AddressBalanceIndex());
     }
 
     if (spentIndex_)
@@ -609,6 +771,13 @@ void handleOutput(const CTxOut &out, size_t outNo, uint256 const & txHash, int h
 
 void CDbIndexHelper::ConnectTransaction(CTransaction const & tx, int height, int txNumber, CCoinsViewCache const & view)
 {
+    size_t pAddressBegin{0}, pUnspentBegin{0};
+
+    if(addressIndex){
+        pAddressBegin = addressIndex->size();
+        pUnspentBegin = addressUnspentIndex->size();
+    }
+
     size_t no = 0;
     if(!tx.IsCoinBase() && !tx.IsZerocoinSpend() && !tx.IsSigmaSpend() && !tx.IsZerocoinRemint() && !tx.IsLelantusJoinSplit()) {
         for (CTxIn const & input : tx.vin) {
@@ -636,6 +805,8 @@ void CDbIndexHelper::ConnectTransaction(CTransaction const & tx, int height, int
     for (CTxOut const & out : tx.vout) {
         handleOutput(out, no++, tx.GetHash(), height, txNumber, view, txIsCoinBase, addressIndex, addressUnspentIndex, spentIndex);
     }
+
+    updateAddressBalances(tx.GetHash(), pAddressBegin, pUnspentBegin, true);
 }
 
 
@@ -670,6 +841,8 @@ void CDbIndexHelper::DisconnectTransactionInputs(CTransaction const & tx, int he
             handleInput(input, no++, tx.GetHash(), height, txNumber, view, addressIndex, addressUnspentIndex, spentIndex);
         }
 
+    updateAddressBalances(tx.GetHash(), pAddressBegin, pUnspentBegin, false);
+
     if(addressIndex){
         std::reverse(addressIndex->begin() + pAddressBegin, addressIndex->end());
         std::reverse(addressUnspentIndex->begin() + pUnspentBegin, addressUnspentIndex->end());
@@ -684,6 +857,13 @@ void CDbIndexHelper::DisconnectTransactionInputs(CTransaction const & tx, int he
 
 void CDbIndexHelper::DisconnectTransactionOutputs(CTransaction const & tx, int height, int txNumber, CCoinsViewCache const & view)
 {
+    size_t pAddressBegin{0}, pUnspentBegin{0};
+
+    if(addressIndex){
+        pAddressBegin = addressIndex->size();
+        pUnspentBegin = addressUnspentIndex->size();
+    }
+
     if(tx.IsZerocoinSpend() || tx.IsSigmaSpend() || tx.IsLelantusJoinSplit())
         handleZerocoinSpend(tx.vout.begin(), tx.vout.end(), tx.GetHash(), height, txNumber, view, addressIndex, tx);
 
@@ -693,6 +873,8 @@ void CDbIndexHelper::DisconnectTransactionOutputs(CTransaction const & tx, int h
         handleOutput(out, no++, tx.GetHash(), height, txNumber, view, txIsCoinBase, addressIndex, addressUnspentIndex, spentIndex);
     }
 
+    updateAddressBalances(tx.GetHash(), pAddressBegin, pUnspentBegin, false);
+
     if(addressIndex)
     {
         std::reverse(addressIndex->begin(), addressIndex->end());
@@ -703,12 +885,42 @@ void CDbIndexHelper::DisconnectTransactionOutputs(CTransaction const & tx, int h
         std::reverse(spentIndex->begin(), spentIndex->end());
 }
 
+void CDbIndexHelper::updateAddressBalances(uint256 const & txHash, size_t addressBegin, size_t unspentBegin, bool connect)
+{
+    if(!addressIndex)
+        return;
+
+    int const sign = connect ? 1 : -1;
+
+    for(AddressIndex::const_iterator iter = addressIndex->begin() + addressBegin; iter != addressIndex->end(); ++iter) {
+        CAddressBalanceKey key(iter->first.type, iter->first.hashBytes);
+        CAddressBalanceValue & value = (*addressBalanceIndex)[key];
+        value.balance += sign * iter->second;
+        if(iter->second > 0)
+            value.received += sign * iter->second;
+        if(balanceTxs.insert(std::make_pair(txHash, key)).second)
+            value.txCount += sign;
+    }
+
+    // spent outputs come as null values, connecting removes them from the unspent set and disconnecting brings them back
+    for(AddressUnspentIndex::const_iterator iter = addressUnspentIndex->begin() + unspentBegin; iter != addressUnspentIndex->end(); ++iter) {
+        CAddressBalanceKey key(iter->first.type, iter->first.hashBytes);
+        (*addressBalanceIndex)[key].unspentCount += iter->second.IsNull() ? -sign : sign;
+    }
+}
+
 CDbIndexHelper::AddressIndex const & CDbIndexHelper::getAddressIndex() const
 {
     return *addressIndex;
 }
 
 
+CDbIndexHelper::AddressBalanceIndex const & CDbIndexHelper::getAddressBalanceIndex() const
+{
+    return *addressBalanceIndex;
+}
+
+
 CDbIndexHelper::AddressUnspentIndex const & CDbIndexHelper::getAddressUnspentIndex() const
 {
     return *addressUnspentIndex;
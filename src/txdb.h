@@ -11,7 +11,9 @@
 #include "chain.h"
 #include "spentindex.h"
 
+#include <functional>
 #include <map>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -135,12 +137,24 @@ public:
     bool ReadAddressIndex(uint160 addressHash, AddressType type,
                           std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                           int start = 0, int end = 0);
+    //! Passes the entries of the address from the start key on to handle until it returns false or the entries
+    //! above the end height are reached, end 0 goes on to the last entry
+    bool ReadAddressIndex(const CAddressIndexKey &start, int end,
+                          const std::function<bool(const CAddressIndexKey&, CAmount)> &handle);
+    bool ReadAddressUnspentIndex(const CAddressUnspentKey &start,
+                                 const std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> &handle);
+    bool UpdateAddressBalanceIndex(const std::map<CAddressBalanceKey, CAddressBalanceValue> &deltas);
+    bool ReadAddressBalanceIndex(uint160 addressHash, AddressType type, CAddressBalanceValue &value);
+    //! Builds the balance index out of the address index of a database created before the balance index was kept
+    bool BuildAddressBalanceIndex();
 
     bool WriteTimestampIndex(const CTimestampIndexKey &timestampIndex);
     bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &vect);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
     bool LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    //! Sigma and Lelantus mints and spends of the block, the block index only loads their numbers
+    bool ReadBlockCoinData(const uint256& blockHash, CBlockCoinData& coinData);
     int GetBlockIndexVersion();
     int GetBlockIndexVersion(uint256 const & blockHash);
     bool AddTotalSupply(CAmount const & supply);
@@ -168,15 +182,23 @@ public:
     using AddressIndex = std::vector<std::pair<CAddressIndexKey, CAmount> >;
     using AddressUnspentIndex = std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >;
     using SpentIndex = std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >;
+    using AddressBalanceIndex = std::map<CAddressBalanceKey, CAddressBalanceValue>;
 
     AddressIndex const & getAddressIndex() const;
     AddressUnspentIndex const & getAddressUnspentIndex() const;
     SpentIndex const & getSpentIndex() const;
+    //! Changes of the address totals, to be added to the balance index
+    AddressBalanceIndex const & getAddressBalanceIndex() const;
 
 private:
+    void updateAddressBalances(uint256 const & txHash, size_t addressBegin, size_t unspentBegin, bool connect);
+
     boost::optional<AddressIndex> addressIndex;
     boost::optional<AddressUnspentIndex> addressUnspentIndex;
     boost::optional<SpentIndex> spentIndex;
+    boost::optional<AddressBalanceIndex> addressBalanceIndex;
+    //! Addresses already counted for a transaction
+    std::set<std::pair<uint256, CAddressBalanceKey> > balanceTxs;
 };
 
 #endif // BITCOIN_TXDB_H
@@ -109,6 +109,8 @@ bool fTxIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
 bool fAddressIndex = false;
+// Whether the address balances are complete, they are summed from the address index otherwise
+static bool fAddressBalanceIndex = false;
 bool fSpentIndex = false;
 bool fTimestampIndex = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
@@ -757,10 +759,40 @@ static bool IsCurrentForFeeEstimation()
     return true;
 }
 
+bool CTxPoolAcceptChecks::Matches(const CTransaction& tx, const uint256& tipHash, bool isCheckWalletTransaction) const
+{
+    return tx.GetHash() == txHash && tipHash == checkedTipHash && isCheckWalletTransaction == fCheckWalletTransaction;
+}
+
+bool CTxPoolAcceptChecks::HasCheckedTx(const CTransaction& tx, const uint256& tipHash, bool isCheckWalletTransaction) const
+{
+    return fTxChecked && Matches(tx, tipHash, isCheckWalletTransaction);
+}
+
+bool CTxPoolAcceptChecks::HasCheckedInputs(const CTransaction& tx, const uint256& tipHash, bool isCheckWalletTransaction) const
+{
+    return fInputsChecked && HasCheckedTx(tx, tipHash, isCheckWalletTransaction);
+}
+
+void CTxPoolAcceptChecks::SetCheckedTx(const uint256& tipHash, bool isCheckWalletTransaction)
+{
+    if (fTxChecked && (tipHash != checkedTipHash || isCheckWalletTransaction != fCheckWalletTransaction))
+        fInputsChecked = false;
+    checkedTipHash = tipHash;
+    fCheckWalletTransaction = isCheckWalletTransaction;
+    fTxChecked = true;
+}
+
+void CTxPoolAcceptChecks::SetCheckedInputs()
+{
+    assert(fTxChecked);
+    fInputsChecked = true;
+}
+
 bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const CTransactionRef& ptx, bool fLimitFree,
                               bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
                               bool fOverrideMempoolLimit, const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache,
-                              bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial)
+                              bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial, CTxPoolAcceptChecks* pChecks)
 {
     bool fTestNet = Params().GetConsensus().IsTestnet();
     LogPrintf("AcceptToMemoryPoolWorker(), tx.IsSpend()=%s, fTestNet=%s\n", ptx->IsSigmaSpend() || ptx->IsLelantusJoinSplit(), fTestNet);
@@ -900,13 +932,20 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
         }
     }
 
-    if (!CheckTransaction(tx, state, true, hash, false, INT_MAX, isCheckWalletTransaction)) {
-        LogPrintf("CheckTransaction() failed!");
-        return false; // state filled in by CheckTransaction
-    }
+    // the checks below don't depend on the pool, they're skipped if the transaction passed them for another one
+    const uint256 tipHash = chainActive.Tip()->GetBlockHash();
+    if (!pChecks || !pChecks->HasCheckedTx(tx, tipHash, isCheckWalletTransaction)) {
+        if (!CheckTransaction(tx, state, true, hash, false, INT_MAX, isCheckWalletTransaction)) {
+            LogPrintf("CheckTransaction() failed!");
+            return false; // state filled in by CheckTransaction
+        }
+
+        if (!ContextualCheckTransaction(tx, state, Params().GetConsensus(), chainActive.Tip()))
+            return error("%s: ContextualCheckTransaction: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
-    if (!ContextualCheckTransaction(tx, state, Params().GetConsensus(), chainActive.Tip()))
-        return error("%s: ContextualCheckTransaction: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
+        if (pChecks)
+            pChecks->SetCheckedTx(tipHash, isCheckWalletTransaction);
+    }
 
     if (!pool.IsTransactionAllowed(tx, state)) {
         LogPrintf("AcceptToMemoryPool() can't accept transaction because of active mempool spork\n");
@@ -1341,7 +1380,9 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
             PrecomputedTransactionData txdata(tx);
             // don't check inputs for transactions in whitelist
             bool isInWhitelist = consensus.txidWhitelist.count(tx.GetHash()) > 0;
-            if (!CheckInputs(tx, state, view, !isInWhitelist, scriptVerifyFlags, true, txdata)) {
+            // the outputs spent are the same in every pool, so are the results of the script checks
+            bool fInputsChecked = pChecks && pChecks->HasCheckedInputs(tx, tipHash, isCheckWalletTransaction);
+            if (!fInputsChecked && !CheckInputs(tx, state, view, !isInWhitelist, scriptVerifyFlags, true, txdata)) {
                 // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
                 // need to turn both off, and compare against just turning off CLEANSTACK
                 // to see if the failure is specifically due to witness validation.
@@ -1355,6 +1396,8 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
                 */
                 return false;
             }
+            if (pChecks)
+                pChecks->SetCheckedInputs();
 
             // Check again against just the consensus-critical mandatory script
             // verification flags, in case of bugs in the standard flags that cause
@@ -1490,11 +1533,11 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
 bool AcceptToMemoryPoolWithTime(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
                         bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
                         bool fOverrideMempoolLimit, const CAmount nAbsurdFee,
-                        bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial)
+                        bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial, CTxPoolAcceptChecks* pChecks)
 {
     LogPrintf("AcceptToMemoryPool(), transaction: %s\n", tx->GetHash().ToString());
     std::vector<COutPoint> coins_to_uncache;
-    bool res = AcceptToMemoryPoolWorker(pool, state, tx, fLimitFree, pfMissingInputs, nAcceptTime, plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, coins_to_uncache, isCheckWalletTransaction, markFiroSpendTransactionSerial);
+    bool res = AcceptToMemoryPoolWorker(pool, state, tx, fLimitFree, pfMissingInputs, nAcceptTime, plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, coins_to_uncache, isCheckWalletTransaction, markFiroSpendTransactionSerial, pChecks);
     if (!res) {
         BOOST_FOREACH(const COutPoint& hashTx, coins_to_uncache)
             pcoinsTip->Uncache(hashTx);
@@ -1508,17 +1551,21 @@ bool AcceptToMemoryPoolWithTime(CTxMemPool& pool, CValidationState &state, const
 bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
                         bool* pfMissingInputs, std::list<CTransactionRef>* plTxnReplaced,
                         bool fOverrideMempoolLimit, const CAmount nAbsurdFee,
-                        bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial)
+                        bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial, CTxPoolAcceptChecks* pChecks)
 {
-    return AcceptToMemoryPoolWithTime(pool, state, tx, fLimitFree, pfMissingInputs, GetTime(), plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, isCheckWalletTransaction, markFiroSpendTransactionSerial);
+    return AcceptToMemoryPoolWithTime(pool, state, tx, fLimitFree, pfMissingInputs, GetTime(), plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, isCheckWalletTransaction, markFiroSpendTransactionSerial, pChecks);
 }
 
 
 bool AcceptToMemoryPool(CTxPoolAggregate& poolAggregate, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
                         bool* pfMissingInputs, std::list<CTransactionRef>* plTxnReplaced,
                         bool fOverrideMempoolLimit, const CAmount nAbsurdFee, bool isCheckWalletTransaction, bool markFiroSpendTransactionSerial) {
-    bool res = AcceptToMemoryPool(mempool, state, tx, fLimitFree, pfMissingInputs, plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, isCheckWalletTransaction, markFiroSpendTransactionSerial);
-    AcceptToMemoryPool(txpools.getStemTxPool(), state, tx, fLimitFree, pfMissingInputs, plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, isCheckWalletTransaction, false);
+    // the transaction is verified once, the stem pool only does its own policy checks. Its result doesn't count, so it
+    // doesn't overwrite the state the mempool left
+    CTxPoolAcceptChecks checks(*tx);
+    CValidationState stemState;
+    bool res = AcceptToMemoryPool(mempool, state, tx, fLimitFree, pfMissingInputs, plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, isCheckWalletTransaction, markFiroSpendTransactionSerial, &checks);
+    AcceptToMemoryPool(txpools.getStemTxPool(), stemState, tx, fLimitFree, pfMissingInputs, plTxnReplaced, fOverrideMempoolLimit, nAbsurdFee, isCheckWalletTransaction, false, &checks);
     return res;
 }
 
@@ -1629,6 +1676,61 @@ bool GetAddressUnspent(uint160 addressHash, AddressType type,
     return true;
 }
 
+bool GetAddressIndex(const CAddressIndexKey &start, int end,
+                     const std::function<bool(const CAddressIndexKey&, CAmount)> &handle)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pblocktree->ReadAddressIndex(start, end, handle))
+        return error("unable to get txids for address");
+
+    return true;
+}
+
+bool GetAddressUnspent(const CAddressUnspentKey &start,
+                       const std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> &handle)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pblocktree->ReadAddressUnspentIndex(start, handle))
+        return error("unable to get txids for address");
+
+    return true;
+}
+
+bool GetAddressBalance(uint160 addressHash, AddressType type, CAddressBalanceValue &balance)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (fAddressBalanceIndex) {
+        if (!pblocktree->ReadAddressBalanceIndex(addressHash, type, balance))
+            return error("unable to get balance for address");
+        return true;
+    }
+
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
+    if (!GetAddressIndex(addressHash, type, addressIndex) || !GetAddressUnspent(addressHash, type, unspentOutputs))
+        return false;
+
+    balance.SetNull();
+    uint256 lastTxHash;
+    for (const auto& entry : addressIndex) {
+        if (entry.second > 0)
+            balance.received += entry.second;
+        balance.balance += entry.second;
+        if (entry.first.txhash != lastTxHash) {
+            balance.txCount++;
+            lastTxHash = entry.first.txhash;
+        }
+    }
+    balance.unspentCount = unspentOutputs.size();
+    return true;
+}
+
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -2441,6 +2543,11 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
                 error("Failed to write address unspent index");
                 return DISCONNECT_FAILED;
             }
+            if (!pblocktree->UpdateAddressBalanceIndex(dbIndexHelper.getAddressBalanceIndex())) {
+                AbortNode(state, "Failed to write address balance index");
+                error("Failed to write address balance index");
+                return DISCONNECT_FAILED;
+            }
             if (!pblocktree->AddTotalSupply(-(block.vtx[0]->GetValueOut() - nFees))) {
                 AbortNode(state, "Failed to write total supply");
                 error("Failed to write total supply");
@@ -2743,10 +2850,17 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 
     std::set<uint256> txIds;
     bool isMainNet = chainparams.GetConsensus().IsMain();
-    // batch verify Lelantus/Sigma if block is older than a day, that means we are syncing or reindexing
+    // batch verify Lelantus/Sigma if block is older than a day, that means we are syncing or reindexing,
+    // proofs of recent blocks are batch verified per block once all the transactions are checked
     BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
-    batchProofContainer->fCollectProofs = ((GetSystemTimeInSeconds() - pindex->GetBlockTime()) > 86400) && GetBoolArg("-batching", true);
+    bool fBatchBlockProofs = ((GetSystemTimeInSeconds() - pindex->GetBlockTime()) <= 86400) && GetBoolArg("-batching", true);
+    batchProofContainer->fCollectProofs = GetBoolArg("-batching", true);
     batchProofContainer->init();
+    // proofs are only collected while this block is connected, however ConnectBlock returns
+    struct CollectProofsReset {
+        BatchProofContainer* container;
+        ~CollectProofsReset() { container->fCollectProofs = false; }
+    } collectProofsReset{batchProofContainer};
 
     block.sigmaTxInfo = std::make_shared<sigma::CSigmaTxInfo>();
     block.lelantusTxInfo = std::make_shared<lelantus::CLelantusTxInfo>();
@@ -2857,6 +2971,23 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 
     }
 
+    if (fBatchBlockProofs) {
+        int64_t nTimeBatchStart = GetTimeMicros();
+        batchProofContainer->fCollectProofs = false;
+        if (!batchProofContainer->verifyBlock()) {
+            // find the invalid transaction, the batch can only tell that some proof in it is invalid
+            LogPrintf("ConnectBlock(): batch verification of block %s failed, verifying transactions one by one\n", block.GetHash().ToString());
+            for (const auto& tx : block.vtx) {
+                if (!tx->IsSigmaSpend() && !tx->IsLelantusJoinSplit())
+                    continue;
+                if (!CheckTransaction(*tx, state, false, tx->GetHash(), false, pindex->nHeight, false, true, nullptr, nullptr))
+                    return state.DoS(100, error("ConnectBlock(): proof verification of %s failed", tx->GetHash().ToString()),
+                                     REJECT_INVALID, "bad-txns-zerocoin");
+            }
+        }
+        LogPrint("bench", "      - Verify block proofs: %.2fms\n", 0.001 * (GetTimeMicros() - nTimeBatchStart));
+    }
+
     block.sigmaTxInfo->Complete();
     block.lelantusTxInfo->Complete();
 
@@ -2947,6 +3078,10 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         !lelantus::ConnectBlockLelantus(state, chainparams, pindex, &block, fJustCheck))
         return false;
 
+    // the mints and spends put into the index are kept in memory until it's written
+    if (pindex->IsCoinDataModified())
+        setDirtyBlockIndex.insert(pindex);
+
     if (!sporkManager->IsBlockAllowed(block, pindex, state))
         return false;
 
@@ -2985,6 +3120,9 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         if (!pblocktree->UpdateAddressUnspentIndex(dbIndexHelper.getAddressUnspentIndex()))
             return AbortNode(state, "Failed to write address unspent index");
 
+        if (!pblocktree->UpdateAddressBalanceIndex(dbIndexHelper.getAddressBalanceIndex()))
+            return AbortNode(state, "Failed to write address balance index");
+
         if (!pblocktree->AddTotalSupply(block.vtx[0]->GetValueOut() - nFees))
             return AbortNode(state, "Failed to write total supply");
     }
@@ -3172,14 +3310,20 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
                 setDirtyFileInfo.erase(it++);
             }
             std::vector<const CBlockIndex*> vBlocks;
+            std::vector<CBlockIndex*> vModifiedCoinData;
             vBlocks.reserve(setDirtyBlockIndex.size());
             for (std::set<CBlockIndex*>::iterator it = setDirtyBlockIndex.begin(); it != setDirtyBlockIndex.end(); ) {
                 vBlocks.push_back(*it);
+                if ((*it)->IsCoinDataModified())
+                    vModifiedCoinData.push_back(*it);
                 setDirtyBlockIndex.erase(it++);
             }
             if (!pblocktree->WriteBatchSync(vFiles, nLastBlockFile, vBlocks)) {
                 return AbortNode(state, "Failed to write to block index database");
             }
+            // the mints and spends are in the database now and can be read back when needed
+            for (CBlockIndex* pindex : vModifiedCoinData)
+                pindex->ReleaseCoinData();
         }
         // Finally remove any pruned files
         if (fFlushForPrune)
@@ -3404,22 +3548,24 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
             // ignore validation errors in resurrected transactions
             CValidationState stateDummy;
             CValidationState dandelionStateDummy;
+            CTxPoolAcceptChecks checks(tx);
             // Changes to mempool should also be made to Dandelion stempool.
             if (!tx.IsCoinBase()) {
                 AcceptToMemoryPool(
                     txpools.getStemTxPool(),
                     dandelionStateDummy,
-                    MakeTransactionRef(tx),
+                    it,
                     false, /* fLimitFree */
                     NULL, /* pfMissingInputs */
                     NULL,
                     false, /* fOverrideMempoolLimit */
                     0, /* nAbsurdFee */
                     false, /* isCheckWalletTransaction */
-                    false /* markFiroSpendTransactionSerial */
+                    false, /* markFiroSpendTransactionSerial */
+                    &checks
                 );
             }
-            if (tx.IsCoinBase() || !AcceptToMemoryPool(mempool, stateDummy, MakeTransactionRef(tx), false, NULL)) {
+            if (tx.IsCoinBase() || !AcceptToMemoryPool(mempool, stateDummy, it, false, NULL, NULL, false, 0, false, true, &checks)) {
                 txpools.removeRecursive(tx);
             } else if (mempool.exists(tx.GetHash())) {
                 vHashUpdate.push_back(tx.GetHash());
@@ -5207,6 +5353,16 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     pblocktree->ReadFlag("addressindex", fAddressIndex);
     LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
 
+    // Databases created before the address balances were kept get them built once
+    pblocktree->ReadFlag("addressbalanceindex", fAddressBalanceIndex);
+    if (fAddressIndex && !fAddressBalanceIndex && !fReindex) {
+        LogPrintf("%s: building address balance index...\n", __func__);
+        if (!pblocktree->BuildAddressBalanceIndex())
+            return error("%s: failed to build address balance index", __func__);
+        fAddressBalanceIndex = true;
+        pblocktree->WriteFlag("addressbalanceindex", fAddressBalanceIndex);
+    }
+
     // Check whether we have a timestamp index
     pblocktree->ReadFlag("timestampindex", fTimestampIndex);
     LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
@@ -5458,6 +5614,7 @@ void UnloadBlockIndex()
         delete entry.second;
     }
     mapBlockIndex.clear();
+    CBlockIndex::ClearCoinDataCache();
     fHavePruned = false;
 }
 
@@ -5488,6 +5645,8 @@ bool InitBlockIndex(const CChainParams& chainparams)
     // Use the provided setting for -addressindex in the new database
     fAddressIndex = GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
     pblocktree->WriteFlag("addressindex", fAddressIndex);
+    fAddressBalanceIndex = fAddressIndex;
+    pblocktree->WriteFlag("addressbalanceindex", fAddressBalanceIndex);
 
     fSpentIndex = GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
     pblocktree->WriteFlag("spentindex", fSpentIndex);
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <functional>
 #include <map>
 #include <set>
 #include <stdint.h>
@@ -195,6 +196,7 @@ extern std::atomic_bool fImporting;
 extern bool fReindex;
 extern int nScriptCheckThreads;
 extern bool fTxIndex;
+extern bool fAddressIndex;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
@@ -358,16 +360,47 @@ void PruneAndFlush();
 /** Prune block files up to a given height */
 void PruneBlockFilesManual(int nPruneUpToHeight);
 
+/**
+ * Checks AcceptToMemoryPool has done on a transaction which don't depend on the pool it's added to: CheckTransaction
+ * with the Sigma and Lelantus proofs, ContextualCheckTransaction and the input scripts. Relayed transactions go to both
+ * the mempool and the Dandelion stem pool; passing the same object to both calls has the second one skip what the
+ * first already verified. The pool specific checks (conflicts, available inputs, fees, limits) are always done.
+ */
+class CTxPoolAcceptChecks
+{
+public:
+    explicit CTxPoolAcceptChecks(const CTransaction& tx) : txHash(tx.GetHash()) {}
+
+    //! Whether the checks were passed by this transaction at this tip
+    bool HasCheckedTx(const CTransaction& tx, const uint256& tipHash, bool isCheckWalletTransaction) const;
+    bool HasCheckedInputs(const CTransaction& tx, const uint256& tipHash, bool isCheckWalletTransaction) const;
+
+    void SetCheckedTx(const uint256& tipHash, bool isCheckWalletTransaction);
+    void SetCheckedInputs();
+
+private:
+    bool Matches(const CTransaction& tx, const uint256& tipHash, bool isCheckWalletTransaction) const;
+
+    uint256 txHash;
+    uint256 checkedTipHash;
+    bool fCheckWalletTransaction = false;
+    bool fTxChecked = false;
+    bool fInputsChecked = false;
+};
+
 /** (try to) add transaction to memory pool
- * plTxnReplaced will be appended to with all transactions replaced from mempool **/
+ * plTxnReplaced will be appended to with all transactions replaced from mempool
+ * pChecks, if given, is used to skip the checks already done for another pool and records the ones done here **/
 bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
                         bool* pfMissingInputs, std::list<CTransactionRef>* plTxnReplaced = NULL,
-                        bool fOverrideMempoolLimit=false, const CAmount nAbsurdFee=0, bool isCheckWalletTransaction=false, bool markFiroSpendTransactionSerial=true);
+                        bool fOverrideMempoolLimit=false, const CAmount nAbsurdFee=0, bool isCheckWalletTransaction=false, bool markFiroSpendTransactionSerial=true,
+                        CTxPoolAcceptChecks* pChecks = NULL);
 
 /** (try to) add transaction to memory pool with a specified acceptance time **/
 bool AcceptToMemoryPoolWithTime(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
                         bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced = NULL,
-                        bool fOverrideMempoolLimit=false, const CAmount nAbsurdFee=0, bool isCheckWalletTransaction=false, bool markFiroSpendTransactionSerial=true);
+                        bool fOverrideMempoolLimit=false, const CAmount nAbsurdFee=0, bool isCheckWalletTransaction=false, bool markFiroSpendTransactionSerial=true,
+                        CTxPoolAcceptChecks* pChecks = NULL);
 
 /** (try to) add transaction to memory pool and stem pool **/
 bool AcceptToMemoryPool(CTxPoolAggregate& poolAggregate, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
@@ -531,6 +564,12 @@ bool GetAddressIndex(uint160 addressHash, AddressType type,
                      int start = 0, int end = 0);
 bool GetAddressUnspent(uint160 addressHash, AddressType type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
+bool GetAddressBalance(uint160 addressHash, AddressType type, CAddressBalanceValue &balance);
+/** Pass the address index entries from the start key on to handle, see CBlockTreeDB::ReadAddressIndex */
+bool GetAddressIndex(const CAddressIndexKey &start, int end,
+                     const std::function<bool(const CAddressIndexKey&, CAmount)> &handle);
+bool GetAddressUnspent(const CAddressUnspentKey &start,
+                       const std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> &handle);
 
 /** Functions for disk access for blocks */
 bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
@@ -191,6 +191,12 @@ public:
             mi++;
         }
     }
+    //! Number of the keys, plain or encrypted, without copying them
+    size_t GetKeyCount() const
+    {
+        LOCK(cs_KeyStore);
+        return mapKeys.size() + mapCryptedKeys.size();
+    }
     
     /**
      * Wallet status (encrypted, locked) changed.
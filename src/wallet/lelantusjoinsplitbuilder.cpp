@@ -475,7 +475,7 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
         coins.emplace_back(std::make_pair(priv, groupId));
         std::vector<unsigned char> setHash;
         if (anonymity_sets.count(groupId) == 0) {
-            std::vector<lelantus::PublicCoin> set;
+            lelantus::CLelantusState::AnonymitySetRef set;
             uint256 blockHash;
             if (state->GetCoinSetForSpend(
                     &chainActive,
@@ -487,7 +487,7 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
                 throw std::runtime_error(
                         _("Has to have at least two mint coins with at least 1 confirmation in order to spend a coin"));
             groupBlockHashes[groupId] = blockHash;
-            anonymity_sets[groupId] = set;
+            anonymity_sets[groupId] = *set;
             if (!setHash.empty())
                 anonymity_set_hashes.push_back(setHash);
         }
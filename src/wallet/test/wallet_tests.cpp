@@ -430,6 +430,42 @@ BOOST_FIXTURE_TEST_CASE(rescan, TestChain100Setup)
     }
 }
 
+BOOST_AUTO_TEST_CASE(scan_filter)
+{
+    CKey key, otherKey;
+    key.MakeNewKey(true);
+    otherKey.MakeNewKey(true);
+
+    CWalletScanFilter filter;
+    filter.keys.insert(key.GetPubKey().GetID());
+
+    CMutableTransaction tx;
+    tx.vout.resize(1);
+    tx.vout[0].nValue = COIN;
+
+    tx.vout[0].scriptPubKey = GetScriptForDestination(otherKey.GetPubKey().GetID());
+    BOOST_CHECK(!filter.MayBeMine(tx));
+
+    tx.vout[0].scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+    BOOST_CHECK(filter.MayBeMine(tx));
+    tx.vout[0].scriptPubKey = GetScriptForRawPubKey(key.GetPubKey());
+    BOOST_CHECK(filter.MayBeMine(tx));
+    // partially owned multisigs are let through, IsMine() makes the decision
+    tx.vout[0].scriptPubKey = GetScriptForMultisig(1, {otherKey.GetPubKey(), key.GetPubKey()});
+    BOOST_CHECK(filter.MayBeMine(tx));
+
+    CScript redeemScript = GetScriptForMultisig(1, {otherKey.GetPubKey()});
+    tx.vout[0].scriptPubKey = GetScriptForDestination(CScriptID(redeemScript));
+    BOOST_CHECK(!filter.MayBeMine(tx));
+    filter.scripts.insert(CScriptID(redeemScript));
+    BOOST_CHECK(filter.MayBeMine(tx));
+
+    tx.vout[0].scriptPubKey = CScript() << OP_RETURN;
+    BOOST_CHECK(!filter.MayBeMine(tx));
+    filter.watchOnly.insert(tx.vout[0].scriptPubKey);
+    BOOST_CHECK(filter.MayBeMine(tx));
+}
+
 // Verify importwallet RPC starts rescan at earliest block with timestamp
 // greater or equal than key birthday. Previously there was a bug where
 // importwallet RPC would start the scan at the latest block with timestamp less
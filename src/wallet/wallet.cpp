@@ -49,11 +49,14 @@
 
 #include "evo/deterministicmns.h"
 
+#include "liblelantus/threadpool.h"
+
 #include <assert.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/thread.hpp>
+#include <deque>
 #include <vector>
 
 #include "bip47/account.h"
@@ -2143,11 +2146,159 @@ void CWalletTx::GetAmounts(std::list<COutputEntry>& listReceived,
 
 }
 
+bool CWalletScanFilter::MayBeMine(const CTransaction& tx) const
+{
+    // private spends and mints are looked up in the wallet database
+    if (tx.IsSigmaSpend() || tx.IsLelantusJoinSplit())
+        return true;
+
+    for (const CTxOut& txout : tx.vout) {
+        const CScript& script = txout.scriptPubKey;
+        if (script.IsSigmaMint() || script.IsLelantusMint() || script.IsLelantusJMint())
+            return true;
+        if (watchOnly.count(script))
+            return true;
+
+        // any of the keys and scripts ::IsMine() looks up
+        std::vector<std::vector<unsigned char>> vSolutions;
+        txnouttype whichType;
+        if (!Solver(script, whichType, vSolutions))
+            continue;
+
+        switch (whichType) {
+        case TX_ZEROCOINMINT:
+        case TX_ZEROCOINMINTV3:
+        case TX_LELANTUSMINT:
+        case TX_LELANTUSJMINT:
+        case TX_PUBKEY:
+            if (keys.count(CPubKey(vSolutions[0]).GetID()))
+                return true;
+            break;
+        case TX_PUBKEYHASH:
+            if (keys.count(CKeyID(uint160(vSolutions[0]))))
+                return true;
+            break;
+        case TX_SCRIPTHASH:
+            if (scripts.count(CScriptID(uint160(vSolutions[0]))))
+                return true;
+            break;
+        case TX_WITNESS_V0_KEYHASH:
+        case TX_WITNESS_V0_SCRIPTHASH:
+            if (scripts.count(CScriptID(CScript() << OP_0 << vSolutions[0])))
+                return true;
+            break;
+        case TX_MULTISIG:
+            for (size_t i = 1; i + 1 < vSolutions.size(); i++) {
+                if (keys.count(CPubKey(vSolutions[i]).GetID()))
+                    return true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return false;
+}
+
+std::shared_ptr<const CWalletScanFilter> CWallet::GetScanFilter() const
+{
+    auto filter = std::make_shared<CWalletScanFilter>();
+
+    LOCK(cs_KeyStore);
+    GetKeys(filter->keys);
+    for (const auto& script : mapScripts)
+        filter->scripts.insert(script.first);
+    filter->watchOnly = setWatchOnly;
+    filter->nKeyStoreSize = GetKeyStoreSize();
+    return filter;
+}
+
+size_t CWallet::GetKeyStoreSize() const
+{
+    LOCK(cs_KeyStore);
+    return GetKeyCount() + mapScripts.size() + setWatchOnly.size();
+}
+
+namespace {
+
+// Block of a rescan, read and matched against the wallet's keys on the thread pool
+struct CScanBlock
+{
+    CBlockIndex* pindex;
+    CDiskBlockPos pos;
+    CBlock block;
+    bool fRead = false;
+    std::shared_ptr<const CWalletScanFilter> filter;
+    std::vector<bool> vMayBeMine;
+};
+
+struct CScanBatch
+{
+    std::vector<std::shared_ptr<CScanBlock>> blocks;
+    std::vector<std::future<void>> tasks;
+};
+
+void MatchScanBlock(CScanBlock& scanBlock, const std::shared_ptr<const CWalletScanFilter>& filter)
+{
+    scanBlock.filter = filter;
+    scanBlock.vMayBeMine.resize(scanBlock.block.vtx.size());
+    for (size_t i = 0; i < scanBlock.block.vtx.size(); i++)
+        scanBlock.vMayBeMine[i] = filter->MayBeMine(*scanBlock.block.vtx[i]);
+}
+
+// Next block of the active chain, the scan goes on from the fork point if pindex was reorganized away
+CBlockIndex* NextScanBlock(CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    const CBlockIndex* pindexFork = chainActive.Contains(pindex) ? pindex : chainActive.FindFork(pindex);
+    return pindexFork ? chainActive.Next(pindexFork) : chainActive.Genesis();
+}
+
+// Posts reading of the batch of blocks starting at pindex to the thread pool, returns the last block of the batch
+CBlockIndex* QueueScanBatch(CBlockIndex* pindex, const std::shared_ptr<const CWalletScanFilter>& filter, CScanBatch& batch)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
+
+    LOCK(cs_main);
+    CBlockIndex* pindexLast = nullptr;
+    for (int i = 0; i < WALLET_RESCAN_BATCH_SIZE && pindex; i++) {
+        auto scanBlock = std::make_shared<CScanBlock>();
+        scanBlock->pindex = pindex;
+        // block positions are taken under cs_main, the blocks themselves are read without it
+        scanBlock->pos = pindex->GetBlockPos();
+        batch.blocks.push_back(scanBlock);
+        batch.tasks.emplace_back(threadPool.PostTask<void>("wallet_rescan", [scanBlock, filter, &consensusParams]() {
+            CBlock& block = scanBlock->block;
+            if (!ReadBlockFromDisk(block, scanBlock->pos, scanBlock->pindex->nHeight, consensusParams))
+                return;
+            if (block.GetHash() != scanBlock->pindex->GetBlockHash()) {
+                error("%s: GetHash() doesn't match index for %s at %s", __func__, scanBlock->pindex->ToString(), scanBlock->pos.ToString());
+                return;
+            }
+            scanBlock->fRead = true;
+            MatchScanBlock(*scanBlock, filter);
+        }));
+
+        pindexLast = pindex;
+        pindex = chainActive.Next(pindex);
+    }
+    return pindexLast;
+}
+
+}
+
 /**
  * Scan the block chain (starting in pindexStart) for transactions
  * from or to us. If fUpdate is true, found transactions that already
  * exist in the wallet will be updated.
  *
+ * Blocks are read and matched against a snapshot of the wallet's keys on
+ * the thread pool while the batch before them is committed, cs_main and
+ * cs_wallet are only held to commit a batch. The last scanned block is
+ * recorded every minute, an interrupted rescan is resumed on the next start.
+ *
  * Returns pointer to the first block in the last contiguous range that was
  * successfully scanned.
  *
@@ -2157,8 +2308,10 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex *pindexStart, bool f
     CBlockIndex* ret = nullptr;
     int64_t nNow = GetTime();
     const CChainParams& chainParams = Params();
+    ParallelOpThreadPool& threadPool = ParallelOpThreadPool::GetInstance();
 
     CBlockIndex* pindex = pindexStart;
+    double dProgressStart, dProgressTip;
     {
         LOCK2(cs_main, cs_wallet);
 
@@ -2166,43 +2319,103 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex *pindexStart, bool f
         // our wallet birthday (as adjusted for block time variability)
         // if you are recovering wallet with mnemonics start rescan from block when mnemonics implemented in Firo
         if (fRecoverMnemonic) {
-            pindex = chainActive[chainParams.GetConsensus().nMnemonicBlock];
-            if (pindex == NULL)
-                pindex = chainActive.Tip();
+            CBlockIndex* pindexMnemonic = chainActive[chainParams.GetConsensus().nMnemonicBlock];
+            if (pindexMnemonic == NULL)
+                pindexMnemonic = chainActive.Tip();
+            // a resumed recovery goes on from where it stopped
+            if (pindex == NULL || pindex->nHeight < pindexMnemonic->nHeight)
+                pindex = pindexMnemonic;
         } else
             while (pindex && nTimeFirstKey && (pindex->GetBlockTime() < (nTimeFirstKey - 7200)))
                 pindex = chainActive.Next(pindex);
 
         ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
-        double dProgressStart = GuessVerificationProgress(chainParams.TxData(), pindex);
-        double dProgressTip = GuessVerificationProgress(chainParams.TxData(), chainActive.Tip());
-        while (pindex)
-        {
-            // A temporary fix for inability to Ctrl-C rescan when restoring a wallet (will be fixed in 0.15.)
-            if (ShutdownRequested())
-                return nullptr;
-            if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
-                ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
-            if (GetTime() >= nNow + 60) {
-                nNow = GetTime();
-                LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
+        dProgressStart = GuessVerificationProgress(chainParams.TxData(), pindex);
+        dProgressTip = GuessVerificationProgress(chainParams.TxData(), chainActive.Tip());
+    }
+
+    std::shared_ptr<const CWalletScanFilter> filter = GetScanFilter();
+    // two batches are in flight, the next one is read while the current one is committed
+    std::deque<CScanBatch> batches;
+    CBlockIndex* pindexQueued = nullptr;
+    CBlockIndex* pindexScanned = nullptr;
+    while (true) {
+        while (pindex && batches.size() < 2) {
+            batches.emplace_back();
+            pindexQueued = QueueScanBatch(pindex, filter, batches.back());
+            LOCK(cs_main);
+            pindex = NextScanBlock(pindexQueued);
+        }
+        if (batches.empty())
+            break;
+
+        CScanBatch batch = std::move(batches.front());
+        batches.pop_front();
+        for (auto& task : batch.tasks) {
+            threadPool.Wait(task);
+            task.get();
+        }
+
+        LOCK2(cs_main, cs_wallet);
+
+        // A temporary fix for inability to Ctrl-C rescan when restoring a wallet (will be fixed in 0.15.)
+        if (ShutdownRequested()) {
+            if (pindexScanned && fFileBacked)
+                CWalletDB(strWalletFile).WriteRescanProgress(chainActive.GetLocator(pindexScanned), fRecoverMnemonic);
+            return nullptr;
+        }
+
+        for (const auto& scanBlock : batch.blocks) {
+            if (!chainActive.Contains(scanBlock->pindex)) {
+                // the chain was reorganized meanwhile, blocks read ahead are dropped and the scan goes on from the fork
+                batches.clear();
+                pindex = NextScanBlock(scanBlock->pindex);
+                break;
             }
 
-            CBlock block;
-            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    AddToWalletIfInvolvingMe(*block.vtx[posInBlock], pindex, posInBlock, fUpdate);
-                }
-                if (!ret) {
-                    ret = pindex;
-                }
-            } else {
+            if (scanBlock->pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
+                ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), scanBlock->pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
+            pindexScanned = scanBlock->pindex;
+
+            if (!scanBlock->fRead) {
                 ret = nullptr;
+                continue;
+            }
+
+            const CBlock& block = scanBlock->block;
+            for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
+                // keys added while rescanning, by topping up the keypool for one, are matched against too
+                if (scanBlock->filter->nKeyStoreSize != GetKeyStoreSize()) {
+                    if (filter->nKeyStoreSize != GetKeyStoreSize())
+                        filter = GetScanFilter();
+                    MatchScanBlock(*scanBlock, filter);
+                }
+
+                const CTransaction& tx = *block.vtx[posInBlock];
+                bool fInvolvesMe = scanBlock->vMayBeMine[posInBlock] || mapWallet.count(tx.GetHash());
+                // spends of the wallet's outputs and the conflicting ones
+                for (size_t i = 0; i < tx.vin.size() && !fInvolvesMe; i++)
+                    fInvolvesMe = mapWallet.count(tx.vin[i].prevout.hash) || mapTxSpends.count(tx.vin[i].prevout);
+
+                if (fInvolvesMe)
+                    AddToWalletIfInvolvingMe(tx, scanBlock->pindex, posInBlock, fUpdate);
+            }
+            if (!ret) {
+                ret = scanBlock->pindex;
             }
-            pindex = chainActive.Next(pindex);
         }
-        ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
+
+        if (GetTime() >= nNow + 60 && pindexScanned) {
+            nNow = GetTime();
+            LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindexScanned->nHeight, GuessVerificationProgress(chainParams.TxData(), pindexScanned));
+            if (fFileBacked)
+                CWalletDB(strWalletFile).WriteRescanProgress(chainActive.GetLocator(pindexScanned), fRecoverMnemonic);
+        }
     }
+
+    if (fFileBacked)
+        CWalletDB(strWalletFile).EraseRescanProgress();
+    ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
     return ret;
 }
 
@@ -3036,7 +3249,7 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
 
         // Check group size
         uint256 hashOut;
-        std::vector<lelantus::PublicCoin> coinOuts;
+        lelantus::CLelantusState::AnonymitySetRef coinOuts;
         std::vector<unsigned char> setHash;
         state->GetCoinSetForSpend(
             &chainActive,
@@ -3047,7 +3260,7 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
             setHash
         );
 
-        if (!includeUnsafe && coinOuts.size() < 2) {
+        if (!includeUnsafe && coinOuts->size() < 2) {
             return true;
         }
 
@@ -6528,7 +6741,7 @@ std::string CWallet::GetWalletHelpString(bool showDebug)
     strUsage += HelpMessageOpt("-mnemonic=<text>", _("User defined mnemonic for HD wallet (bip39). Only has effect during wallet creation/first start (default: randomly generated)"));
     strUsage += HelpMessageOpt("-mnemonicpassphrase=<text>", _("User defined mnemonic passphrase for HD wallet (BIP39). Only has effect during wallet creation/first start (default: empty string)"));
     strUsage += HelpMessageOpt("-hdseed=<hex>", _("User defined seed for HD wallet (should be in hex). Only has effect during wallet creation/first start (default: randomly generated)"));
-    strUsage += HelpMessageOpt("-batching", _("In case of sync/reindex verifies sigma/lelantus proofs with batch verification, default: true"));
+    strUsage += HelpMessageOpt("-batching", _("Verifies sigma/lelantus proofs with batch verification, deferred in case of sync/reindex and per block otherwise, default: true"));
     strUsage += HelpMessageOpt("-walletrbf", strprintf(_("Send transactions with full-RBF opt-in enabled (default: %u)"), DEFAULT_WALLET_RBF));
     strUsage += HelpMessageOpt("-upgradewallet", _("Upgrade wallet to latest format on startup"));
     strUsage += HelpMessageOpt("-wallet=<file>", _("Specify wallet file (within data directory)") + " " + strprintf(_("(default: %s)"), DEFAULT_WALLET_DAT));
@@ -6716,6 +6929,21 @@ CWallet* CWallet::CreateWalletFromFile(const std::string walletFile)
         else
             pindexRescan = chainActive.Genesis();
     }
+    {
+        // the wallet's best block is moved on by the blocks connected during a rescan, so an interrupted one is
+        // resumed from where it stopped
+        CWalletDB walletdb(walletFile);
+        CBlockLocator locator;
+        bool fRescanRecoverMnemonic;
+        if (walletdb.ReadRescanProgress(locator, fRescanRecoverMnemonic)) {
+            CBlockIndex *pindexResume = FindForkInGlobalIndex(chainActive, locator);
+            if (pindexResume && (!pindexRescan || pindexResume->nHeight < pindexRescan->nHeight)) {
+                LogPrintf("Resuming interrupted rescan from block %i\n", pindexResume->nHeight);
+                pindexRescan = pindexResume;
+                fRecoverMnemonic |= fRescanRecoverMnemonic;
+            }
+        }
+    }
     if (chainActive.Tip() && chainActive.Tip() != pindexRescan)
     {
         //We can't rescan beyond non-pruned blocks, stop and throw an error
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <atomic>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <stdint.h>
@@ -57,6 +58,8 @@ extern bool fSendFreeTransactions;
 extern bool fWalletRbf;
 
 static const unsigned int DEFAULT_KEYPOOL_SIZE = 100;
+//! Number of blocks a rescan reads ahead and commits to the wallet at once
+static const int WALLET_RESCAN_BATCH_SIZE = 100;
 //! -paytxfee default
 static const CAmount DEFAULT_TRANSACTION_FEE = 0;
 //! -fallbackfee default
@@ -641,6 +644,23 @@ private:
 
 class LelantusJoinSplitBuilder;
 
+/**
+ * Snapshot of the wallet's keys and scripts a rescan matches transactions against without locking the wallet. It
+ * finds all the transactions IsMine() would, and maybe some more, and leaves the inputs spending the wallet's
+ * transparent outputs to be matched against the wallet itself.
+ */
+class CWalletScanFilter
+{
+public:
+    std::set<CKeyID> keys;
+    std::set<CScriptID> scripts;
+    std::set<CScript> watchOnly;
+    //! Size of the key store when the snapshot was taken, it only grows while rescanning
+    size_t nKeyStoreSize = 0;
+
+    bool MayBeMine(const CTransaction& tx) const;
+};
+
 /**
  * A CWallet is an extension of a keystore, which also maintains a set of transactions and balances,
  * and provides the ability to create new transactions.
@@ -689,6 +709,10 @@ private:
     /* Mark a transaction (and its in-wallet descendants) as conflicting with a particular block. */
     void MarkConflicted(const uint256& hashBlock, const uint256& hashTx);
 
+    /* Snapshot of the keys and scripts a rescan matches transactions against */
+    std::shared_ptr<const CWalletScanFilter> GetScanFilter() const;
+    size_t GetKeyStoreSize() const;
+
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>);
 
     /* the HD chain data model (external chain counters) */
@@ -159,6 +159,28 @@ bool CWalletDB::ReadBestBlock(CBlockLocator& locator)
     return Read(std::string("bestblock_nomerkle"), locator);
 }
 
+bool CWalletDB::WriteRescanProgress(const CBlockLocator& locator, bool fRecoverMnemonic)
+{
+    nWalletDBUpdateCounter++;
+    return Write(std::string("rescanprogress"), std::make_pair(locator, fRecoverMnemonic));
+}
+
+bool CWalletDB::ReadRescanProgress(CBlockLocator& locator, bool& fRecoverMnemonic)
+{
+    std::pair<CBlockLocator, bool> progress;
+    if (!Read(std::string("rescanprogress"), progress))
+        return false;
+    locator = progress.first;
+    fRecoverMnemonic = progress.second;
+    return true;
+}
+
+bool CWalletDB::EraseRescanProgress()
+{
+    nWalletDBUpdateCounter++;
+    return Erase(std::string("rescanprogress"));
+}
+
 bool CWalletDB::WriteOrderPosNext(int64_t nOrderPosNext)
 {
     nWalletDBUpdateCounter++;
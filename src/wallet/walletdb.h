@@ -217,6 +217,11 @@ public:
     bool WriteBestBlock(const CBlockLocator& locator);
     bool ReadBestBlock(CBlockLocator& locator);
 
+    //! Last block scanned by an unfinished rescan, the next start resumes the rescan from it
+    bool WriteRescanProgress(const CBlockLocator& locator, bool fRecoverMnemonic);
+    bool ReadRescanProgress(CBlockLocator& locator, bool& fRecoverMnemonic);
+    bool EraseRescanProgress();
+
     bool WriteOrderPosNext(int64_t nOrderPosNext);
 
     bool WriteDefaultKey(const CPubKey& vchPubKey);